@@ -611,6 +611,33 @@ void ErrorManager::GenWorkStreamIdBySessionGraph(uint64_t session_id, uint64_t g
   ClearWarningMsgContainerByWorkId(work_stream_id);
 }
 
+void ErrorManager::MoveMessagesToCurrentWorkStream(uint64_t work_stream_id) {
+  if (work_stream_id == error_context_.work_stream_id) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto err_iter = error_message_per_work_id_.find(work_stream_id);
+  if (err_iter != error_message_per_work_id_.end()) {
+    auto& error_messages = GetErrorMsgContainerByWorkId(error_context_.work_stream_id);
+    for (auto &item : err_iter->second) {
+      if (find(error_messages.begin(), error_messages.end(), item) == error_messages.end()) {
+        error_messages.emplace_back(item);
+      }
+    }
+    ClearErrorMsgContainerByWorkId(work_stream_id);
+  }
+  auto warn_iter = warning_messages_per_work_id_.find(work_stream_id);
+  if (warn_iter != warning_messages_per_work_id_.end()) {
+    auto& warning_messages = GetWarningMsgContainerByWorkId(error_context_.work_stream_id);
+    for (auto &item : warn_iter->second) {
+      if (find(warning_messages.begin(), warning_messages.end(), item) == warning_messages.end()) {
+        warning_messages.emplace_back(item);
+      }
+    }
+    ClearWarningMsgContainerByWorkId(work_stream_id);
+  }
+}
+
 void ErrorManager::ClearErrorMsgContainerByWorkId(uint64_t work_stream_id) {
   auto err_iter = error_message_per_work_id_.find(work_stream_id);
   if (err_iter != error_message_per_work_id_.end()) {
@@ -41,11 +41,33 @@ const size_t kDimSize4d = 4;
 const std::set<string> kChangeDimNodes = {PERMUTE, EXPANDDIMS, SQUEEZE};
 const string kIsGraphInferred = "_is_graph_inferred";
 thread_local RefRelations reflection_builder;
+
+// A node waiting in the worklist is not queued again, the formats set meanwhile are read when it is popped
+void PushNode(std::deque<ge::NodePtr> &nodes, const ge::NodePtr &node, FormatRefineContext &context) {
+  const auto iter = context.node_ids.find(node.get());
+  if (iter != context.node_ids.end()) {
+    if (context.queued[iter->second]) {
+      return;
+    }
+    context.queued[iter->second] = true;
+  }
+  nodes.push_back(node);
+}
+
+ge::NodePtr PopNode(std::deque<ge::NodePtr> &nodes, FormatRefineContext &context) {
+  ge::NodePtr node = nodes.front();
+  nodes.pop_front();
+  const auto iter = context.node_ids.find(node.get());
+  if (iter != context.node_ids.end()) {
+    context.queued[iter->second] = false;
+  }
+  return node;
+}
 }  // namespace
 
 graphStatus ReflectionProcess(const std::unordered_set<RefCell, RefCellHash> &reflection,
                               std::deque<ge::NodePtr> &nodes,
-                              ge::Format to_be_set_format) {
+                              ge::Format to_be_set_format, FormatRefineContext &context) {
   for (const auto &cell : reflection) {
     auto node = cell.node;
     auto in_out_idx = cell.in_out_idx;
@@ -62,7 +84,7 @@ graphStatus ReflectionProcess(const std::unordered_set<RefCell, RefCellHash> &re
       desc.SetFormat(to_be_set_format);
       (void)node->GetOpDesc()->UpdateOutputDesc(static_cast<uint32_t>(in_out_idx), desc);
     }
-    nodes.push_back(cell.node);
+    PushNode(nodes, cell.node, context);
   }
 
   return GRAPH_SUCCESS;
@@ -116,10 +138,9 @@ graphStatus BiasAddFormatFixProcess(ge::NodePtr &node_ptr) {
   return GRAPH_SUCCESS;
 }
 
-graphStatus FormatRefiner::RefreshConstantOutProcess(const ComputeGraphPtr &graph, const OpDescPtr &op_desc) {
-  GE_CHECK_NOTNULL(graph);
+graphStatus FormatRefiner::RefreshConstantOutProcess(const OpDescPtr &op_desc, const FormatRefineContext &context) {
   GE_CHECK_NOTNULL(op_desc);
-  if (op_desc->GetType() == CONSTANTOP && !IsGraphInferred(graph)) {
+  if (op_desc->GetType() == CONSTANTOP && !context.is_graph_inferred) {
     ConstGeTensorPtr tensor_value;
     if (!AttrUtils::GetTensor(op_desc, "value", tensor_value)) {
       REPORT_CALL_ERROR("E19999", "GetTensor failed, node name:%s.", op_desc->GetName().c_str());
@@ -133,16 +154,19 @@ graphStatus FormatRefiner::RefreshConstantOutProcess(const ComputeGraphPtr &grap
 }
 
 graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std::vector<ge::NodePtr> &anchor_points,
-                                           std::vector<ge::NodePtr> &data_nodes,
-                                           std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                           std::vector<ge::NodePtr> &data_nodes, FormatRefineContext &context) {
   if (graph == nullptr) {
     REPORT_INNER_ERROR("E19999", "param graph is nullptr, check invalid");
     GELOGE(GRAPH_FAILED, "[Check][Param] input graph is nullptr");
     return GRAPH_FAILED;
   }
   anchor_points.clear();
+  auto all_nodes = graph->GetAllNodes();
+  context.node_ids.clear();
+  context.node_ids.reserve(all_nodes.size());
+  context.queued.assign(all_nodes.size(), false);
   // Get all anchor point nodes and switch nodes
-  for (auto &node_ptr : graph->GetAllNodes()) {
+  for (auto &node_ptr : all_nodes) {
     if (node_ptr == nullptr) {
       REPORT_INNER_ERROR("E19999", "node ptr in graph(%s) should not be null", graph->GetName().c_str());
       GELOGE(GRAPH_FAILED, "[Check][Param] node ptr in graph(%s) should not be null", graph->GetName().c_str());
@@ -154,7 +178,8 @@ graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std
       GELOGE(GRAPH_FAILED, "[Check][Param] node's opdesc is nullptr，graph:%s", graph->GetName().c_str());
       return GRAPH_FAILED;
     }
-    graphStatus status = RefreshConstantOutProcess(graph, op_desc);
+    (void)context.node_ids.emplace(node_ptr.get(), context.node_ids.size());
+    graphStatus status = RefreshConstantOutProcess(op_desc, context);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "[Call][RefreshConstantOutProcess] failed! graph:%s, op:%s",
              graph->GetName().c_str(), op_desc->GetName().c_str());
@@ -206,35 +231,36 @@ graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std
   GELOGI("anchor_points number is %zu", anchor_points.size());
   return GRAPH_SUCCESS;
 }
-graphStatus FormatRefiner::AnchorProcess(const ge::NodePtr &anchor_node,
-                                         std::unordered_map<ge::NodePtr, bool> &node_status) {
+graphStatus FormatRefiner::AnchorProcess(const ge::NodePtr &anchor_node, FormatRefineContext &context) {
   if (anchor_node == nullptr) {
     REPORT_INNER_ERROR("E19999", "param anchor node is nullptr, check invalid.");
     GELOGE(GRAPH_FAILED, "[Check][Param] anchor node is nullptr!");
     return GRAPH_FAILED;
   }
   std::deque<ge::NodePtr> nodes;
-  nodes.push_back(anchor_node);
+  PushNode(nodes, anchor_node, context);
   while (!nodes.empty()) {
-    ge::NodePtr node = nodes.front();
-    nodes.pop_front();
-    graphStatus status = BackInferProcess(nodes, node, node_status);
+    ge::NodePtr node = PopNode(nodes, context);
+    graphStatus status = BackInferProcess(nodes, node, context);
     if (status != GRAPH_SUCCESS && node != nullptr) {
       GELOGE(status, "[Back][InferProcess] failed! status:%d, node name [%s]",
              status, node->GetName().c_str());
+      context.queued.assign(context.queued.size(), false);
       return status;
     }
-    status = ForwardInferProcess(nodes, node, node_status);
+    status = ForwardInferProcess(nodes, node, context);
     if (status != GRAPH_SUCCESS && node != nullptr) {
       GELOGE(status, "[Forward][InferProcess] failed! status:%d, node name [%s]",
              status, node->GetName().c_str());
+      // the worklist is dropped, nodes left in it must not stay marked as queued
+      context.queued.assign(context.queued.size(), false);
       return status;
     }
   }
   return GRAPH_SUCCESS;
 }
 graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                            std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                            FormatRefineContext &context) {
   GE_CHECK_NOTNULL(node);
   GE_CHECK_NOTNULL(node->GetOpDesc());
 
@@ -255,7 +281,29 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
     }
     auto peer_out_data_node = peer_out_data_anchor->GetOwnerNode();
     int idx = peer_out_data_anchor->GetIdx();
-    // do peer_out_node name and index as key to lookup reflections
+    // Check format whether have been set
+    // op_desc of node should not be null
+    auto peer_out_desc = peer_out_data_node->GetOpDesc()->MutableOutputDesc(static_cast<uint32_t>(idx));
+    if ((peer_out_desc == nullptr) || (peer_out_desc->GetOriginFormat() != FORMAT_ND)) {
+      continue;
+    }
+    auto dim_num = peer_out_desc->GetShape().GetDimNum();
+    if (dim_num == 0) {
+      GELOGD("node name:%s idx:%d out is scalar. stop back infer!", peer_out_data_node->GetName().c_str(), idx);
+      continue;
+    }
+    /// Check whether node to change dims ()
+    /// Because some node will calculate with 5D, C dim maybe multi meaning
+    auto peer_out_data_node_type = peer_out_data_node->GetType();
+    auto iter1 = kChangeDimNodes.find(peer_out_data_node_type);
+    // 4 means dims num
+    if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
+      GELOGD("Node[%s] is change dim node and shape is smaller than 4. do not modify format",
+             (peer_out_data_node->GetName()).c_str());
+      continue;
+    }
+
+    // do peer_out_node name and index as key to lookup reflections, only for the tensors going to be set
     ge::RefCell key(peer_out_data_node->GetName(), peer_out_data_node, ge::NODE_OUT, idx);
     std::unordered_set<RefCell, RefCellHash> reflection;
     auto status = reflection_builder.LookUpRefRelations(key, reflection);
@@ -264,54 +312,33 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
              (peer_out_data_node->GetName()).c_str(), idx);
       return GRAPH_FAILED;
     }
+    if (reflection.empty()) {
+      GeTensorDesc ge_tensor_desc = *peer_out_desc;
+      ge_tensor_desc.SetOriginFormat(to_be_set_format);
+      ge_tensor_desc.SetFormat(to_be_set_format);
+      (void)peer_out_data_node->GetOpDesc()->UpdateOutputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
 
-    // Check format whether have been set
-    // op_desc of node should not be null
-    auto ge_tensor_desc = peer_out_data_node->GetOpDesc()->GetOutputDesc(static_cast<uint32_t>(idx));
-    if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-      auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
-      if (dim_num == 0) {
-        GELOGD("node name:%s idx:%d out is scalar. stop back infer!", peer_out_data_node->GetName().c_str(), idx);
-        continue;
-      }
-      /// Check whether node to change dims ()
-      /// Because some node will calculate with 5D, C dim maybe multi meaning
-      auto peer_out_data_node_type = peer_out_data_node->GetType();
-      auto iter1 = kChangeDimNodes.find(peer_out_data_node_type);
-      // 4 means dims num
-      if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
-        GELOGD("Node[%s] is change dim node and shape is smaller than 4. do not modify format",
+      // Call operator infer format api (forward) to get out format
+      GELOGD("call infer format func[Back]!Node is [%s] ", (peer_out_data_node->GetName()).c_str());
+      status = peer_out_data_node->InferOriginFormat();
+      if (status != GRAPH_SUCCESS) {
+        GELOGE(GRAPH_FAILED, "[Infer][Format] failed, Node:%s",
                (peer_out_data_node->GetName()).c_str());
-        continue;
+        return GRAPH_FAILED;
       }
-
-      if (reflection.empty()) {
-        ge_tensor_desc.SetOriginFormat(to_be_set_format);
-        ge_tensor_desc.SetFormat(to_be_set_format);
-        (void)peer_out_data_node->GetOpDesc()->UpdateOutputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
-
-        // Call operator infer format api (forward) to get out format
-        GELOGD("call infer format func[Back]!Node is [%s] ", (peer_out_data_node->GetName()).c_str());
-        status = peer_out_data_node->InferOriginFormat();
-        if (status != GRAPH_SUCCESS) {
-          GELOGE(GRAPH_FAILED, "[Infer][Format] failed, Node:%s",
-                 (peer_out_data_node->GetName()).c_str());
-          return GRAPH_FAILED;
-        }
-        nodes.push_back(peer_out_data_node);
-      } else {
-        auto status = ReflectionProcess(reflection, nodes, to_be_set_format);
-        if (status != GRAPH_SUCCESS) {
-          GELOGE(GRAPH_FAILED, "[Reflect][Node] failed! status:%d", status);
-          return GRAPH_FAILED;
-        }
+      PushNode(nodes, peer_out_data_node, context);
+    } else {
+      status = ReflectionProcess(reflection, nodes, to_be_set_format, context);
+      if (status != GRAPH_SUCCESS) {
+        GELOGE(GRAPH_FAILED, "[Reflect][Node] failed! status:%d", status);
+        return GRAPH_FAILED;
       }
     }
   }
   return GRAPH_SUCCESS;
 }
 graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                               std::unordered_map<ge::NodePtr, bool> &node_status) {
+                                               FormatRefineContext &context) {
   GE_CHECK_NOTNULL(node);
   GE_CHECK_NOTNULL(node->GetOpDesc());
   GELOGD("Enter forward infer process!Node is [%s]", node->GetName().c_str());
@@ -334,7 +361,26 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
 
       // Check format whether have been set
       int idx = peer_in_data_anchor->GetIdx();
-      // do peer_out_node name and index as key to lookup reflections
+      auto peer_in_desc = peer_in_data_node->GetOpDesc()->MutableInputDesc(static_cast<uint32_t>(idx));
+      if ((peer_in_desc == nullptr) || (peer_in_desc->GetOriginFormat() != FORMAT_ND)) {
+        continue;
+      }
+      auto dim_num = peer_in_desc->GetShape().GetDimNum();
+      if (dim_num == 0) {
+        GELOGI("node name:%s idx:%d in is scalar. stop forward infer!", peer_in_data_node->GetName().c_str(), idx);
+        continue;
+      }
+      /// Check whether node to change dims ()
+      /// Because some node will calculate with 5D, C dim maybe multi meaning
+      auto peer_in_data_node_type = peer_in_data_node->GetType();
+      auto iter1 = kChangeDimNodes.find(peer_in_data_node_type);
+      // 4 means dims num
+      if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
+        GELOGD("Node[%s] is change dim node. do not infer origin format", (peer_in_data_node->GetName()).c_str());
+        continue;
+      }
+
+      // do peer_out_node name and index as key to lookup reflections, only for the tensors going to be set
       ge::RefCell key(peer_in_data_node->GetName(), peer_in_data_node, ge::NODE_IN, idx);
       std::unordered_set<RefCell, RefCellHash> reflection;
       auto status = reflection_builder.LookUpRefRelations(key, reflection);
@@ -345,49 +391,32 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
                (peer_in_data_node->GetName()).c_str(), idx);
         return GRAPH_FAILED;
       }
-      auto ge_tensor_desc = peer_in_data_node->GetOpDesc()->GetInputDesc(static_cast<uint32_t>(idx));
-      if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-        auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
-        if (dim_num == 0) {
-          GELOGI("node name:%s idx:%d in is scalar. stop forward infer!", peer_in_data_node->GetName().c_str(), idx);
-          continue;
-        }
-        /// Check whether node to change dims ()
-        /// Because some node will calculate with 5D, C dim maybe multi meaning
-        auto peer_in_data_node_type = peer_in_data_node->GetType();
-        auto iter1 = kChangeDimNodes.find(peer_in_data_node_type);
-        // 4 means dims num
-        if ((iter1 != kChangeDimNodes.end()) && (dim_num < 4)) {
-          GELOGD("Node[%s] is change dim node. do not infer origin format", (peer_in_data_node->GetName()).c_str());
+      if (reflection.empty()) {
+        GeTensorDesc ge_tensor_desc = *peer_in_desc;
+        ge_tensor_desc.SetOriginFormat(to_be_set_format);
+        ge_tensor_desc.SetFormat(to_be_set_format);
+        (void)peer_in_data_node->GetOpDesc()->UpdateInputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
+
+        /// Because netoutput node added before infer format ,so netoutput is end condition
+        /// must set netoutput format , because saved result depend on format
+        if (peer_in_data_node_type == NETOUTPUT) {
           continue;
         }
 
-        if (reflection.empty()) {
-          ge_tensor_desc.SetOriginFormat(to_be_set_format);
-          ge_tensor_desc.SetFormat(to_be_set_format);
-          (void)peer_in_data_node->GetOpDesc()->UpdateInputDesc(static_cast<uint32_t>(idx), ge_tensor_desc);
-
-          /// Because netoutput node added before infer format ,so netoutput is end condition
-          /// must set netoutput format , because saved result depend on format
-          if (peer_in_data_node_type == NETOUTPUT) {
-            continue;
-          }
-
-          // Call operator infer format api (forward) to get out format
-          GELOGD("call infer format func[Back]!Node is [%s] ", (peer_in_data_node->GetName()).c_str());
-          status = peer_in_data_node->InferOriginFormat();
-          if (status != GRAPH_SUCCESS) {
-            GELOGE(GRAPH_FAILED, "[Infer][Format] failed, node:%s",
-                   (peer_in_data_node->GetName()).c_str());
-            return GRAPH_FAILED;
-          }
-          nodes.push_back(peer_in_data_node);
-        } else {
-          auto status = ReflectionProcess(reflection, nodes, to_be_set_format);
-          if (status != GRAPH_SUCCESS) {
-            GELOGE(GRAPH_FAILED, "[Reflect][Node] failed! status:%d", status);
-            return GRAPH_FAILED;
-          }
+        // Call operator infer format api (forward) to get out format
+        GELOGD("call infer format func[Back]!Node is [%s] ", (peer_in_data_node->GetName()).c_str());
+        status = peer_in_data_node->InferOriginFormat();
+        if (status != GRAPH_SUCCESS) {
+          GELOGE(GRAPH_FAILED, "[Infer][Format] failed, node:%s",
+                 (peer_in_data_node->GetName()).c_str());
+          return GRAPH_FAILED;
+        }
+        PushNode(nodes, peer_in_data_node, context);
+      } else {
+        status = ReflectionProcess(reflection, nodes, to_be_set_format, context);
+        if (status != GRAPH_SUCCESS) {
+          GELOGE(GRAPH_FAILED, "[Reflect][Node] failed! status:%d", status);
+          return GRAPH_FAILED;
         }
       }
     }
@@ -424,12 +453,11 @@ void FormatRefiner::RefreshOriginFormatOfAnchor(std::vector<ge::NodePtr> &anchor
   }
 }
 
-graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, std::vector<ge::NodePtr> &data_nodes,
-                                                 ge::Format data_format,
-                                                 std::unordered_map<ge::NodePtr, bool> &node_status) {
-  if (!(IsGraphInferred(graph) && (!TypeUtils::IsInternalFormat(data_format)) && (data_format != FORMAT_ND))) {
-    GELOGI("no necessary to do DataNodeFormatProcess. is_graph_inferred:%d, data_format:%s", IsGraphInferred(graph),
-           TypeUtils::FormatToSerialString(data_format).c_str());
+graphStatus FormatRefiner::DataNodeFormatProcess(std::vector<ge::NodePtr> &data_nodes, ge::Format data_format,
+                                                 FormatRefineContext &context) {
+  if (!(context.is_graph_inferred && (!TypeUtils::IsInternalFormat(data_format)) && (data_format != FORMAT_ND))) {
+    GELOGI("no necessary to do DataNodeFormatProcess. is_graph_inferred:%d, data_format:%s",
+           context.is_graph_inferred, TypeUtils::FormatToSerialString(data_format).c_str());
     return GRAPH_SUCCESS;
   }
   GELOGD("Enter DataNodeFormatProcess");
@@ -467,7 +495,7 @@ graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, s
       continue;
     }
     GELOGD("data node [%s] start infer format process", node->GetName().c_str());
-    auto status = AnchorProcess(node, node_status);
+    auto status = AnchorProcess(node, context);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "[Call][AnchorProcess] failed, status:%d, node:%s", status, node->GetName().c_str());
       return GRAPH_FAILED;
@@ -480,8 +508,7 @@ graphStatus FormatRefiner::DataNodeFormatProcess(const ComputeGraphPtr &graph, s
 graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph) {
   GELOGI("Enter InferOrigineFormat process!");
 
-  // True: infered false:no-infered
-  std::unordered_map<ge::NodePtr, bool> node_status;
+  FormatRefineContext context;
   std::vector<ge::NodePtr> anchor_points;
   std::vector<ge::NodePtr> data_nodes;
 
@@ -490,6 +517,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
     GELOGE(GRAPH_FAILED, "[Check][Param] input graph is nullptr");
     return GRAPH_FAILED;
   }
+  context.is_graph_inferred = IsGraphInferred(graph);
   // build reflection relations of boundary
   (void)reflection_builder.Clear();
   auto status = reflection_builder.BuildRefRelations(*graph);
@@ -498,7 +526,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
     return GRAPH_FAILED;
   }
   // User set global net format
-  status = GetAnchorPoints(graph, anchor_points, data_nodes, node_status);
+  status = GetAnchorPoints(graph, anchor_points, data_nodes, context);
   if (status != GRAPH_SUCCESS) {
     GELOGE(GRAPH_FAILED, "GetAnchorPoints Process Faild! graph:%s", graph->GetName().c_str());
     return GRAPH_FAILED;
@@ -510,7 +538,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
     if (anchor_node == nullptr) {
       continue;
     }
-    status = AnchorProcess(anchor_node, node_status);
+    status = AnchorProcess(anchor_node, context);
     if (status != GRAPH_SUCCESS) {
       GELOGE(GRAPH_FAILED, "[Call][AnchorProcess] failed, node:%s", anchor_node->GetName().c_str());
       return GRAPH_FAILED;
@@ -521,7 +549,7 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
   /// format for these data nodes.
   /// Notice: ignore 5D formats
   auto data_format = graph->GetDataFormat();
-  status = DataNodeFormatProcess(graph, data_nodes, data_format, node_status);
+  status = DataNodeFormatProcess(data_nodes, data_format, context);
 
   (void)AttrUtils::SetBool(graph, kIsGraphInferred, true);
 
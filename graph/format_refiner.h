@@ -33,24 +33,32 @@
 #include "./ge_error_codes.h"
 
 namespace ge {
+// State shared by the propagation of one InferOrigineFormat call
+struct FormatRefineContext {
+  bool is_graph_inferred = false;
+  // dense id of every node of the graph and its subgraphs, used to index queued
+  std::unordered_map<const Node *, size_t> node_ids;
+  // whether the node is waiting in the worklist, a node is never queued twice
+  std::vector<bool> queued;
+};
+
 // ShapeRefiner performs shape inference for compute graphs
 class METADEF_FUNC_VISIBILITY FormatRefiner {
  public:
   static graphStatus InferOrigineFormat(const ge::ComputeGraphPtr &graph);
 
  private:
-  static graphStatus RefreshConstantOutProcess(const ComputeGraphPtr &graph, const OpDescPtr &op_desc);
+  static graphStatus RefreshConstantOutProcess(const OpDescPtr &op_desc, const FormatRefineContext &context);
   static graphStatus GetAnchorPoints(const ge::ComputeGraphPtr &graph, std::vector<ge::NodePtr> &anchor_points,
-                                     std::vector<ge::NodePtr> &data_nodes,
-                                     std::unordered_map<ge::NodePtr, bool> &node_status);
-  static graphStatus AnchorProcess(const ge::NodePtr &anchor_node, std::unordered_map<ge::NodePtr, bool> &node_status);
+                                     std::vector<ge::NodePtr> &data_nodes, FormatRefineContext &context);
+  static graphStatus AnchorProcess(const ge::NodePtr &anchor_node, FormatRefineContext &context);
   static void RefreshOriginFormatOfAnchor(std::vector<ge::NodePtr> &anchor_points);
   static graphStatus BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                      std::unordered_map<ge::NodePtr, bool> &node_status);
+                                      FormatRefineContext &context);
   static graphStatus ForwardInferProcess(std::deque<ge::NodePtr> &nodes, ge::NodePtr &node,
-                                         std::unordered_map<ge::NodePtr, bool> &node_status);
-  static graphStatus DataNodeFormatProcess(const ComputeGraphPtr &graph, std::vector<ge::NodePtr> &data_nodes,
-                                           ge::Format data_format, std::unordered_map<ge::NodePtr, bool> &node_status);
+                                         FormatRefineContext &context);
+  static graphStatus DataNodeFormatProcess(std::vector<ge::NodePtr> &data_nodes, ge::Format data_format,
+                                           FormatRefineContext &context);
   static bool IsGraphInferred(const ComputeGraphPtr &graph);
 };
 }  // namespace ge
@@ -35,17 +35,23 @@ COMMON_LOCAL_SRC_FILES := \
     ./utils/anchor_utils.cc \
     ./utils/tuning_utils.cc \
     ./utils/graph_utils.cc \
+    ./utils/graph_binary_file.cc \
     ./utils/dumper/ge_graph_dumper.cc \
+    ./utils/dumper/ge_async_graph_dumper.cc \
     ./utils/ge_ir_utils.cc \
     ./utils/op_desc_utils.cc \
+    ./utils/symbolic_shape_utils.cc \
+    ./utils/value_range_utils.cc \
     ./utils/type_utils.cc \
     ./utils/tensor_utils.cc \
+    ./utils/weight_dedup_utils.cc \
     ./tensor.cc \
     ./debug/graph_debug.cc \
     ./opsproto/opsproto_manager.cc \
     ../ops/op_imp.cpp \
     option/ge_context.cc \
     option/ge_local_context.cc \
+    ./infer_shape_cache.cc \
     ./runtime_inference_context.cc \
     ./utils/node_utils.cc \
     ../third_party/transformer/src/axis_util.cc \
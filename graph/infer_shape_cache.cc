@@ -0,0 +1,187 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/infer_shape_cache.h"
+
+#include "debug/ge_attr_define.h"
+#include "debug/ge_log.h"
+#include "debug/ge_op_types.h"
+#include "graph/model.h"
+#include "graph/detail/model_serialize_imp.h"
+
+namespace ge {
+namespace {
+thread_local bool is_watched_uncacheable = false;
+
+void AppendInferFuncId(const InferShapeFunc &infer_func, std::string &key) {
+  key.append(infer_func.target_type().name());
+  key.push_back('\0');
+  // plain functions share one target type, the address tells them apart
+  const auto func_ptr = infer_func.target<graphStatus (*)(Operator &)>();
+  if (func_ptr != nullptr) {
+    const auto address = reinterpret_cast<uintptr_t>(*func_ptr);
+    key.append(reinterpret_cast<const char *>(&address), sizeof(address));
+  }
+  key.push_back('\0');
+}
+}  // namespace
+
+InferShapeCache &InferShapeCache::Instance() {
+  static InferShapeCache instance;
+  return instance;
+}
+
+void InferShapeCache::Enable(const InferShapeCacheOptions &options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_ = options;
+  (void)options_.ignored_attrs.insert(ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES);
+  (void)options_.ignored_attrs.insert(ATTR_NAME_DATA_DUMP_ORIGIN_NAME);
+  // keys being built keep the set they started with
+  ignored_attrs_ = std::make_shared<const std::set<std::string>>(options_.ignored_attrs);
+  is_enabled_ = true;
+}
+
+void InferShapeCache::Disable() {
+  is_enabled_ = false;
+  const auto statistics = GetStatistics();
+  GELOGI("Infer shape cache hit %lu, miss %lu, skip %lu, hit rate %.2f%%.", statistics.hit_num, statistics.miss_num,
+         statistics.skip_num, GetHitRate() * 100.0);
+  Clear();
+}
+
+void InferShapeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  statistics_ = InferShapeCacheStatistics();
+}
+
+InferShapeCacheStatistics InferShapeCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+double InferShapeCache::GetHitRate() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t lookup_num = statistics_.hit_num + statistics_.miss_num;
+  return (lookup_num == 0U) ? 0.0 : (static_cast<double>(statistics_.hit_num) / static_cast<double>(lookup_num));
+}
+
+void InferShapeCache::MarkUncacheable() {
+  is_watched_uncacheable = true;
+}
+
+bool InferShapeCache::BuildInputKey(const OpDescPtr &op_desc, std::string &input_key, std::string &output_key) const {
+  std::shared_ptr<const std::set<std::string>> ignored_attrs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ignored_attrs = ignored_attrs_;
+  }
+  if (ignored_attrs == nullptr) {
+    return false;
+  }
+  return ModelSerializeImp::SerializeOpDescKey(op_desc, *ignored_attrs, input_key, output_key);
+}
+
+bool InferShapeCache::BuildKey(const OpDescPtr &op_desc, const InferShapeFunc &infer_func, std::string &key) {
+  const auto &op_type = op_desc->GetType();
+  // the weights of constants would dominate the key, and ops with subgraphs infer from the subgraphs
+  const bool is_skipped = (op_type == CONSTANT) || (op_type == CONSTANTOP) ||
+                          !op_desc->GetSubgraphInstanceNames().empty();
+  std::string input_key;
+  std::string output_key;
+  if (is_skipped || !BuildInputKey(op_desc, input_key, output_key)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.skip_num;
+    return false;
+  }
+  key.reserve(op_type.size() + input_key.size() + output_key.size() + 64U);
+  key.append(op_type);
+  key.push_back('\0');
+  AppendInferFuncId(infer_func, key);
+  key.append(std::to_string(input_key.size()));
+  key.push_back('\0');
+  key.append(input_key);
+  key.append(output_key);
+  return true;
+}
+
+bool InferShapeCache::Lookup(const std::string &key, const OpDescPtr &op_desc) {
+  CacheEntry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+      ++statistics_.miss_num;
+      return false;
+    }
+    ++statistics_.hit_num;
+    entry = iter->second;
+  }
+  // the input descs are restored too, the shape transformer around the infer func may have completed them
+  for (const auto &input_desc : entry.input_descs) {
+    (void)op_desc->UpdateInputDesc(input_desc.first, input_desc.second);
+  }
+  for (const auto &output_desc : entry.output_descs) {
+    (void)op_desc->UpdateOutputDesc(output_desc.first, output_desc.second);
+  }
+  GELOGD("Infer shape of %s hits the cache.", op_desc->GetName().c_str());
+  return true;
+}
+
+void InferShapeCache::BeginWatch(const OpDescPtr &op_desc, std::string &watch_key) const {
+  is_watched_uncacheable = false;
+  std::string output_key;
+  if (!BuildInputKey(op_desc, watch_key, output_key)) {
+    is_watched_uncacheable = true;
+  }
+}
+
+bool InferShapeCache::EndWatch(const OpDescPtr &op_desc, const std::string &watch_key) const {
+  if (is_watched_uncacheable) {
+    return false;
+  }
+  std::string input_key;
+  std::string output_key;
+  return BuildInputKey(op_desc, input_key, output_key) && (input_key == watch_key);
+}
+
+void InferShapeCache::Store(const std::string &key, const OpDescPtr &op_desc, bool is_cacheable) {
+  if (!is_cacheable) {
+    GELOGD("Infer shape result of %s is not cached.", op_desc->GetName().c_str());
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.skip_num;
+    return;
+  }
+  CacheEntry entry;
+  for (uint32_t i = 0U; i < static_cast<uint32_t>(op_desc->GetAllInputsSize()); ++i) {
+    const auto input_desc = op_desc->MutableInputDesc(i);
+    if (input_desc != nullptr) {
+      entry.input_descs.emplace_back(i, *input_desc);
+    }
+  }
+  for (uint32_t i = 0U; i < static_cast<uint32_t>(op_desc->GetOutputsSize()); ++i) {
+    const auto output_desc = op_desc->MutableOutputDesc(i);
+    if (output_desc != nullptr) {
+      entry.output_descs.emplace_back(i, *output_desc);
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.size() < options_.max_entry_num) {
+    (void)entries_.emplace(key, std::move(entry));
+  }
+}
+}  // namespace ge
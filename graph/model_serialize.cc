@@ -16,8 +16,11 @@
  */
 
 #include "graph/model_serialize.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
 #include <queue>
 #include <iostream>
 
@@ -30,12 +33,50 @@
 #include "graph/compute_graph_impl.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/graph_utils.h"
+#include "utils/thread_pool.h"
+#include "utils/weight_dedup_utils.h"
 #include "debug/ge_op_types.h"
 
 using std::map;
 using std::string;
 
 namespace ge {
+namespace {
+// Below this size the cost of starting workers is larger than the serialization itself
+const size_t kMinNodeNumForParallel = 256U;
+
+template<typename T>
+void AppendKeyValue(const T &value, std::string &key) {
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendKeyString(const std::string &value, std::string &key) {
+  AppendKeyValue(static_cast<uint64_t>(value.size()), key);
+  key.append(value);
+}
+
+// msg behind its size, map fields are written in key order so equal messages give equal bytes
+void AppendKeyMessage(const google::protobuf::Message &msg, std::string &key) {
+#if !defined(__ANDROID__) && !defined(ANDROID)
+  AppendKeyValue(static_cast<uint64_t>(msg.ByteSizeLong()), key);
+#else
+  AppendKeyValue(static_cast<uint64_t>(msg.ByteSize()), key);
+#endif
+  google::protobuf::io::StringOutputStream stream(&key);
+  google::protobuf::io::CodedOutputStream coded_stream(&stream);
+  coded_stream.SetSerializationDeterministic(true);
+  // sizes are cached by the ByteSizeLong call above
+  msg.SerializeWithCachedSizes(&coded_stream);
+}
+
+void AppendKeyTensorDesc(const proto::TensorDescriptor *tensor_desc, std::string &key) {
+  key.push_back((tensor_desc != nullptr) ? '\1' : '\0');
+  if (tensor_desc != nullptr) {
+    AppendKeyMessage(*tensor_desc, key);
+  }
+}
+}
+
 bool ModelSerializeImp::ParseNodeIndex(const string &node_index, string &node_name, int32_t &index) {
   auto sep = node_index.rfind(":");
   if (sep == string::npos) {
@@ -72,6 +113,72 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::Serialize
   return false;
 }
 
+bool ModelSerializeImp::SerializeOpDescKey(const ConstOpDescPtr &op_desc, const std::set<std::string> &ignored_attrs,
+                                           std::string &input_key, std::string &output_key) {
+  if ((op_desc == nullptr) || (op_desc->impl_ == nullptr) || (op_desc->impl_->op_def_.GetProtoMsg() == nullptr)) {
+    return false;
+  }
+  const proto::OpDef &op_def = *op_desc->impl_->op_def_.GetProtoMsg();
+  AppendKeyString(op_def.type(), input_key);
+  std::vector<const google::protobuf::MapPair<std::string, proto::AttrDef> *> attrs;
+  attrs.reserve(static_cast<size_t>(op_def.attr().size()));
+  for (const auto &attr : op_def.attr()) {
+    if (ignored_attrs.count(attr.first) == 0U) {
+      attrs.emplace_back(&attr);
+    }
+  }
+  std::sort(attrs.begin(), attrs.end(), [](const google::protobuf::MapPair<std::string, proto::AttrDef> *left,
+                                           const google::protobuf::MapPair<std::string, proto::AttrDef> *right) {
+    return left->first < right->first;
+  });
+  AppendKeyValue(static_cast<uint64_t>(attrs.size()), input_key);
+  for (const auto attr : attrs) {
+    AppendKeyString(attr->first, input_key);
+    AppendKeyMessage(attr->second, input_key);
+  }
+  // the names an infer func reads the inputs and outputs by
+  AppendKeyValue(static_cast<uint64_t>(op_desc->impl_->input_name_idx_.size()), input_key);
+  for (const auto &name_idx : op_desc->impl_->input_name_idx_) {
+    AppendKeyString(name_idx.first, input_key);
+    AppendKeyValue(name_idx.second, input_key);
+  }
+  AppendKeyValue(static_cast<uint64_t>(op_desc->impl_->output_name_idx_.size()), input_key);
+  for (const auto &name_idx : op_desc->impl_->output_name_idx_) {
+    AppendKeyString(name_idx.first, input_key);
+    AppendKeyValue(name_idx.second, input_key);
+  }
+  AppendKeyValue(static_cast<uint64_t>(op_desc->impl_->optional_input_names_.size()), input_key);
+  for (const auto &name : op_desc->impl_->optional_input_names_) {
+    AppendKeyString(name, input_key);
+  }
+  AppendKeyValue(static_cast<uint64_t>(op_def.is_input_const_size()), input_key);
+  for (const auto is_input_const : op_def.is_input_const()) {
+    input_key.push_back(is_input_const ? '\1' : '\0');
+  }
+  input_key.push_back(op_def.has_out_attr() ? '\1' : '\0');
+  const auto &subgraph_names = op_desc->GetSubgraphInstanceNames();
+  AppendKeyValue(static_cast<uint64_t>(subgraph_names.size()), input_key);
+  for (const auto &name : subgraph_names) {
+    AppendKeyString(name, input_key);
+  }
+
+  const auto tensor_proto = [](const ConstGeTensorDescPtr &tensor_desc) -> const proto::TensorDescriptor * {
+    return ((tensor_desc == nullptr) || (tensor_desc->impl_ == nullptr)) ?
+           nullptr : tensor_desc->impl_->tensor_descriptor_.GetProtoMsg();
+  };
+  const auto input_num = static_cast<uint32_t>(op_desc->GetAllInputsSize());
+  AppendKeyValue(input_num, input_key);
+  for (uint32_t i = 0U; i < input_num; ++i) {
+    AppendKeyTensorDesc(tensor_proto(op_desc->GetInputDescPtrDfault(i)), input_key);
+  }
+  const auto output_num = static_cast<uint32_t>(op_desc->GetOutputsSize());
+  AppendKeyValue(output_num, output_key);
+  for (uint32_t i = 0U; i < output_num; ++i) {
+    AppendKeyTensorDesc(tensor_proto(op_desc->GetOutputDescPtr(i)), output_key);
+  }
+  return true;
+}
+
 bool ModelSerializeImp::SerializeEdge(const NodePtr &node, proto::OpDef *op_def_proto) {
   GE_CHK_BOOL_EXEC(node != nullptr, REPORT_INNER_ERROR("E19999", "param node is nullptr, check invalid.");
                    return false, "[Check][Param] node is null.");
@@ -210,14 +317,7 @@ bool ModelSerializeImp::SerializeNode(const NodePtr &node, proto::OpDef *op_def_
   }
 }
 
-GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::SerializeGraph(const ConstComputeGraphPtr &graph,
-                                                                                      proto::GraphDef *graph_proto,
-                                                                                      bool is_dump) {
-  if (graph == nullptr || graph_proto == nullptr) {
-    REPORT_INNER_ERROR("E19999", "param graph or graph_proto is nullptr, check invalid.");
-    GELOGE(GRAPH_FAILED, "[Check][Param] param graph or graph_proto is nullptr, check invalid.");
-    return false;
-  }
+bool ModelSerializeImp::SerializeGraphHead(const ConstComputeGraphPtr &graph, proto::GraphDef *graph_proto) {
   graph_proto->set_name(graph->GetName());
   // Inputs
   for (const auto &input : graph->GetInputNodes()) {
@@ -235,6 +335,21 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::Serialize
   if (graph->impl_ != nullptr && graph->impl_->attrs_.GetProtoMsg() != nullptr) {
     *graph_proto->mutable_attr() = *graph->impl_->attrs_.GetProtoMsg();
   }
+  return true;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::SerializeGraph(const ConstComputeGraphPtr &graph,
+                                                                                      proto::GraphDef *graph_proto,
+                                                                                      bool is_dump) {
+  if (graph == nullptr || graph_proto == nullptr) {
+    REPORT_INNER_ERROR("E19999", "param graph or graph_proto is nullptr, check invalid.");
+    GELOGE(GRAPH_FAILED, "[Check][Param] param graph or graph_proto is nullptr, check invalid.");
+    return false;
+  }
+  if (parallel_num_ > 1U) {
+    return SerializeGraphsParallel({graph}, {graph_proto}, is_dump);
+  }
+  (void)SerializeGraphHead(graph, graph_proto);
   for (const auto &node : graph->GetDirectNode()) {
     if (!SerializeNode(node, graph_proto->add_op(), is_dump)) {
       if (node->GetOpDesc() != nullptr) {
@@ -247,6 +362,59 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::Serialize
   return true;
 }
 
+bool ModelSerializeImp::SerializeGraphsParallel(const std::vector<ConstComputeGraphPtr> &graphs,
+                                                const std::vector<proto::GraphDef *> &graph_protos, bool is_dump) {
+  if (graphs.size() != graph_protos.size()) {
+    REPORT_INNER_ERROR("E19999", "graph num %zu is not equal to graph proto num %zu.", graphs.size(),
+                       graph_protos.size());
+    GELOGE(GRAPH_FAILED, "[Check][Param] graph num %zu is not equal to graph proto num %zu.", graphs.size(),
+           graph_protos.size());
+    return false;
+  }
+  // Every op slot is allocated here in the serial order, workers only fill the slot they own,
+  // so the output is the same as the one of the serial path.
+  std::vector<std::pair<NodePtr, proto::OpDef *>> op_slots;
+  for (size_t i = 0U; i < graphs.size(); ++i) {
+    if (graphs[i] == nullptr || graph_protos[i] == nullptr) {
+      REPORT_INNER_ERROR("E19999", "param graph or graph_proto is nullptr, check invalid.");
+      GELOGE(GRAPH_FAILED, "[Check][Param] param graph or graph_proto is nullptr, check invalid.");
+      return false;
+    }
+    (void)SerializeGraphHead(graphs[i], graph_protos[i]);
+    const auto nodes = graphs[i]->GetDirectNode();
+    graph_protos[i]->mutable_op()->Reserve(static_cast<int32_t>(nodes.size()));
+    for (const auto &node : nodes) {
+      op_slots.emplace_back(node, graph_protos[i]->add_op());
+    }
+  }
+
+  std::vector<uint8_t> results(op_slots.size(), 0U);
+  auto serialize_slots = [this, &op_slots, &results, is_dump](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      results[i] = SerializeNode(op_slots[i].first, op_slots[i].second, is_dump) ? 1U : 0U;
+    }
+  };
+  if ((parallel_num_ <= 1U) || (op_slots.size() < kMinNodeNumForParallel)) {
+    serialize_slots(0U, op_slots.size());
+  } else {
+    // the calling thread serializes one shard as well
+    GraphThreadPool pool(parallel_num_ - 1U);
+    pool.ParallelFor(op_slots.size(), serialize_slots);
+  }
+
+  for (size_t i = 0U; i < op_slots.size(); ++i) {
+    if (results[i] == 0U) {
+      const auto &node = op_slots[i].first;
+      if (node != nullptr && node->GetOpDesc() != nullptr) {
+        REPORT_CALL_ERROR("E19999", "op desc of node:%s is nullptr.", node->GetName().c_str());
+        GELOGE(GRAPH_FAILED, "[Get][OpDesc] Serialize Node %s failed as node opdesc is null", node->GetName().c_str());
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ModelSerializeImp::SerializeModel(const Model &model, proto::ModelDef *model_proto, bool is_dump) {
   if (model_proto == nullptr) {
     REPORT_INNER_ERROR("E19999", "param model_proto is nullptr, check invalid.");
@@ -266,18 +434,35 @@ bool ModelSerializeImp::SerializeModel(const Model &model, proto::ModelDef *mode
     GELOGE(GRAPH_FAILED, "[Get][ComputeGraph] return nullptr");
     return false;
   }
-  if (!SerializeGraph(compute_graph, model_proto->add_graph(), is_dump)) {
-    GELOGE(GRAPH_FAILED, "[Serialize][Graph] failed");
-    return false;
-  }
-
-  for (auto subgraph : compute_graph->GetAllSubgraphs()) {
-    if (!SerializeGraph(subgraph, model_proto->add_graph(), is_dump)) {
-      GELOGE(GRAPH_FAILED, "[Serialize][Subgraph] failed");
+  if (parallel_num_ > 1U) {
+    // Root graph and subgraphs are serialized together, so small subgraphs do not serialize the workers
+    std::vector<ConstComputeGraphPtr> graphs = {compute_graph};
+    std::vector<proto::GraphDef *> graph_protos = {model_proto->add_graph()};
+    for (const auto &subgraph : compute_graph->GetAllSubgraphs()) {
+      graphs.emplace_back(subgraph);
+      graph_protos.emplace_back(model_proto->add_graph());
+    }
+    if (!SerializeGraphsParallel(graphs, graph_protos, is_dump)) {
+      GELOGE(GRAPH_FAILED, "[Serialize][Graph] failed");
+      return false;
+    }
+  } else {
+    if (!SerializeGraph(compute_graph, model_proto->add_graph(), is_dump)) {
+      GELOGE(GRAPH_FAILED, "[Serialize][Graph] failed");
       return false;
     }
+
+    for (auto subgraph : compute_graph->GetAllSubgraphs()) {
+      if (!SerializeGraph(subgraph, model_proto->add_graph(), is_dump)) {
+        GELOGE(GRAPH_FAILED, "[Serialize][Subgraph] failed");
+        return false;
+      }
+    }
   }
 
+  if (dedup_weights_) {
+    (void)WeightDedupUtils::DedupModelDef(*model_proto);
+  }
   return true;
 }
 
@@ -543,6 +728,10 @@ bool ModelSerializeImp::RebuildOwnership(ComputeGraphPtr &compute_graph, map<str
 }
 
 bool ModelSerializeImp::UnserializeModel(Model &model, proto::ModelDef &model_proto) {
+  if (!WeightDedupUtils::RestoreModelDef(model_proto)) {
+    GELOGE(GRAPH_FAILED, "[Restore][Weights] restore shared weights of model %s failed", model_proto.name().c_str());
+    return false;
+  }
   model.name_ = model_proto.name();
   model.version_ = model_proto.version();
   model.platform_version_ = model_proto.custom_version();
@@ -651,8 +840,18 @@ bool ReadProtoFromBinaryFile(const uint8_t *data, size_t len, google::protobuf::
 }
 
 Buffer ModelSerialize::SerializeModel(const Model &model, bool is_dump) {
+  return SerializeModel(model, is_dump, 1U);
+}
+
+Buffer ModelSerialize::SerializeModel(const Model &model, bool is_dump, uint32_t parallel_num) {
+  return SerializeModel(model, is_dump, parallel_num, false);
+}
+
+Buffer ModelSerialize::SerializeModel(const Model &model, bool is_dump, uint32_t parallel_num, bool dedup_weights) {
   proto::ModelDef model_def;
   ModelSerializeImp imp;
+  imp.SetParallelNum(parallel_num);
+  imp.SetDedupWeights(dedup_weights);
   if (!imp.SerializeModel(model, &model_def, is_dump)) {
     return Buffer();
   }
@@ -740,8 +939,13 @@ Model ModelSerialize::UnserializeModel(ge::proto::ModelDef &model_def) {
 }
 
 Buffer ModelSerialize::SerializeGraph(const ComputeGraphPtr &graph) {
+  return SerializeGraph(graph, 1U);
+}
+
+Buffer ModelSerialize::SerializeGraph(const ComputeGraphPtr &graph, uint32_t parallel_num) {
   proto::GraphDef graph_def;
   ModelSerializeImp imp;
+  imp.SetParallelNum(parallel_num);
   if (!imp.SerializeGraph(graph, &graph_def)) {
     return Buffer();
   }
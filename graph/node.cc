@@ -793,10 +793,8 @@ graphStatus Node::NodeImpl::Verify(const ge::ConstNodePtr &owner_node) const {
   GE_IF_BOOL_EXEC(is_unknown_graph, return GRAPH_SUCCESS;);
   if (op_->CommonVerify() == GRAPH_SUCCESS) {
     Operator op_proxy = ge::OpDescUtils::CreateOperatorFromNode(owner_node);
+    // falls back to the function registered for the op type
     auto verify_func = op_->GetVerifyFunc();
-    if (verify_func == nullptr) {
-      verify_func = OperatorFactoryImpl::GetVerifyFunc(GetType());
-    }
     if (verify_func != nullptr) {
       return (graphStatus)verify_func(op_proxy);
     }
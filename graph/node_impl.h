@@ -21,6 +21,8 @@
 #include "graph/node.h"
 
 namespace ge {
+class OperatorImpl;
+
 class Node::NodeImpl {
  public:
   NodeImpl() = default;
@@ -105,6 +107,8 @@ class Node::NodeImpl {
   void SetOrigNode(const NodePtr &orignode) { orig_node_ = orignode; }
   NodePtr GetOrigNode() { return orig_node_; }
 
+  std::shared_ptr<OperatorImpl> &MutableOperatorView() { return operator_view_; }
+
  private:
   friend class NodeUtils;
   friend class TuningUtils;
@@ -125,6 +129,8 @@ class Node::NodeImpl {
   kFusionDataFlowVec_t fusion_input_dataflow_list_;
   kFusionDataFlowVec_t fusion_output_dataflow_list_;
   NodePtr orig_node_{nullptr};
+  // created by OpDescUtils::GetOperatorViewFromNode on first use, refers back to the node weakly
+  std::shared_ptr<OperatorImpl> operator_view_{nullptr};
 };
 }  // namespace ge
 #endif  // GRAPH_BUFFER_IMPL_H_
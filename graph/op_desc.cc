@@ -25,6 +25,7 @@
 #include "graph/common_error_codes.h"
 #include "graph/ge_attr_value.h"
 #include "graph/ge_tensor.h"
+#include "graph/infer_shape_cache.h"
 #include "graph/operator_factory_impl.h"
 #include "graph/op_desc_impl.h"
 #include "graph/utils/attr_utils.h"
@@ -120,6 +121,8 @@ void OpDescImpl::SetType(const string &type) {
   if (proto_msg != nullptr) {
     proto_msg->set_type(type);
   }
+  op_func_table_ = nullptr;
+  tiling_func_info_ = nullptr;
 }
 
 graphStatus OpDescImpl::AddInputDesc(const ge::GeTensorDesc &input_desc) {
@@ -514,6 +517,12 @@ void OpDescImpl::SetOpEngineName(const std::string &name) {
 
 std::string OpDescImpl::GetOpEngineName() const { return engine_name_; }
 
+void OpDescImpl::SetTilingFuncInfo(const std::shared_ptr<void> &tiling_func_info) {
+  tiling_func_info_ = tiling_func_info;
+}
+
+const std::shared_ptr<void> &OpDescImpl::GetTilingFuncInfo() const { return tiling_func_info_; }
+
 OpDesc::Vistor<GeTensorDesc> OpDescImpl::GetAllInputsDesc(const ConstOpDescPtr &op_desc) const {
   vector<GeTensorDesc> temp{};
   for (const auto &it : inputs_desc_) {
@@ -829,31 +838,58 @@ bool OpDescImpl::UpdateOutputName(std::map<string, uint32_t> output_name_idx) {
   return false;
 }
 
-std::function<graphStatus(Operator &)> OpDescImpl::GetInferFunc() const { return infer_func_; }
+const OpFuncTable *OpDescImpl::GetOpFuncTable() const {
+  if (op_func_table_ == nullptr) {
+    op_func_table_ = OperatorFactoryImpl::GetOpFuncTable(GetType());
+  }
+  return op_func_table_;
+}
 
-std::function<graphStatus(Operator &)> OpDescImpl::GetVerifyFunc() const { return verifier_func_; }
+std::function<graphStatus(Operator &)> OpDescImpl::GetInferFunc() const {
+  if (infer_func_ != nullptr) {
+    return infer_func_;
+  }
+  const auto func_table = GetOpFuncTable();
+  return (func_table == nullptr) ? nullptr : func_table->infer_shape_func;
+}
+
+std::function<graphStatus(Operator &)> OpDescImpl::GetVerifyFunc() const {
+  if (verifier_func_ != nullptr) {
+    return verifier_func_;
+  }
+  const auto func_table = GetOpFuncTable();
+  return (func_table == nullptr) ? nullptr : func_table->verify_func;
+}
 
 void OpDescImpl::AddInferFunc(const std::function<graphStatus(Operator &)> &func) { infer_func_ = func; }
 
-std::function<graphStatus(Operator &)> OpDescImpl::GetInferFormatFunc() const { return infer_format_func_; }
+std::function<graphStatus(Operator &)> OpDescImpl::GetInferFormatFunc() const {
+  if (infer_format_func_ != nullptr) {
+    return infer_format_func_;
+  }
+  const auto func_table = GetOpFuncTable();
+  return (func_table == nullptr) ? nullptr : func_table->infer_format_func;
+}
 
 void OpDescImpl::AddInferFormatFunc(const std::function<graphStatus(Operator &)> &func) { infer_format_func_ = func; }
 
 void OpDescImpl::AddVerifierFunc(const std::function<graphStatus(Operator &)> &func) { verifier_func_ = func; }
 
 graphStatus OpDescImpl::InferShapeAndType(const OpDescPtr &op_desc) {
+  const InferShapeFunc *infer_func = &infer_func_;
   if (infer_func_ == nullptr) {
-    infer_func_ = OperatorFactoryImpl::GetInferShapeFunc(GetType());
-    if (infer_func_ == nullptr) {
+    const auto func_table = GetOpFuncTable();
+    if ((func_table == nullptr) || (func_table->infer_shape_func == nullptr)) {
       GELOGW("[InferShape][Check] %s does not have infer_func.", GetName().c_str());
       /// The infer_func has not been added for each operator in the current operator information library.
       /// No infer_func added operator skips the call
       /// and directly uses the shape information passed down by the upper framework
       return GRAPH_SUCCESS;
     }
+    infer_func = &func_table->infer_shape_func;
   }
   Operator op_proxy = ge::OpDescUtils::CreateOperatorFromOpDesc(op_desc);
-  graphStatus ret = (graphStatus)infer_func_(op_proxy);
+  graphStatus ret = (graphStatus)(*infer_func)(op_proxy);
   op_proxy.BreakConnect();
   return ret;
 }
@@ -900,12 +936,14 @@ graphStatus OpDescImpl::DefaultInferFormat(const ConstOpDescPtr &op_desc) {
 }
 
 graphStatus OpDescImpl::OpVerify(const OpDescPtr &op_desc) {
+  const VerifyFunc *verifier_func = &verifier_func_;
   if (verifier_func_ == nullptr) {
-    verifier_func_ = OperatorFactoryImpl::GetVerifyFunc(GetType());
+    const auto func_table = GetOpFuncTable();
+    verifier_func = (func_table == nullptr) ? nullptr : &func_table->verify_func;
   }
-  if (verifier_func_ != nullptr) {
+  if ((verifier_func != nullptr) && (*verifier_func != nullptr)) {
     Operator op_proxy = ge::OpDescUtils::CreateOperatorFromOpDesc(op_desc);
-    graphStatus ret = (graphStatus)verifier_func_(op_proxy);
+    graphStatus ret = (graphStatus)(*verifier_func)(op_proxy);
     op_proxy.BreakConnect();
     return ret;
   }
@@ -1254,12 +1292,19 @@ graphStatus OpDescImpl::RestoreOutputNameIdx(const string &name,
 }
 
 graphStatus OpDescImpl::CallInferFunc(Operator &op, const OpDescPtr &op_desc) {
+  const InferShapeFunc *infer_func = &infer_func_;
   if (infer_func_ == nullptr) {
-    infer_func_ = OperatorFactoryImpl::GetInferShapeFunc(GetType());
-    if (infer_func_ == nullptr) {
+    const auto func_table = GetOpFuncTable();
+    if ((func_table == nullptr) || (func_table->infer_shape_func == nullptr)) {
       GELOGW("[InferShape][Check] %s does not have infer_func.", GetName().c_str());
       return GRAPH_PARAM_INVALID;
     }
+    infer_func = &func_table->infer_shape_func;
+  }
+  auto &cache = InferShapeCache::Instance();
+  std::string cache_key;
+  if (cache.IsEnabled() && cache.BuildKey(op_desc, *infer_func, cache_key) && cache.Lookup(cache_key, op_desc)) {
+    return GRAPH_SUCCESS;
   }
   std::unique_ptr<NodeShapeTransUtils> transformer(new(std::nothrow) NodeShapeTransUtils(op_desc));
   if (transformer == nullptr) {
@@ -1276,39 +1321,50 @@ graphStatus OpDescImpl::CallInferFunc(Operator &op, const OpDescPtr &op_desc) {
     GELOGE(GRAPH_FAILED, "[Call][CatchFormatAndShape] for transformer failed!");
     return GRAPH_FAILED;
   }
-  graphStatus graph_status = (graphStatus)infer_func_(op);
+  std::string cache_watch_key;
+  if (!cache_key.empty()) {
+    cache.BeginWatch(op_desc, cache_watch_key);
+  }
+  graphStatus graph_status = (graphStatus)(*infer_func)(op);
   if (graph_status != GRAPH_SUCCESS) {
     GELOGE(GRAPH_FAILED, "[Call][InferFunc] for %s failed. ret:%u", GetName().c_str(), graph_status);
     return GRAPH_FAILED;
   }
+  const bool is_cacheable = !cache_key.empty() && cache.EndWatch(op_desc, cache_watch_key);
   if (!transformer->UpdateFormatAndShape()) {
     GELOGE(GRAPH_FAILED, "[Call][UpdateFormatAndShape] for transformer failed!");
     return GRAPH_FAILED;
   }
+  if (!cache_key.empty()) {
+    cache.Store(cache_key, op_desc, is_cacheable);
+  }
   return graph_status;
 }
 
 graphStatus OpDescImpl::CallInferFormatFunc(Operator &op, const ConstOpDescPtr &op_desc) {
+  const InferFormatFunc *infer_format_func = &infer_format_func_;
   if (infer_format_func_ == nullptr) {
-    infer_format_func_ = OperatorFactoryImpl::GetInferFormatFunc(GetType());
-    if (infer_format_func_ == nullptr) {
+    const auto func_table = GetOpFuncTable();
+    if ((func_table == nullptr) || (func_table->infer_format_func == nullptr)) {
       return DefaultInferFormat(op_desc);
     }
+    infer_format_func = &func_table->infer_format_func;
   }
-  return (graphStatus)infer_format_func_(op);
+  return (graphStatus)(*infer_format_func)(op);
 }
 
 graphStatus OpDescImpl::CallInferValueRangeFunc(Operator &op, const ConstOpDescPtr &op_desc) {
+  const InferValueRangeFunc *infer_value_range_func = &infer_value_range_func_;
   if (infer_value_range_func_ == nullptr) {
-    auto infer_value_range_param = OperatorFactoryImpl::GetInferValueRangePara(GetType());
-    if (!infer_value_range_param.is_initialized) {
+    const auto func_table = GetOpFuncTable();
+    if ((func_table == nullptr) || !func_table->infer_value_range_para.is_initialized) {
       REPORT_CALL_ERROR("E19999", "Node %s does not register func to infer value range.", GetName().c_str());
       GELOGE(GRAPH_PARAM_INVALID, "Node %s does not register func to infer value range.", GetName().c_str());
       return GRAPH_PARAM_INVALID;
     }
 
-    infer_value_range_func_ = infer_value_range_param.infer_value_func;
-    if (infer_value_range_func_ == nullptr) {
+    infer_value_range_func = &func_table->infer_value_range_para.infer_value_func;
+    if (*infer_value_range_func == nullptr) {
       REPORT_CALL_ERROR("E19999", "Value range infer func of node %s has been registered, but infer func is nullptr.",
                         GetName().c_str());
       GELOGE(GRAPH_PARAM_INVALID, "Value range infer func of node %s has been registered, but infer func is nullptr.",
@@ -1316,7 +1372,7 @@ graphStatus OpDescImpl::CallInferValueRangeFunc(Operator &op, const ConstOpDescP
       return GRAPH_PARAM_INVALID;
     }
   }
-  return (graphStatus) infer_value_range_func_(op);
+  return (graphStatus)(*infer_value_range_func)(op);
 }
 
 std::string OpDescImpl::GetSubgraphInstanceName(uint32_t index) const {
@@ -1406,15 +1462,17 @@ graphStatus OpDescImpl::GetSubgraphNameByInstanceName(const std::string &instanc
 }
 
 graphStatus OpDescImpl::InferDataSlice(const OpDescPtr &op_desc) {
+  const InferDataSliceFunc *infer_data_slice_func = &infer_data_slice_func_;
   if (infer_data_slice_func_ == nullptr) {
-    infer_data_slice_func_ = OperatorFactoryImpl::GetInferDataSliceFunc(GetType());
-    if (infer_data_slice_func_ == nullptr) {
+    const auto func_table = GetOpFuncTable();
+    if ((func_table == nullptr) || (func_table->infer_data_slice_func == nullptr)) {
       GELOGW("[InferDataSlice][Check] %s does not have infer data slice func.", GetName().c_str());
       return NO_DEPENDENCE_FUNC;
     }
+    infer_data_slice_func = &func_table->infer_data_slice_func;
   }
   Operator op_proxy = ge::OpDescUtils::CreateOperatorFromOpDesc(op_desc);
-  graphStatus ret = (graphStatus)infer_data_slice_func_(op_proxy);
+  graphStatus ret = (graphStatus)(*infer_data_slice_func)(op_proxy);
   op_proxy.BreakConnect();
   return ret;
 }
@@ -1645,6 +1703,15 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY std::string OpDesc::GetOpEngineNa
   return impl_->GetOpEngineName();
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void OpDesc::SetTilingFuncInfo(
+    const std::shared_ptr<void> &tiling_func_info) {
+  impl_->SetTilingFuncInfo(tiling_func_info);
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY const std::shared_ptr<void> &OpDesc::GetTilingFuncInfo() const {
+  return impl_->GetTilingFuncInfo();
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OpDesc::Vistor<GeTensorDesc> OpDesc::GetAllInputsDesc() const {
   return impl_->GetAllInputsDesc(shared_from_this());
 }
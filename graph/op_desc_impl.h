@@ -23,6 +23,8 @@
 #include "graph/op_desc.h"
 
 namespace ge {
+struct OpFuncTable;
+
 class OpDescImpl {
  public:
   OpDescImpl();
@@ -66,6 +68,8 @@ class OpDescImpl {
   std::string GetOpKernelLibName() const;
   void SetOpEngineName(const std::string &name);
   std::string GetOpEngineName() const;
+  void SetTilingFuncInfo(const std::shared_ptr<void> &tiling_func_info);
+  const std::shared_ptr<void> &GetTilingFuncInfo() const;
 
   OpDesc::Vistor<GeTensorDesc> GetAllInputsDesc(const ConstOpDescPtr &op_desc) const;
   OpDesc::Vistor<GeTensorDescPtr> GetAllInputsDescPtr(const ConstOpDescPtr &op_desc) const;
@@ -117,6 +121,7 @@ class OpDescImpl {
   std::function<graphStatus(Operator &)> GetInferFormatFunc() const;
   void AddInferFormatFunc(const std::function<graphStatus(Operator &)> &func);
   void AddVerifierFunc(const std::function<graphStatus(Operator &)> &func);
+  const OpFuncTable *GetOpFuncTable() const;
 
   graphStatus InferShapeAndType(const OpDescPtr &op_desc);
   graphStatus DefaultInferFormat(const ConstOpDescPtr &op_desc);
@@ -226,6 +231,10 @@ class OpDescImpl {
   std::function<graphStatus(Operator &)> infer_value_range_func_ = nullptr;
   std::function<graphStatus(Operator &)> verifier_func_ = nullptr;
   std::function<graphStatus(Operator &)> infer_data_slice_func_ = nullptr;
+  // functions registered for the op type, used when no function is added to this op desc
+  mutable const OpFuncTable *op_func_table_ = nullptr;
+  // owned by the tiling of the register, see OpDesc::SetTilingFuncInfo
+  std::shared_ptr<void> tiling_func_info_;
   string op_kernel_lib_name_;
   string engine_name_;
 };
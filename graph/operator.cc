@@ -28,6 +28,8 @@
 #include "external/graph/attr_value.h"
 #include "graph/compute_graph.h"
 #include "graph/ge_context.h"
+#include "graph/infer_shape_cache.h"
+#include "graph/node_impl.h"
 #include "graph/runtime_inference_context.h"
 #include "graph/utils/node_utils.h"
 #include "graph/debug/ge_attr_define.h"
@@ -258,6 +260,7 @@ class OperatorImpl : public std::enable_shared_from_this<OperatorImpl> {
   }
 
   graphStatus GetInputConstData(const string &dst_name, Tensor &data) {
+    InferShapeCache::MarkUncacheable();
     auto node_ptr = GetNode();
     GE_IF_BOOL_EXEC(node_ptr == nullptr, return GetInputConstDataOut(dst_name, data);)
 
@@ -325,6 +328,7 @@ class OperatorImpl : public std::enable_shared_from_this<OperatorImpl> {
   }
 
   graphStatus GetInputConstDataOut(const string &dst_name, Tensor &data) {
+    InferShapeCache::MarkUncacheable();
     ge::OpIO out_handle("", 0, nullptr);
     if (GetInputImpl(dst_name, out_handle) != GRAPH_SUCCESS) {
       REPORT_CALL_ERROR("E19999", "%s get input impl failed", dst_name.c_str());
@@ -483,7 +487,18 @@ class OperatorImpl : public std::enable_shared_from_this<OperatorImpl> {
 
   void ClearInputLinks() noexcept { input_link_.clear(); }
 
-  ge::ConstNodePtr GetNode() { return node_; }
+  ge::ConstNodePtr GetNode() { return (node_ != nullptr) ? node_ : view_node_.lock(); }
+
+  // Rebinds a node owned operator to node for another use, the node is held weakly to avoid a reference cycle
+  void ResetAsNodeView(const ge::ConstNodePtr &node) {
+    view_node_ = node;
+    op_desc_ = node->GetOpDesc();
+    inference_context_ = nullptr;
+    ClearInputLinks();
+    ClearOutputLinks();
+    control_input_link_.clear();
+    control_output_link_.clear();
+  }
 
   void SetInferenceContext(const InferenceContextPtr &inference_context) { inference_context_ = inference_context; }
 
@@ -559,6 +574,7 @@ class OperatorImpl : public std::enable_shared_from_this<OperatorImpl> {
 
  private:
   ge::ConstNodePtr node_{nullptr};
+  std::weak_ptr<const Node> view_node_;
   ge::InferenceContextPtr inference_context_;
   std::map<string, std::vector<OpIO>> output_links_{};
   std::map<string, OpIO> input_link_{};
@@ -611,6 +627,38 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Operator OpDescUtils::CreateOpera
   return operator_impl_ptr->ToOperator();
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Operator OpDescUtils::CreateOperatorFromNode(
+    const ge::ConstNodePtr &node_ptr, const OpDescPtr &op_desc) {
+  ge::OperatorImplPtr operator_impl_ptr = ComGraphMakeShared<OperatorImpl>(node_ptr);
+  if (operator_impl_ptr == nullptr) {
+    REPORT_CALL_ERROR("E19999", "OperatorImpl make shared failed");
+    GELOGE(GRAPH_FAILED, "[Call][ComGraphMakeShared] OperatorImpl make shared failed");
+    return Operator("default");
+  }
+  if (op_desc != nullptr) {
+    operator_impl_ptr->op_desc_ = op_desc;
+  }
+  return operator_impl_ptr->ToOperator();
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+Operator OpDescUtils::GetOperatorViewFromNode(const ge::ConstNodePtr &node_ptr) {
+  if ((node_ptr == nullptr) || (node_ptr->impl_ == nullptr) || (node_ptr->GetOpDesc() == nullptr)) {
+    return CreateOperatorFromNode(node_ptr);
+  }
+  auto &operator_view = node_ptr->impl_->MutableOperatorView();
+  if (operator_view == nullptr) {
+    operator_view = ComGraphMakeShared<OperatorImpl>(node_ptr->GetOpDesc());
+    if (operator_view == nullptr) {
+      REPORT_CALL_ERROR("E19999", "OperatorImpl make shared failed");
+      GELOGE(GRAPH_FAILED, "[Call][ComGraphMakeShared] OperatorImpl make shared failed");
+      return Operator("default");
+    }
+  }
+  operator_view->ResetAsNodeView(node_ptr);
+  return operator_view->ToOperator();
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
 OpDescUtils::CopyOperators(ComputeGraphPtr &dst_compute_graph,
                            const std::map<ConstNodePtr, NodePtr> &node_old_2_new,
@@ -945,6 +993,7 @@ graphStatus Operator::GetInputConstDataOut(const string &dst_name, Tensor &data)
 }
 
 std::shared_ptr<const Node>  Operator::GetNode() const {
+  InferShapeCache::MarkUncacheable();
   GE_CHK_BOOL_EXEC(operator_impl_ != nullptr, REPORT_INNER_ERROR("E19999", "operator_impl_ is nullptr, check invalid");
                    return nullptr, "[Check][Param] operator impl is nullptr.");
   return operator_impl_->GetNode();
@@ -972,6 +1021,7 @@ void Operator::SetInferenceContext(const InferenceContextPtr &inference_context)
 }
 
 InferenceContextPtr Operator::GetInferenceContext() const {
+  InferShapeCache::MarkUncacheable();
   GE_CHK_BOOL_EXEC(operator_impl_ != nullptr, REPORT_INNER_ERROR("E19999", "operator_impl_ is nullptr, check invalid");
                    return nullptr, "[Check][Param] operator impl is nullptr.");
   return operator_impl_->GetInferenceContext();
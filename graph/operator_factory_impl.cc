@@ -16,9 +16,15 @@
  */
 
 #include "graph/operator_factory_impl.h"
+#include <mutex>
 #include "debug/ge_log.h"
 
 namespace ge {
+namespace {
+// guards operator_func_tables_, the tables themselves are read without it
+std::mutex func_tables_mutex;
+}  // namespace
+
 shared_ptr<std::map<string, OpCreator>> OperatorFactoryImpl::operator_creators_;
 shared_ptr<std::map<string, OpCreatorV2>> OperatorFactoryImpl::operator_creators_v2_;
 shared_ptr<std::map<string, InferShapeFunc>> OperatorFactoryImpl::operator_infershape_funcs_;
@@ -26,6 +32,7 @@ shared_ptr<std::map<string, InferFormatFunc>> OperatorFactoryImpl::operator_infe
 shared_ptr<std::map<string, VerifyFunc>> OperatorFactoryImpl::operator_verify_funcs_;
 shared_ptr<std::map<string, InferDataSliceFunc>> OperatorFactoryImpl::operator_infer_data_slice_funcs_;
 shared_ptr<std::map<string, InferValueRangePara>> OperatorFactoryImpl::operator_infer_value_range_paras_;
+shared_ptr<std::map<string, OpFuncTable>> OperatorFactoryImpl::operator_func_tables_;
 
 Operator OperatorFactoryImpl::CreateOperator(const std::string &operator_name, const std::string &operator_type) {
   if (operator_creators_v2_ != nullptr) {
@@ -147,6 +154,50 @@ InferDataSliceFunc OperatorFactoryImpl::GetInferDataSliceFunc(const std::string
   return it->second;
 }
 
+void OperatorFactoryImpl::BuildOpFuncTable(const std::string &operator_type, OpFuncTable &func_table) {
+  func_table.infer_shape_func = GetInferShapeFunc(operator_type);
+  func_table.infer_format_func = GetInferFormatFunc(operator_type);
+  func_table.verify_func = GetVerifyFunc(operator_type);
+  func_table.infer_data_slice_func = GetInferDataSliceFunc(operator_type);
+  if (operator_infer_value_range_paras_ != nullptr) {
+    auto it = operator_infer_value_range_paras_->find(operator_type);
+    if (it != operator_infer_value_range_paras_->end()) {
+      func_table.infer_value_range_para = it->second;
+    }
+  }
+}
+
+const OpFuncTable *OperatorFactoryImpl::GetOpFuncTable(const std::string &operator_type) {
+  std::lock_guard<std::mutex> lock(func_tables_mutex);
+  if (operator_func_tables_ == nullptr) {
+    operator_func_tables_.reset(new (std::nothrow) std::map<string, OpFuncTable>());
+    if (operator_func_tables_ == nullptr) {
+      GELOGW("[Create][FuncTable] Alloc op func tables failed.");
+      return nullptr;
+    }
+  }
+  auto it = operator_func_tables_->find(operator_type);
+  if (it != operator_func_tables_->end()) {
+    return &it->second;
+  }
+  // types without any registered function get an empty table too, so a miss is not looked up again
+  auto &func_table = (*operator_func_tables_)[operator_type];
+  BuildOpFuncTable(operator_type, func_table);
+  GELOGD("Op func table of type %s built.", operator_type.c_str());
+  return &func_table;
+}
+
+void OperatorFactoryImpl::RefreshOpFuncTable(const std::string &operator_type) {
+  std::lock_guard<std::mutex> lock(func_tables_mutex);
+  if (operator_func_tables_ == nullptr) {
+    return;
+  }
+  auto it = operator_func_tables_->find(operator_type);
+  if (it != operator_func_tables_->end()) {
+    BuildOpFuncTable(operator_type, it->second);
+  }
+}
+
 graphStatus OperatorFactoryImpl::RegisterOperatorCreator(const string &operator_type, OpCreator const &op_creator) {
   if (operator_creators_ == nullptr) {
     operator_creators_.reset(new (std::nothrow) std::map<string, OpCreator>());
@@ -183,6 +234,7 @@ graphStatus OperatorFactoryImpl::RegisterInferShapeFunc(const std::string &opera
     return GRAPH_FAILED;
   }
   (void)operator_infershape_funcs_->emplace(operator_type, infer_shape_func);
+  RefreshOpFuncTable(operator_type);
   return GRAPH_SUCCESS;
 }
 
@@ -197,6 +249,7 @@ graphStatus OperatorFactoryImpl::RegisterInferFormatFunc(const std::string &oper
     return GRAPH_FAILED;
   }
   (void)operator_inferformat_funcs_->emplace(operator_type, infer_format_func);
+  RefreshOpFuncTable(operator_type);
   return GRAPH_SUCCESS;
 }
 
@@ -210,6 +263,7 @@ graphStatus OperatorFactoryImpl::RegisterVerifyFunc(const std::string &operator_
     return GRAPH_FAILED;
   }
   (void)operator_verify_funcs_->emplace(operator_type, verify_func);
+  RefreshOpFuncTable(operator_type);
   return GRAPH_SUCCESS;
 }
 
@@ -224,6 +278,7 @@ graphStatus OperatorFactoryImpl::RegisterInferDataSliceFunc(const std::string &o
     return GRAPH_FAILED;
   }
   (void)operator_infer_data_slice_funcs_->emplace(operator_type, infer_data_slice_func);
+  RefreshOpFuncTable(operator_type);
   return GRAPH_SUCCESS;
 }
 
@@ -247,6 +302,7 @@ graphStatus OperatorFactoryImpl::RegisterInferValueRangeFunc(const string &opera
   }
   InferValueRangePara tmp_para(when_call, use_cpu_kernel, infer_value_range_func);
   (void)operator_infer_value_range_paras_->emplace(operator_type, tmp_para);
+  RefreshOpFuncTable(operator_type);
 
   GELOGD("Optype[%s] infervalue func registered successfully, when_call = %d, use_cpu_kernel = %d",
          operator_type.c_str(), static_cast<int32_t>(when_call), static_cast<int32_t>(use_cpu_kernel));
@@ -17,10 +17,13 @@
 
 #include "graph/shape_refiner.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "graph/debug/ge_attr_define.h"
 #include "graph/utils/graph_utils.h"
@@ -29,10 +32,13 @@
 #include "debug/ge_op_types.h"
 #include "debug/ge_util.h"
 #include "external/graph/operator_factory.h"
+#include "graph/ge_local_context.h"
 #include "graph/operator_factory_impl.h"
 #include "utils/node_utils.h"
 #include "utils/op_desc_utils.h"
+#include "utils/symbolic_shape_utils.h"
 #include "utils/tensor_utils.h"
+#include "utils/thread_pool.h"
 #include "utils/type_utils.h"
 
 namespace ge {
@@ -546,17 +552,243 @@ void ShapeRefiner::PrintInOutTensorShape(const ge::NodePtr &node, const std::str
 
 
 namespace {
-thread_local std::unordered_map<NodePtr, InferenceContextPtr> context_map;
+/// Inference contexts left by inferred nodes for their consumers. Each thread owns one, the parallel driver
+/// points its workers to a shared one, so the map is locked on every access.
+class InferenceContextMap {
+ public:
+  InferenceContextMap() = default;
+  InferenceContextMap(const InferenceContextMap &other) : contexts_(other.GetContexts()) {}
+  InferenceContextMap &operator=(const InferenceContextMap &) = delete;
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    contexts_.clear();
+  }
+
+  void Emplace(const NodePtr &node, const InferenceContextPtr &inference_context) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    (void)contexts_.emplace(node, inference_context);
+  }
+
+  bool Find(const NodePtr &node, InferenceContextPtr &inference_context) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto iter = contexts_.find(node);
+    if (iter == contexts_.end()) {
+      return false;
+    }
+    inference_context = iter->second;
+    return true;
+  }
+
+  void Swap(InferenceContextMap &other) {
+    std::lock(mutex_, other.mutex_);
+    std::lock_guard<std::mutex> lock(mutex_, std::adopt_lock);
+    std::lock_guard<std::mutex> other_lock(other.mutex_, std::adopt_lock);
+    contexts_.swap(other.contexts_);
+  }
+
+ private:
+  std::unordered_map<NodePtr, InferenceContextPtr> GetContexts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return contexts_;
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<NodePtr, InferenceContextPtr> contexts_;
+};
+
+thread_local InferenceContextMap context_map;
+thread_local InferenceContextMap *shared_context_map = nullptr;
+
+InferenceContextMap &GetContextMap() {
+  return (shared_context_map != nullptr) ? *shared_context_map : context_map;
+}
+
+// Below this size the cost of starting workers is larger than the inference itself
+const size_t kMinNodeNumForParallel = 256U;
+
+/// Groups nodes into levels, every node of a level depends only on nodes of earlier levels.
+/// A node of a subgraph also depends on the parent node, whose inference updates the subgraph data nodes.
+graphStatus BuildInferLevels(const std::vector<NodePtr> &nodes, std::vector<std::vector<size_t>> &levels) {
+  std::unordered_map<const Node *, size_t> node_indexes;
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    GE_CHECK_NOTNULL(nodes[i]);
+    node_indexes[nodes[i].get()] = i;
+  }
+  std::vector<size_t> pending_nums(nodes.size(), 0U);
+  std::vector<std::vector<size_t>> successors(nodes.size());
+  const auto add_dependency = [&node_indexes, &pending_nums, &successors](const NodePtr &from, size_t to) {
+    if (from == nullptr) {
+      return;
+    }
+    const auto iter = node_indexes.find(from.get());
+    if (iter != node_indexes.end()) {
+      successors[iter->second].emplace_back(to);
+      ++pending_nums[to];
+    }
+  };
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    for (const auto &in_node : nodes[i]->GetInAllNodes()) {
+      add_dependency(in_node, i);
+    }
+    const auto owner_graph = nodes[i]->GetOwnerComputeGraph();
+    if (owner_graph != nullptr) {
+      add_dependency(owner_graph->GetParentNode(), i);
+    }
+  }
+
+  std::vector<size_t> ready_nodes;
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    if (pending_nums[i] == 0U) {
+      ready_nodes.emplace_back(i);
+    }
+  }
+  size_t level_node_num = 0U;
+  while (!ready_nodes.empty()) {
+    level_node_num += ready_nodes.size();
+    levels.emplace_back(std::move(ready_nodes));
+    ready_nodes.clear();
+    for (const auto index : levels.back()) {
+      for (const auto successor : successors[index]) {
+        if (--pending_nums[successor] == 0U) {
+          ready_nodes.emplace_back(successor);
+        }
+      }
+    }
+    // keep the order of the node list inside a level
+    std::sort(ready_nodes.begin(), ready_nodes.end());
+  }
+  if (level_node_num != nodes.size()) {
+    REPORT_INNER_ERROR("E19999", "%zu of %zu nodes are in a cycle, check invalid.", nodes.size() - level_node_num,
+                       nodes.size());
+    GELOGE(GRAPH_FAILED, "[Check][Graph] %zu of %zu nodes are in a cycle.", nodes.size() - level_node_num,
+           nodes.size());
+    return GRAPH_FAILED;
+  }
+  return GRAPH_SUCCESS;
+}
+
+// An input desc differs from the output desc of its producer when the producer was re-inferred
+bool IsInputDescChanged(const NodePtr &node) {
+  const auto op_desc = node->GetOpDesc();
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    const auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    if ((peer_out_anchor == nullptr) || (peer_out_anchor->GetOwnerNode() == nullptr)) {
+      continue;
+    }
+    const auto peer_op_desc = peer_out_anchor->GetOwnerNode()->GetOpDesc();
+    if (peer_op_desc == nullptr) {
+      continue;
+    }
+    const auto in_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(in_anchor->GetIdx()));
+    const auto peer_out_desc = peer_op_desc->MutableOutputDesc(static_cast<uint32_t>(peer_out_anchor->GetIdx()));
+    if ((in_desc == nullptr) || (peer_out_desc == nullptr)) {
+      continue;
+    }
+    if ((in_desc->GetDataType() != peer_out_desc->GetDataType()) ||
+        (in_desc->GetShape().GetDims() != peer_out_desc->GetShape().GetDims()) ||
+        (in_desc->GetOriginShape().GetDims() != peer_out_desc->GetOriginShape().GetDims())) {
+      return true;
+    }
+    std::vector<std::pair<int64_t, int64_t>> in_range;
+    std::vector<std::pair<int64_t, int64_t>> peer_out_range;
+    (void)in_desc->GetShapeRange(in_range);
+    (void)peer_out_desc->GetShapeRange(peer_out_range);
+    if (in_range != peer_out_range) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Data nodes of the subgraphs of node, the inference of node refreshes their descs
+std::vector<NodePtr> GetSubgraphDataNodes(const NodePtr &node) {
+  std::vector<NodePtr> data_nodes;
+  const auto subgraph_num = node->GetOpDesc()->GetSubgraphInstanceNames().size();
+  for (size_t i = 0U; i < subgraph_num; ++i) {
+    const auto subgraph = NodeUtils::GetSubgraph(*node, static_cast<uint32_t>(i));
+    if (subgraph == nullptr) {
+      continue;
+    }
+    for (const auto &sub_node : subgraph->GetDirectNode()) {
+      if (sub_node->GetType() == DATA) {
+        data_nodes.emplace_back(sub_node);
+      }
+    }
+  }
+  return data_nodes;
+}
+
+/// Nodes reachable from changed_nodes in topological order, a subgraph belongs to the cone of its parent node
+graphStatus CollectAffectedCone(const std::vector<NodePtr> &changed_nodes, std::vector<NodePtr> &cone) {
+  std::unordered_map<const Node *, size_t> node_indexes;
+  std::vector<std::vector<size_t>> successors;
+  const auto add_node = [&node_indexes, &successors, &cone](const NodePtr &node) {
+    if (node_indexes.emplace(node.get(), cone.size()).second) {
+      cone.emplace_back(node);
+      successors.emplace_back();
+    }
+    return node_indexes[node.get()];
+  };
+  for (const auto &node : changed_nodes) {
+    GE_CHECK_NOTNULL(node);
+    GE_CHECK_NOTNULL(node->GetOpDesc());
+    (void)add_node(node);
+  }
+  std::vector<size_t> pending_nums;
+  for (size_t i = 0U; i < cone.size(); ++i) {
+    const auto node = cone[i];
+    std::vector<NodePtr> next_nodes = GetSubgraphDataNodes(node);
+    for (const auto &out_node : node->GetOutAllNodes()) {
+      next_nodes.emplace_back(out_node);
+    }
+    for (const auto &next_node : next_nodes) {
+      GE_CHECK_NOTNULL(next_node->GetOpDesc());
+      const size_t next_index = add_node(next_node);
+      successors[i].emplace_back(next_index);
+      pending_nums.resize(cone.size(), 0U);
+      ++pending_nums[next_index];
+    }
+  }
+  pending_nums.resize(cone.size(), 0U);
+
+  std::vector<NodePtr> sorted_cone;
+  std::vector<size_t> ready_nodes;
+  for (size_t i = 0U; i < cone.size(); ++i) {
+    if (pending_nums[i] == 0U) {
+      ready_nodes.emplace_back(i);
+    }
+  }
+  while (!ready_nodes.empty()) {
+    const size_t index = ready_nodes.back();
+    ready_nodes.pop_back();
+    sorted_cone.emplace_back(cone[index]);
+    for (auto successor = successors[index].rbegin(); successor != successors[index].rend(); ++successor) {
+      if (--pending_nums[*successor] == 0U) {
+        ready_nodes.emplace_back(*successor);
+      }
+    }
+  }
+  if (sorted_cone.size() != cone.size()) {
+    REPORT_INNER_ERROR("E19999", "%zu of %zu affected nodes are in a cycle, check invalid.",
+                       cone.size() - sorted_cone.size(), cone.size());
+    GELOGE(GRAPH_FAILED, "[Check][Graph] %zu of %zu affected nodes are in a cycle.", cone.size() - sorted_cone.size(),
+           cone.size());
+    return GRAPH_FAILED;
+  }
+  cone.swap(sorted_cone);
+  return GRAPH_SUCCESS;
+}
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
 void ShapeRefiner::ClearContextMap() {
-  context_map.clear();
+  GetContextMap().Clear();
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
 void ShapeRefiner::PushToContextMap(const NodePtr &node, const InferenceContextPtr &inference_context) {
-  (void)context_map.emplace(node, inference_context);
+  GetContextMap().Emplace(node, inference_context);
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY InferenceContextPtr ShapeRefiner::CreateInferenceContext(const NodePtr &node) {
@@ -588,9 +820,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY InferenceContextPtr ShapeRefiner:
       continue;
     }
 
-    auto iter = context_map.find(input_node);
-    if (iter != context_map.end()) {
-      const auto &src_context = iter->second;
+    InferenceContextPtr src_context;
+    if (GetContextMap().Find(input_node, src_context)) {
       GE_IF_BOOL_EXEC(src_context == nullptr, REPORT_INNER_ERROR("E19999", "src_context is null.");
           GELOGE(GRAPH_FAILED, "[Check][Param] src_context is null."); return nullptr);
       GELOGD("node:%s get %ld marks from node:%s",
@@ -740,8 +971,10 @@ graphStatus ShapeRefiner::InferShapeAndTypeForRunning(const NodePtr &node, bool
   for (auto &tensor_desc: opdesc->GetAllOutputsDescPtr()) {
       temp_dtype.emplace_back(tensor_desc->GetDataType());
   }
-  PrintInOutTensorShape(node, "before_infershape when running");
-  Operator op = OpDescUtils::CreateOperatorFromNode(node);
+  if (IsLogEnable(GE, DLOG_DEBUG)) {
+    PrintInOutTensorShape(node, "before_infershape when running");
+  }
+  Operator op = OpDescUtils::GetOperatorViewFromNode(node);
 
   graphStatus status = InferShapeAndTypeForRunning(node, op, before_subgraph);
   if (status == GRAPH_PARAM_INVALID || status == GRAPH_SUCCESS) {
@@ -759,7 +992,9 @@ graphStatus ShapeRefiner::InferShapeAndTypeForRunning(const NodePtr &node, bool
         all_output_tensor.at(i)->SetDataType(temp_dtype[i]);
       }
     }
-    PrintInOutTensorShape(node, "after_infershape when running");
+    if (IsLogEnable(GE, DLOG_DEBUG)) {
+      PrintInOutTensorShape(node, "after_infershape when running");
+    }
     return GRAPH_SUCCESS;
   } else {
     REPORT_CALL_ERROR("E19999", "%s(%s) call infer function failed.",
@@ -770,6 +1005,101 @@ graphStatus ShapeRefiner::InferShapeAndTypeForRunning(const NodePtr &node, bool
   }
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+std::unique_ptr<RuntimeInferPlan> RuntimeInferPlan::Build(const NodePtr &node, bool before_subgraph) {
+  if ((node == nullptr) || (node->GetOpDesc() == nullptr)) {
+    REPORT_INNER_ERROR("E19999", "param node or its opdesc is nullptr, check invalid");
+    GELOGE(GRAPH_FAILED, "[Check][Param] node or its opdesc is null.");
+    return nullptr;
+  }
+  std::unique_ptr<RuntimeInferPlan> plan(new (std::nothrow) RuntimeInferPlan());
+  if (plan == nullptr) {
+    REPORT_CALL_ERROR("E19999", "Alloc RuntimeInferPlan failed, node:%s.", node->GetName().c_str());
+    GELOGE(GRAPH_FAILED, "[Alloc][RuntimeInferPlan] failed, node:%s.", node->GetName().c_str());
+    return nullptr;
+  }
+  plan->node_ = node;
+  plan->op_desc_ = node->GetOpDesc();
+  plan->before_subgraph_ = before_subgraph;
+
+  // the infer func looked up from the factory at the first failed call of the old path is resolved here instead
+  const auto origin_type = NodeUtils::GetNodeType(*node);
+  plan->need_dummy_context_ = (kDummyContextOpTypes.count(origin_type) > 0);
+  if (plan->op_desc_->GetInferFunc() == nullptr) {
+    const auto it = kGeLocalOpMapping.find(origin_type);
+    auto infer_func = OperatorFactoryImpl::GetInferShapeFunc(it == kGeLocalOpMapping.end() ? origin_type : it->second);
+    if (infer_func == nullptr) {
+      REPORT_INNER_ERROR("E19999", "Failed to Get InferFunc. type is %s", origin_type.c_str());
+      GELOGE(GRAPH_FAILED, "[Get][InferFunc] failed. type is %s", origin_type.c_str());
+      return nullptr;
+    }
+    plan->op_desc_->AddInferFunc(infer_func);
+  }
+
+  plan->op_ = OpDescUtils::GetOperatorViewFromNode(node);
+  for (const auto &output_desc : plan->op_desc_->GetAllOutputsDescPtr()) {
+    GE_CHK_BOOL_EXEC(output_desc != nullptr, return nullptr, "[Check][Param] output desc of %s is null.",
+                     node->GetName().c_str());
+    plan->output_descs_.emplace_back(output_desc);
+  }
+  plan->output_dtypes_.resize(plan->output_descs_.size(), DT_UNDEFINED);
+  for (const auto &depend_name : plan->op_desc_->GetOpInferDepends()) {
+    const int index = plan->op_desc_->GetInputIndexByName(depend_name);
+    if (index < 0) {
+      GELOGW("[Build][RuntimeInferPlan] input %s of %s which infer depends on is not found.", depend_name.c_str(),
+             node->GetName().c_str());
+      continue;
+    }
+    plan->depend_input_indexes_.emplace_back(static_cast<uint32_t>(index));
+  }
+  GELOGD("Build runtime infer plan for node %s, output num %zu, depend input num %zu.", node->GetName().c_str(),
+         plan->output_descs_.size(), plan->depend_input_indexes_.size());
+  return plan;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+graphStatus RuntimeInferPlan::Run() {
+  for (size_t i = 0U; i < output_descs_.size(); ++i) {
+    output_dtypes_[i] = output_descs_[i]->GetDataType();
+  }
+  const bool is_debug_enable = IsLogEnable(GE, DLOG_DEBUG);
+  if (is_debug_enable) {
+    ShapeRefiner::PrintInOutTensorShape(node_, "before_infershape when running");
+  }
+
+  graphStatus ret = GRAPH_SUCCESS;
+  if (before_subgraph_) {
+    ret = UpdateSubGraphDataNodes(node_);
+  }
+  if (ret == GRAPH_SUCCESS) {
+    if (need_dummy_context_) {
+      op_.SetInferenceContext(std::shared_ptr<InferenceContext>(InferenceContext::Create()));
+    }
+    ret = op_desc_->CallInferFunc(op_);
+  }
+  if ((ret == GRAPH_SUCCESS) && !before_subgraph_) {
+    ret = UpdateParentNodeOutTensor(node_);
+  }
+  if ((ret != GRAPH_SUCCESS) && (ret != GRAPH_PARAM_INVALID)) {
+    REPORT_CALL_ERROR("E19999", "%s(%s) call infer function failed.",
+                      node_->GetName().c_str(), node_->GetType().c_str());
+    GELOGE(GRAPH_FAILED, "[Call][InferFunction] failed, node:%s(%s).",
+           node_->GetName().c_str(), node_->GetType().c_str());
+    return GRAPH_FAILED;
+  }
+
+  // ensure the dtype is not changed after infershape in running
+  for (size_t i = 0U; i < output_descs_.size(); ++i) {
+    if (output_descs_[i]->GetDataType() != output_dtypes_[i]) {
+      output_descs_[i]->SetDataType(output_dtypes_[i]);
+    }
+  }
+  if (is_debug_enable) {
+    ShapeRefiner::PrintInOutTensorShape(node_, "after_infershape when running");
+  }
+  return GRAPH_SUCCESS;
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
 graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_subgraph) {
   GE_IF_BOOL_EXEC(node == nullptr, REPORT_INNER_ERROR("E19999", "param node is nullptr, check invalid.");
@@ -795,7 +1125,7 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
     return GRAPH_FAILED;
   }
   PrintInOutTensorShape(node, "before_infershape");
-  Operator op = OpDescUtils::CreateOperatorFromNode(node);
+  Operator op = OpDescUtils::GetOperatorViewFromNode(node);
 
   if (!is_unknown_graph) {
     auto inference_context = CreateInferenceContext(node);
@@ -838,6 +1168,10 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
       (void)input_tensor->GetShapeRange(range);
       input_tensor->SetOriginShapeRange(range);
     }
+    // symbolic dims ride along with the numeric shape, losing them never fails the inference
+    if (SymbolicShapeUtils::InferSymbolicShape(node) != GRAPH_SUCCESS) {
+      GELOGW("[Infer][SymbolicShape] node %s failed, keep the numeric shape only.", node->GetName().c_str());
+    }
   } else {
     REPORT_CALL_ERROR("E19999", "%s(%s) call infer function failed.",
                       node->GetName().c_str(), node->GetType().c_str());
@@ -852,7 +1186,7 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
       if (!ctx_after_infer->GetOutputHandleShapesAndTypes().empty() || !ctx_after_infer->GetMarks().empty()) {
         GELOGD("[%s] set inference context after. mark:%zu", node->GetName().c_str(),
                ctx_after_infer->GetMarks().size());
-        (void)context_map.emplace(node, ctx_after_infer);
+        GetContextMap().Emplace(node, ctx_after_infer);
       }
     }
   }
@@ -860,4 +1194,98 @@ graphStatus ShapeRefiner::InferShapeAndType(const NodePtr &node, bool before_sub
 
   return GRAPH_SUCCESS;
 }
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+graphStatus ShapeRefiner::InferShapeAndTypeParallel(const ComputeGraphPtr &graph, uint32_t parallel_num) {
+  GE_CHECK_NOTNULL(graph);
+  std::vector<NodePtr> nodes;
+  for (const auto &node : graph->GetAllNodes()) {
+    nodes.emplace_back(node);
+  }
+  std::vector<std::vector<size_t>> levels;
+  if (BuildInferLevels(nodes, levels) != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "[Build][InferLevels] failed, graph:%s.", graph->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+
+  std::unique_ptr<GraphThreadPool> pool;
+  if ((parallel_num > 1U) && (nodes.size() >= kMinNodeNumForParallel)) {
+    pool.reset(new (std::nothrow) GraphThreadPool(parallel_num - 1U));
+  }
+  // workers see the contexts pushed by the caller before, and the caller sees theirs afterwards
+  InferenceContextMap contexts(GetContextMap());
+  const auto caller_context = GetThreadLocalContext();
+  std::vector<graphStatus> results(nodes.size(), GRAPH_SUCCESS);
+  const auto infer_nodes = [&nodes, &results, &contexts, &caller_context](const std::vector<size_t> &level,
+                                                                           size_t begin, size_t end) {
+    GetThreadLocalContext() = caller_context;
+    InferenceContextMap *const origin_context_map = shared_context_map;
+    shared_context_map = &contexts;
+    for (size_t i = begin; i < end; ++i) {
+      results[level[i]] = InferShapeAndType(nodes[level[i]], true);
+    }
+    shared_context_map = origin_context_map;
+  };
+
+  graphStatus ret = GRAPH_SUCCESS;
+  for (const auto &level : levels) {
+    if ((pool != nullptr) && (level.size() > 1U)) {
+      pool->ParallelFor(level.size(), [&infer_nodes, &level](size_t begin, size_t end) {
+        infer_nodes(level, begin, end);
+      });
+    } else {
+      infer_nodes(level, 0U, level.size());
+    }
+    // report the failure the serial inference would have met first
+    const auto failed_iter = std::find_if(level.begin(), level.end(),
+                                          [&results](size_t index) { return results[index] != GRAPH_SUCCESS; });
+    if (failed_iter != level.end()) {
+      ret = results[*failed_iter];
+      GELOGE(ret, "[Infer][Shape] failed, node:%s, graph:%s.", nodes[*failed_iter]->GetName().c_str(),
+             graph->GetName().c_str());
+      break;
+    }
+  }
+  GetContextMap().Swap(contexts);
+  return ret;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY
+graphStatus ShapeRefiner::ReInferShapeAndType(const std::vector<NodePtr> &changed_nodes, size_t &infer_num) {
+  infer_num = 0U;
+  std::vector<NodePtr> cone;
+  if (CollectAffectedCone(changed_nodes, cone) != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "[Collect][AffectedNodes] failed.");
+    return GRAPH_FAILED;
+  }
+  std::unordered_set<const Node *> dirty_nodes;
+  for (const auto &node : changed_nodes) {
+    (void)dirty_nodes.insert(node.get());
+  }
+  for (const auto &node : cone) {
+    // nodes whose inputs are unchanged keep their outputs, so their consumers are not dirtied through them
+    if ((dirty_nodes.count(node.get()) == 0U) && !IsInputDescChanged(node)) {
+      continue;
+    }
+    if (node->GetOwnerComputeGraph()->GetGraphUnknownFlag()) {
+      // InferShapeAndType refreshes the input descs of known graphs only
+      const auto ret = UpdateOpInputDesc(node);
+      if (ret != GRAPH_SUCCESS) {
+        GELOGE(ret, "[Update][OpInputDesc] failed, node:%s.", node->GetName().c_str());
+        return ret;
+      }
+    }
+    const auto ret = InferShapeAndType(node, true);
+    if (ret != GRAPH_SUCCESS) {
+      GELOGE(ret, "[Infer][Shape] failed, node:%s.", node->GetName().c_str());
+      return ret;
+    }
+    ++infer_num;
+    for (const auto &data_node : GetSubgraphDataNodes(node)) {
+      (void)dirty_nodes.insert(data_node.get());
+    }
+  }
+  GELOGI("Re-infer %zu of %zu affected nodes, %zu nodes changed.", infer_num, cone.size(), changed_nodes.size());
+  return GRAPH_SUCCESS;
+}
 }  // namespace ge
@@ -0,0 +1,183 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ge_async_graph_dumper.h"
+
+#include "debug/ge_log.h"
+#include "debug/ge_util.h"
+#include "graph/model.h"
+#include "graph/model_serialize.h"
+#include "graph/utils/graph_binary_file.h"
+#include "graph/utils/graph_utils.h"
+#include "proto/ge_ir.pb.h"
+#include "utils/ge_ir_utils.h"
+
+namespace ge {
+AsyncGraphDumper::AsyncGraphDumper(const AsyncGraphDumperOptions &options) : options_(options) {
+  writer_ = std::thread(&AsyncGraphDumper::WriterLoop, this);
+}
+
+AsyncGraphDumper::~AsyncGraphDumper() {
+  GraphDumperRegistry::Unregister(*this);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  task_cond_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+bool AsyncGraphDumper::IsSampled(const std::string &suffix) {
+  std::string stage;
+  uint32_t interval = options_.default_sample_interval;
+  for (const auto &stage_interval : options_.stage_sample_intervals) {
+    // the longest matched stage wins, so "PreRunAfterBuild" is not shadowed by "PreRun"
+    if ((suffix.find(stage_interval.first) != std::string::npos) && (stage_interval.first.size() >= stage.size())) {
+      stage = stage_interval.first;
+      interval = stage_interval.second;
+    }
+  }
+  if (interval == 0U) {
+    return false;
+  }
+  // dumps without a configured stage are counted by suffix
+  const uint64_t count = stage_counters_[stage.empty() ? suffix : stage]++;
+  return (count % interval) == 0U;
+}
+
+bool AsyncGraphDumper::DumpToFile(const ComputeGraph &graph, const std::string &suffix, const std::string &file_path,
+                                  GraphDumpFormat format, bool is_dump_all) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!IsSampled(suffix)) {
+      ++sampled_out_num_;
+      GELOGD("Skip dumping %s of stage %s by sample interval.", file_path.c_str(), suffix.c_str());
+      return true;
+    }
+    if ((pending_tasks_.size() + snapshotting_num_) >= options_.max_pending_num) {
+      ++dropped_num_;
+      GELOGW("[Dump][Graph] Pending dump num reaches %zu, drop %s.", options_.max_pending_num, file_path.c_str());
+      return true;
+    }
+    // keeps the slot while the snapshot is taken outside the lock
+    ++snapshotting_num_;
+  }
+
+  // The binary snapshot is the only work left on the compile thread
+  DumpTask task;
+  const auto compute_graph = ComGraphMakeShared<ComputeGraph>(graph);
+  if (compute_graph != nullptr) {
+    Model model((format == GraphDumpFormat::kOnnxText) ? "GE" : "", "");
+    model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(compute_graph));
+    ModelSerialize serialize;
+    task.snapshot = serialize.SerializeModel(model, !is_dump_all, options_.snapshot_parallel_num);
+  }
+  task.file_path = file_path;
+  task.format = format;
+  task.context = GetThreadLocalContext();
+  const bool is_valid_snapshot = (task.snapshot.GetSize() != 0U);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --snapshotting_num_;
+    if (is_valid_snapshot) {
+      pending_tasks_.emplace_back(std::move(task));
+    }
+  }
+  if (!is_valid_snapshot) {
+    idle_cond_.notify_all();
+    GELOGE(GRAPH_FAILED, "[Serialize][Model] Snapshot of graph %s failed.", graph.GetName().c_str());
+    return true;
+  }
+  task_cond_.notify_one();
+  return true;
+}
+
+void AsyncGraphDumper::WriterLoop() {
+  while (true) {
+    DumpTask task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cond_.wait(lock, [this]() { return is_stopped_ || !pending_tasks_.empty(); });
+      if (pending_tasks_.empty()) {
+        return;
+      }
+      task = std::move(pending_tasks_.front());
+      pending_tasks_.pop_front();
+      is_writing_ = true;
+    }
+    WriteDumpFile(task);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_writing_ = false;
+      ++processed_num_;
+    }
+    idle_cond_.notify_all();
+  }
+}
+
+void AsyncGraphDumper::WriteDumpFile(const DumpTask &task) const {
+  // options such as ge.maxDumpFileSize are read from the thread local context of the dumping thread
+  GetThreadLocalContext() = task.context;
+  if (task.format != GraphDumpFormat::kOnnxText) {
+    proto::ModelDef ge_proto;
+    if (!ge_proto.ParseFromArray(task.snapshot.GetData(), static_cast<int>(task.snapshot.GetSize()))) {
+      GELOGE(GRAPH_FAILED, "[Invoke][Parse] parse snapshot of %s failed.", task.file_path.c_str());
+      return;
+    }
+    if (task.format == GraphDumpFormat::kGeIrBinary) {
+      (void)GraphBinaryFile::Write(ge_proto, task.file_path.c_str(), true);
+    } else {
+      GraphUtils::WriteProtoToTextFile(ge_proto, task.file_path.c_str());
+    }
+    return;
+  }
+
+  Model model;
+  if (Model::Load(task.snapshot.GetData(), task.snapshot.GetSize(), model) != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "[Load][Model] load snapshot of %s failed.", task.file_path.c_str());
+    return;
+  }
+  onnx::ModelProto model_proto;
+  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
+    GELOGE(GRAPH_FAILED, "[Convert][GeModel] DumpGEGraphToOnnx failed, file:%s.", task.file_path.c_str());
+    return;
+  }
+  GraphUtils::WriteProtoToTextFile(model_proto, task.file_path.c_str());
+}
+
+void AsyncGraphDumper::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cond_.wait(lock, [this]() { return pending_tasks_.empty() && (snapshotting_num_ == 0U) && !is_writing_; });
+}
+
+uint64_t AsyncGraphDumper::GetProcessedNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return processed_num_;
+}
+
+uint64_t AsyncGraphDumper::GetDroppedNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_num_;
+}
+
+uint64_t AsyncGraphDumper::GetSampledOutNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sampled_out_num_;
+}
+}  // namespace ge
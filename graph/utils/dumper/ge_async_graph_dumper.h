@@ -0,0 +1,97 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INC_5B0C5E8C1D3C4F6AA4D8E1F0B2C7A9D3
+#define INC_5B0C5E8C1D3C4F6AA4D8E1F0B2C7A9D3
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "graph/buffer.h"
+#include "graph/ge_local_context.h"
+#include "graph/utils/dumper/ge_graph_dumper.h"
+
+namespace ge {
+struct AsyncGraphDumperOptions {
+  // Snapshots waiting for the writer thread, new dumps are dropped instead of blocking compilation when full
+  size_t max_pending_num = 8U;
+  // Dump one of every N dumps of a stage, 0 turns the stage off
+  uint32_t default_sample_interval = 1U;
+  // Interval per stage, a stage matches a dump when the dump suffix contains it
+  std::map<std::string, uint32_t> stage_sample_intervals;
+  // Threads used to serialize the snapshot on the compile thread
+  uint32_t snapshot_parallel_num = 1U;
+};
+
+/// Dumps graphs from a background thread.
+/// Usage:
+///   AsyncGraphDumper dumper(options);
+///   GraphDumperRegistry::Register(dumper);
+///   ...GE_DUMP(graph, "stage")...
+///   GraphDumperRegistry::Unregister(dumper);
+/// The compile thread only serializes the graph to a binary snapshot, text formatting, onnx conversion
+/// and file writing are done by the writer thread.
+class AsyncGraphDumper : public GeGraphDumper {
+ public:
+  explicit AsyncGraphDumper(const AsyncGraphDumperOptions &options);
+  ~AsyncGraphDumper() override;
+
+  AsyncGraphDumper(const AsyncGraphDumper &) = delete;
+  AsyncGraphDumper &operator=(const AsyncGraphDumper &) = delete;
+
+  bool DumpToFile(const ComputeGraph &graph, const std::string &suffix, const std::string &file_path,
+                  GraphDumpFormat format, bool is_dump_all) override;
+
+  // Blocks until the writer thread has handled every accepted dump
+  void Flush();
+
+  uint64_t GetProcessedNum() const;
+  uint64_t GetDroppedNum() const;
+  uint64_t GetSampledOutNum() const;
+
+ private:
+  struct DumpTask {
+    Buffer snapshot;
+    std::string file_path;
+    GraphDumpFormat format = GraphDumpFormat::kGeIrText;
+    GEThreadLocalContext context;
+  };
+
+  bool IsSampled(const std::string &suffix);
+  void WriterLoop();
+  void WriteDumpFile(const DumpTask &task) const;
+
+  AsyncGraphDumperOptions options_;
+  std::map<std::string, uint64_t> stage_counters_;
+  std::deque<DumpTask> pending_tasks_;
+  size_t snapshotting_num_ = 0U;
+  mutable std::mutex mutex_;
+  std::condition_variable task_cond_;
+  std::condition_variable idle_cond_;
+  bool is_writing_ = false;
+  bool is_stopped_ = false;
+  uint64_t processed_num_ = 0U;
+  uint64_t dropped_num_ = 0U;
+  uint64_t sampled_out_num_ = 0U;
+  std::thread writer_;
+};
+}  // namespace ge
+
+#endif  // INC_5B0C5E8C1D3C4F6AA4D8E1F0B2C7A9D3
@@ -31,4 +31,10 @@ void GraphDumperRegistry::Register(GeGraphDumper &dumper) {
   register_checker = &dumper;
 }
 
+void GraphDumperRegistry::Unregister(const GeGraphDumper &dumper) {
+  if (register_checker == &dumper) {
+    register_checker = &default_dumper;
+  }
+}
+
 }  // namespace ge
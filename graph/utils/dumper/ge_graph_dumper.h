@@ -20,14 +20,28 @@
 #include "graph/compute_graph.h"
 
 namespace ge {
+enum class GraphDumpFormat {
+  kGeIrText,    // ge_proto_*.txt written by GraphUtils::DumpGEGraph
+  kGeIrBinary,  // ge_proto_*.bin written by GraphUtils::DumpGEGraph when DUMP_GRAPH_FORMAT is "bin"
+  kOnnxText     // ge_onnx_*.pbtxt written by GraphUtils::DumpGEGraphToOnnx
+};
+
 struct GeGraphDumper {
   virtual void Dump(const ge::ComputeGraphPtr &graph, const std::string &suffix){}
+  // Called once GraphUtils has decided to write file_path for graph. Returning true means the dumper
+  // takes care of the file (or drops it on purpose), false lets GraphUtils write it on the calling thread.
+  virtual bool DumpToFile(const ge::ComputeGraph &graph, const std::string &suffix, const std::string &file_path,
+                          GraphDumpFormat format, bool is_dump_all) {
+    return false;
+  }
   virtual ~GeGraphDumper() {}
 };
 
 struct GraphDumperRegistry {
   static GeGraphDumper &GetDumper();
   static void Register(GeGraphDumper &);
+  // Restores the default dumper if dumper is the registered one
+  static void Unregister(const GeGraphDumper &dumper);
 };
 
 }  // namespace ge
@@ -16,11 +16,13 @@
  */
 
 #include "graph/utils/ge_ir_utils.h"
+#include <algorithm>
 #include <utility>
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_tensor_impl.h"
 #include "graph/node_impl.h"
 #include "graph/op_desc_impl.h"
+#include "graph/utils/thread_pool.h"
 #include "mmpa/mmpa_api.h"
 
 namespace {
@@ -37,7 +39,26 @@ const int64_t kDumpLevel =
     std::strtol(kDumpGeGraph, nullptr, kBase) : ge::OnnxUtils::NO_DUMP;
 const int64_t kInputPrefixLength = 5;
 const int64_t kOutputPrefixLength = 6;
+const size_t kMinNodeNumForParallel = 256U;
 using AttrDefPair = ::google::protobuf::MapPair<std::string, ge::proto::AttrDef>;
+
+void AppendTo(std::string &str) {
+  (void)str;
+}
+
+template <typename T, typename... Args>
+void AppendTo(std::string &str, const T &part, const Args &... parts) {
+  (void)str.append(part);
+  AppendTo(str, parts...);
+}
+
+// Builds an attribute name in the scratch buffer, set_name copies it so the buffer can be reused right away
+template <typename... Args>
+const std::string &MakeAttrName(std::string &scratch, const Args &... parts) {
+  scratch.clear();
+  AppendTo(scratch, parts...);
+  return scratch;
+}
 }  // namespace
 
 namespace ge {
@@ -54,8 +75,8 @@ const std::map<ge::DataType, onnx::TensorProto_DataType> kGeDataTypeToOnnxMap =
 }
 
 struct AttrNameComp {
-  inline bool operator()(const onnx::AttributeProto &lsh, const onnx::AttributeProto &rsh) {
-    return lsh.name() < rsh.name();
+  inline bool operator()(const onnx::AttributeProto *lsh, const onnx::AttributeProto *rsh) {
+    return lsh->name() < rsh->name();
   }
 };
 
@@ -82,9 +103,8 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
     GELOGE(GRAPH_FAILED, "[Check][Param] attr is nullptr.");
     return;
   }
-  auto attr_name = string_attr_value.first;
-  attr->set_name(attr_name);
-  auto attr_value = string_attr_value.second;
+  attr->set_name(string_attr_value.first);
+  const auto &attr_value = string_attr_value.second;
   auto value_type = attr_value.GetValueType();
   switch (value_type) {
     case GeAttrValue::VT_FLOAT: {
@@ -98,6 +118,7 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
       GeAttrValue::LIST_FLOAT data_fs = {};
       (void)attr_value.GetValue(data_fs);
       attr->set_type(onnx::AttributeProto_AttributeType_FLOATS);
+      attr->mutable_floats()->Reserve(static_cast<int>(data_fs.size()));
       for (auto &v : data_fs) {
         attr->add_floats(v);
       }
@@ -114,6 +135,7 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
       GeAttrValue::LIST_INT data_is = {};
       (void)attr_value.GetValue(data_is);
       attr->set_type(onnx::AttributeProto_AttributeType_INTS);
+      attr->mutable_ints()->Reserve(static_cast<int>(data_is.size()));
       for (auto &v : data_is) {
         attr->add_ints(v);
       }
@@ -123,15 +145,16 @@ void OnnxUtils::AddAttrProtoFromAttribute(const std::pair<const std::string, ge:
       GeAttrValue::STR data_s;
       (void)attr_value.GetValue(data_s);
       attr->set_type(onnx::AttributeProto_AttributeType_STRING);
-      attr->set_s(data_s);
+      attr->set_s(std::move(data_s));
       break;
     }
     case GeAttrValue::VT_LIST_STRING: {
       GeAttrValue::LIST_STR data_ss = {};
       (void)attr_value.GetValue(data_ss);
       attr->set_type(onnx::AttributeProto_AttributeType_STRINGS);
+      attr->mutable_strings()->Reserve(static_cast<int>(data_ss.size()));
       for (auto &v : data_ss) {
-        attr->add_strings(v);
+        attr->add_strings(std::move(v));
       }
       break;
     }
@@ -163,6 +186,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 
     case onnx::AttributeProto_AttributeType_FLOATS:
       attr->set_type(onnx::AttributeProto_AttributeType_FLOATS);
+      attr->mutable_floats()->Reserve(static_cast<int>(static_cast<std::vector<float> *>(data)->size()));
       for (auto &v : (*(static_cast<std::vector<float> *>(data)))) {
         attr->add_floats(v);
       }
@@ -175,6 +199,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 
     case onnx::AttributeProto_AttributeType_INTS:
       attr->set_type(onnx::AttributeProto_AttributeType_INTS);
+      attr->mutable_ints()->Reserve(static_cast<int>(static_cast<std::vector<int64_t> *>(data)->size()));
       for (auto &v : *(static_cast<std::vector<int64_t> *>(data))) {
         attr->add_ints(v);
       }
@@ -199,7 +224,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<::google::protobuf::int64> data) {
+                             const ::google::protobuf::RepeatedField<::google::protobuf::int64> &data) {
   if (node_proto == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node_proto is nullptr.");
     GELOGE(FAILED, "[Check][Param] Node_proto is nullptr.");
@@ -213,15 +238,13 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
       return;
     }
     attr->set_name(name);
-    for (auto &v : data) {
-      attr->add_ints(v);
-    }
+    *attr->mutable_ints() = data;
     attr->set_type(type);
   }
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<bool> data) {
+                             const ::google::protobuf::RepeatedField<bool> &data) {
   if (node_proto == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node_proto is nullptr.");
     GELOGE(FAILED, "[Check][Param] Node proto is nullptr.");
@@ -235,6 +258,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
       return;
     }
     attr->set_name(name);
+    attr->mutable_ints()->Reserve(data.size());
     for (auto &v : data) {
       attr->add_ints(static_cast<int64_t>(v));
     }
@@ -243,7 +267,7 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedField<float> data) {
+                             const ::google::protobuf::RepeatedField<float> &data) {
   if (node_proto == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node_proto is nullptr.");
     GELOGE(FAILED, "[Check][Param] Node_proto is nullptr.");
@@ -257,15 +281,13 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
       return;
     }
     attr->set_name(name);
-    for (auto &v : data) {
-      attr->add_floats(v);
-    }
+    *attr->mutable_floats() = data;
     attr->set_type(type);
   }
 }
 
 void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_AttributeType type, const string &name,
-                             ::google::protobuf::RepeatedPtrField<::std::string> data) {
+                             const ::google::protobuf::RepeatedPtrField<::std::string> &data) {
   if (node_proto == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node_proto is nullptr.");
     GELOGE(FAILED, "[Check][Param] Node proto is nullptr.");
@@ -279,41 +301,42 @@ void OnnxUtils::AddAttrProto(onnx::NodeProto *node_proto, onnx::AttributeProto_A
       return;
     }
     attr->set_name(name);
-    for (auto &v : data) {
-      attr->add_strings(v);
-    }
+    *attr->mutable_strings() = data;
     attr->set_type(type);
   }
 }
 
-void OnnxUtils::AddAttrProtoForOpInDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc) {
-  auto size_in = op_desc->GetAllInputsSize();
+void OnnxUtils::AddAttrProtoForOpInDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc,
+                                        EncodeContext &context) {
+  auto size_in = static_cast<int64_t>(op_desc->GetAllInputsSize());
   AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, "input_desc_nums", &size_in);
+  std::string &name = context.attr_name;
   if (size_in > 0) {
-    for (uint32_t i = 0; i < size_in; i++) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(size_in); i++) {
       auto input_desc = op_desc->GetInputDescPtrDfault(i);
       if (input_desc == nullptr || input_desc->impl_ == nullptr) {
         GELOGW("[Add][InAttr] Input desc of input %u is nullptr", i);
         continue;
       }
+      const std::string index = std::to_string(i);
       auto data_type = TypeUtils::DataTypeToSerialString(input_desc->GetDataType());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_dtype:" + std::to_string(i), &data_type);
+                   MakeAttrName(name, "input_desc_dtype:", index), &data_type);
       auto data_type_origin = TypeUtils::DataTypeToSerialString(input_desc->GetOriginDataType());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_origin_dtype:" + std::to_string(i), &data_type_origin);
+                   MakeAttrName(name, "input_desc_origin_dtype:", index), &data_type_origin);
       auto dims = input_desc->GetShape().GetDims();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                   "input_desc_shape:" + std::to_string(i), &dims);
+                   MakeAttrName(name, "input_desc_shape:", index), &dims);
       auto dims_origin = input_desc->GetOriginShape().GetDims();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                   "input_desc_origin_shape:" + std::to_string(i), &dims_origin);
+                   MakeAttrName(name, "input_desc_origin_shape:", index), &dims_origin);
       auto layout = TypeUtils::FormatToSerialString(input_desc->GetFormat());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_layout:" + std::to_string(i), &layout);
+                   MakeAttrName(name, "input_desc_layout:", index), &layout);
       auto layout_origin = TypeUtils::FormatToSerialString(input_desc->GetOriginFormat());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_origin_layout:" + std::to_string(i), &layout_origin);
+                   MakeAttrName(name, "input_desc_origin_layout:", index), &layout_origin);
       auto tensor_descriptor = input_desc->impl_->tensor_descriptor_.GetProtoMsg();
       if (tensor_descriptor == nullptr) {
         GELOGW("[Add][InAttr] Tensor descriptor of input %u is nullptr", i);
@@ -321,155 +344,166 @@ void OnnxUtils::AddAttrProtoForOpInDesc(onnx::NodeProto *node_proto, const OpDes
       }
       auto size = tensor_descriptor->size();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_size:" + std::to_string(i), &size);
+                   MakeAttrName(name, "input_desc_size:", index), &size);
       auto weight_size = tensor_descriptor->weight_size();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_weight_size:" + std::to_string(i), &weight_size);
+                   MakeAttrName(name, "input_desc_weight_size:", index), &weight_size);
       auto reuse_input = tensor_descriptor->reuse_input();
       auto reuse_input_int = static_cast<int64_t>(reuse_input);
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_reuse_input:" + std::to_string(i), &reuse_input_int);
+                   MakeAttrName(name, "input_desc_reuse_input:", index), &reuse_input_int);
       auto output_tensor = tensor_descriptor->output_tensor();
       auto output_tensor_int = static_cast<int64_t>(output_tensor);
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_output_tensor:" + std::to_string(i), &output_tensor_int);
+                   MakeAttrName(name, "input_desc_output_tensor:", index), &output_tensor_int);
       auto device_type = tensor_descriptor->device_type();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_device_type:" + std::to_string(i), &device_type);
+                   MakeAttrName(name, "input_desc_device_type:", index), &device_type);
       auto input_tensor = tensor_descriptor->input_tensor();
       auto input_tensor_int = static_cast<int64_t>(input_tensor);
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_input_tensor:" + std::to_string(i), &input_tensor_int);
+                   MakeAttrName(name, "input_desc_input_tensor:", index), &input_tensor_int);
       auto real_dim_cnt = tensor_descriptor->real_dim_cnt();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_real_dim_cnt:" + std::to_string(i), &real_dim_cnt);
+                   MakeAttrName(name, "input_desc_real_dim_cnt:", index), &real_dim_cnt);
       auto data_offset = tensor_descriptor->data_offset();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_data_offset:" + std::to_string(i), &data_offset);
+                   MakeAttrName(name, "input_desc_data_offset:", index), &data_offset);
       auto cmps_size = tensor_descriptor->cmps_size();
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, "input_desc_cmps_size:" + std::to_string(i),
-                   &cmps_size);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
+                   MakeAttrName(name, "input_desc_cmps_size:", index), &cmps_size);
       auto cmps_tab = tensor_descriptor->cmps_tab();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "input_desc_cmps_tab:" + std::to_string(i), &cmps_tab);
+                   MakeAttrName(name, "input_desc_cmps_tab:", index), &cmps_tab);
       auto cmps_tab_offset = tensor_descriptor->cmps_tab_offset();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "input_desc_cmps_tab_offset:" + std::to_string(i), &cmps_tab_offset);
+                   MakeAttrName(name, "input_desc_cmps_tab_offset:", index), &cmps_tab_offset);
       const auto &tensor_desc_map = tensor_descriptor->attr();
-      std::string suffix = ":" + std::to_string(i);
-      AddAttrProtoForAttrsFromAttrMap(tensor_desc_map, node_proto, kPrefixForInputDesc, suffix);
+      std::string suffix = ":" + index;
+      AddAttrProtoForAttrsFromAttrMap(tensor_desc_map, node_proto, context, kPrefixForInputDesc, suffix);
     }
   }
 }
 
-void OnnxUtils::AddAttrProtoForOpOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc) {
+void OnnxUtils::AddAttrProtoForOpOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc,
+                                         EncodeContext &context) {
   // Output describes
-  auto size_out = op_desc->GetOutputsSize();
+  auto size_out = static_cast<int64_t>(op_desc->GetOutputsSize());
   AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, "output_desc_nums", &size_out);
+  std::string &name = context.attr_name;
   if (size_out > 0) {
-    for (uint32_t i = 0; i < size_out; i++) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(size_out); i++) {
       auto output_desc = op_desc->GetOutputDescPtr(i);
       if (output_desc == nullptr || output_desc->impl_ == nullptr) {
         GELOGW("[Add][OutAttr] Output desc of output %u is nullptr", i);
         continue;
       }
+      const std::string index = std::to_string(i);
       auto data_type = TypeUtils::DataTypeToSerialString(output_desc->GetDataType());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "output_desc_dtype:" + std::to_string(i), &data_type);
+                   MakeAttrName(name, "output_desc_dtype:", index), &data_type);
       auto origin_data_type = TypeUtils::DataTypeToSerialString(output_desc->GetOriginDataType());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "output_desc_origin_dtype:" + std::to_string(i), &origin_data_type);
+                   MakeAttrName(name, "output_desc_origin_dtype:", index), &origin_data_type);
       auto dims = output_desc->GetShape().GetDims();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                   "output_desc_shape:" + std::to_string(i), &dims);
+                   MakeAttrName(name, "output_desc_shape:", index), &dims);
       auto dims_origin = output_desc->GetOriginShape().GetDims();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                   "output_desc_origin_shape:" + std::to_string(i), &dims_origin);
+                   MakeAttrName(name, "output_desc_origin_shape:", index), &dims_origin);
       auto layout = TypeUtils::FormatToSerialString(output_desc->GetFormat());
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, "output_desc_layout:" + std::to_string(i),
-                   &layout);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
+                   MakeAttrName(name, "output_desc_layout:", index), &layout);
       auto layout_origin = TypeUtils::FormatToSerialString(output_desc->GetOriginFormat());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "output_desc_origin_layout:" + std::to_string(i), &layout_origin);
+                   MakeAttrName(name, "output_desc_origin_layout:", index), &layout_origin);
       auto tensor_descriptor = output_desc->impl_->tensor_descriptor_.GetProtoMsg();
       if (tensor_descriptor == nullptr) {
         GELOGW("[Add][OutAttr] Tensor descriptor of output %u is nullptr", i);
         continue;
       }
       auto size = tensor_descriptor->size();
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, "output_desc_size:" + std::to_string(i),
-                   &size);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
+                   MakeAttrName(name, "output_desc_size:", index), &size);
       auto weight_size = tensor_descriptor->weight_size();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "output_desc_weight_size:" + std::to_string(i), &weight_size);
+                   MakeAttrName(name, "output_desc_weight_size:", index), &weight_size);
       auto device_type = tensor_descriptor->device_type();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   "output_desc_device_type:" + std::to_string(i), &device_type);
+                   MakeAttrName(name, "output_desc_device_type:", index), &device_type);
       auto real_dim_cnt = tensor_descriptor->real_dim_cnt();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
-                   "output_desc_real_dim_cnt:" + std::to_string(i), &real_dim_cnt);
+                   MakeAttrName(name, "output_desc_real_dim_cnt:", index), &real_dim_cnt);
       const auto &tensor_desc_map = tensor_descriptor->attr();
-      std::string suffix = ":" + std::to_string(i);
-      AddAttrProtoForAttrsFromAttrMap(tensor_desc_map, node_proto, kPrefixForOutputDesc, suffix);
+      std::string suffix = ":" + index;
+      AddAttrProtoForAttrsFromAttrMap(tensor_desc_map, node_proto, context, kPrefixForOutputDesc, suffix);
     }
   }
 }
 
-void OnnxUtils::AddAttrProtoForOpInAndOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc) {
+void OnnxUtils::AddAttrProtoForOpInAndOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc,
+                                              EncodeContext &context) {
   if (node_proto == nullptr || op_desc == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node_proto or op_desc is nullptr");
     GELOGE(GRAPH_FAILED, "[Check][Param] node_proto or op_desc is nullptr");
     return;
   }
-  AddAttrProtoForOpInDesc(node_proto, op_desc);
-  AddAttrProtoForOpOutDesc(node_proto, op_desc);
+  AddAttrProtoForOpInDesc(node_proto, op_desc, context);
+  AddAttrProtoForOpOutDesc(node_proto, op_desc, context);
 }
 
 void OnnxUtils::AddAttrProtoForAttrsFromAttrMap(
     const ::google::protobuf::Map<std::string, ::ge::proto::AttrDef> &attr_map, onnx::NodeProto *node_proto,
-    const std::string& prefix, const std::string& suffix) {
+    EncodeContext &context, const std::string& prefix, const std::string& suffix) {
+  std::string &name = context.attr_name;
   for (const auto &item : attr_map) {
-    auto attr_name = item.first;
-    auto attr_def = item.second;
+    const auto &attr_name = item.first;
+    const auto &attr_def = item.second;
     auto attr_type = attr_def.value_case();
     if (attr_type == ge::proto::AttrDef::kT) {
       const auto &tensor_def = attr_def.t();
       const auto &tensor_desc = tensor_def.desc();
       auto data_type = ge::proto::DataType_Name(tensor_desc.dtype());
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   prefix + attr_name + "_desc_dtype" + suffix, &data_type);
-      auto dims = tensor_desc.shape().dim();
+                   MakeAttrName(name, prefix, attr_name, "_desc_dtype", suffix), &data_type);
+      const auto &dims = tensor_desc.shape().dim();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
-                   prefix + attr_name + "_desc_shape" + suffix, dims);
+                   MakeAttrName(name, prefix, attr_name, "_desc_shape", suffix), dims);
       auto layout = tensor_desc.layout();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                   prefix + attr_name + "_desc_layout" + suffix, &layout);
+                   MakeAttrName(name, prefix, attr_name, "_desc_layout", suffix), &layout);
       auto device_type = tensor_desc.device_type();
       AddAttrProto(node_proto, ge::onnx::AttributeProto_AttributeType_STRING,
-                   prefix + attr_name + "_desc_device_type" + suffix, &device_type);
-      if (kDumpLevel == DUMP_ALL) {
-        auto data = tensor_def.data();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
-                     prefix + attr_name + "_data" + suffix, &data);
+                   MakeAttrName(name, prefix, attr_name, "_desc_device_type", suffix), &device_type);
+      if (context.is_dump_weight_data) {
+        // weights are copied straight from the tensor, they can be far bigger than the rest of the graph
+        auto attr = node_proto->add_attribute();
+        attr->set_name(MakeAttrName(name, prefix, attr_name, "_data", suffix));
+        attr->set_type(onnx::AttributeProto_AttributeType_STRING);
+        attr->set_s(tensor_def.data());
       }
     }
     if (attr_type == ge::proto::AttrDef::kS) {
       if (kDumpLevel == DUMP_ALL) {
         auto str_value = attr_def.s();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING, prefix + attr_name + suffix, &str_value);
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRING,
+                     MakeAttrName(name, prefix, attr_name, suffix), &str_value);
       }
     }
     if (attr_type == ge::proto::AttrDef::kI) {
       auto int_value = attr_def.i();
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, prefix + attr_name + suffix, &int_value);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
+                   MakeAttrName(name, prefix, attr_name, suffix), &int_value);
     }
     if (attr_type == ge::proto::AttrDef::kF) {
       auto float_value = attr_def.f();
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_FLOAT, prefix + attr_name + suffix, &float_value);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_FLOAT,
+                   MakeAttrName(name, prefix, attr_name, suffix), &float_value);
     }
     if (attr_type == ge::proto::AttrDef::kB) {
       auto int_value = static_cast<int64_t>(attr_def.b());
-      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT, prefix + attr_name + suffix, &int_value);
+      AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INT,
+                   MakeAttrName(name, prefix, attr_name, suffix), &int_value);
     }
     if (attr_type == ge::proto::AttrDef::kList) {
       const auto &list_value = attr_def.list();
@@ -478,57 +512,63 @@ void OnnxUtils::AddAttrProtoForAttrsFromAttrMap(
           ge::proto::AttrDef_ListValue_ListValueType::AttrDef_ListValue_ListValueType_VT_LIST_STRING) {
         if (kDumpLevel == DUMP_ALL) {
           const auto &strings = list_value.s();
-          AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRINGS, prefix + attr_name + suffix, strings);
+          AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRINGS,
+                       MakeAttrName(name, prefix, attr_name, suffix), strings);
         }
       }
       if (list_value_type ==
           ge::proto::AttrDef_ListValue_ListValueType::AttrDef_ListValue_ListValueType_VT_LIST_FLOAT) {
         const auto &floats = list_value.f();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_FLOATS, prefix + attr_name + suffix, floats);
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_FLOATS,
+                     MakeAttrName(name, prefix, attr_name, suffix), floats);
       }
       if (list_value_type == ge::proto::AttrDef_ListValue_ListValueType::AttrDef_ListValue_ListValueType_VT_LIST_INT) {
         const auto &ints = list_value.i();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, prefix + attr_name + suffix, ints);
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
+                     MakeAttrName(name, prefix, attr_name, suffix), ints);
       }
       if (list_value_type == ge::proto::AttrDef_ListValue_ListValueType::AttrDef_ListValue_ListValueType_VT_LIST_BOOL) {
         const auto &bools = list_value.b();
-        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, prefix + attr_name + suffix, bools);
+        AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS,
+                     MakeAttrName(name, prefix, attr_name, suffix), bools);
       }
     }
   }
 }
 
-void OnnxUtils::AddAttrProtoFromNodeMembers(const NodePtr &node, onnx::NodeProto *node_proto) {
+void OnnxUtils::AddAttrProtoFromNodeMembers(const NodePtr &node, onnx::NodeProto *node_proto,
+                                            EncodeContext &context) {
   if (node == nullptr || node->impl_ == nullptr) {
     REPORT_INNER_ERROR("E19999", "param node is nullptr.");
     GELOGE(GRAPH_FAILED, "[Check][Param] node is nullptr");
     return;
   }
   // 1.Attributes added from node's methods
-  auto send_list = node->impl_->send_event_id_list_;
+  auto &send_list = node->impl_->send_event_id_list_;
   if (!send_list.empty()) {
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "send_event_id_list", &send_list);
   }
-  auto recv_list = node->impl_->recv_event_id_list_;
+  auto &recv_list = node->impl_->recv_event_id_list_;
   if (!recv_list.empty()) {
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "recv_event_id_list", &recv_list);
   }
-  auto op_desc = node->impl_->op_;
+  const auto &op_desc = node->impl_->op_;
   if (op_desc != nullptr && op_desc->impl_ != nullptr) {
     // for input_name_idx_ in opdesc
-    auto input_name_2_indexs = op_desc->GetAllInputName();
+    const auto &input_name_2_indexs = op_desc->impl_->input_name_idx_;
     ::google::protobuf::RepeatedPtrField<::std::string> input_names;
     ::google::protobuf::RepeatedField<::google::protobuf::int64> input_indexes;
+    input_names.Reserve(static_cast<int>(input_name_2_indexs.size()));
+    input_indexes.Reserve(static_cast<int>(input_name_2_indexs.size()));
     for (const auto &input_name_2_index: input_name_2_indexs) {
-      std::string input_name = input_name_2_index.first;
-      input_names.Add(std::move(input_name));
+      *input_names.Add() = input_name_2_index.first;
       input_indexes.Add(input_name_2_index.second);
     }
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_STRINGS, "_input_name_key", input_names);
     AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "_input_name_value", input_indexes);
     // 2.Attributes added from node's op_(message OpDef)
     // Input and out describes
-    AddAttrProtoForOpInAndOutDesc(node_proto, op_desc);
+    AddAttrProtoForOpInAndOutDesc(node_proto, op_desc, context);
     // Others
     auto op_def = op_desc->impl_->op_def_.GetProtoMsg();
     if (op_def != nullptr) {
@@ -557,7 +597,7 @@ void OnnxUtils::AddAttrProtoFromNodeMembers(const NodePtr &node, onnx::NodeProto
       const auto &is_input_const = op_def->is_input_const();
       AddAttrProto(node_proto, onnx::AttributeProto_AttributeType_INTS, "is_input_const", is_input_const);
       const auto &op_def_attr_map = op_def->attr();
-      AddAttrProtoForAttrsFromAttrMap(op_def_attr_map, node_proto);
+      AddAttrProtoForAttrsFromAttrMap(op_def_attr_map, node_proto, context);
     } else {
       REPORT_INNER_ERROR("E19999", "GetProtoMsg return nullptr, node:%s.", node->GetName().c_str());
       GELOGE(FAILED, "[Get][ProtoMsg] Opdef is nullptr");
@@ -570,7 +610,7 @@ void OnnxUtils::AddAttrProtoFromNodeMembers(const NodePtr &node, onnx::NodeProto
   }
 }
 
-bool OnnxUtils::EncodeNodeDesc(const NodePtr &node, onnx::NodeProto *node_proto) {
+bool OnnxUtils::EncodeNodeDesc(const NodePtr &node, onnx::NodeProto *node_proto, EncodeContext &context) {
   if ((node == nullptr) || (node->impl_ == nullptr) || (node_proto == nullptr)) {
     REPORT_INNER_ERROR("E19999", "param node or node_proto is nullptr, check invalid");
     GELOGE(GRAPH_FAILED, "[Check][Param] EncodeOpDesc: Input Para Node Invalid");
@@ -582,10 +622,11 @@ bool OnnxUtils::EncodeNodeDesc(const NodePtr &node, onnx::NodeProto *node_proto)
     AddAttrProtoFromAttribute(node_attr, node_proto);
   }
   // 3.Encode ge::Node members to AttributeProto
-  AddAttrProtoFromNodeMembers(node, node_proto);
+  AddAttrProtoFromNodeMembers(node, node_proto, context);
 
-  // 4. Sort node attributes by name.
-  std::sort(node_proto->mutable_attribute()->begin(), node_proto->mutable_attribute()->end(), AttrNameComp());
+  // 4. Sort node attributes by name, only the element pointers are moved
+  std::sort(node_proto->mutable_attribute()->pointer_begin(), node_proto->mutable_attribute()->pointer_end(),
+            AttrNameComp());
   return true;
 }
 
@@ -646,7 +687,7 @@ bool OnnxUtils::EncodeNodeLink(const NodePtr &node, onnx::NodeProto *node_proto)
   return true;
 }
 
-bool OnnxUtils::EncodeNode(const NodePtr &node, onnx::NodeProto *node_proto) {
+bool OnnxUtils::EncodeNode(const NodePtr &node, onnx::NodeProto *node_proto, EncodeContext &context) {
   if ((node == nullptr) || (node_proto == nullptr)) {
     REPORT_INNER_ERROR("E19999", "param node or node_proto is nullptr, check invalid");
     GELOGE(GRAPH_FAILED, "[Check][Param] EncodeNode: Input Para Node Invalid");
@@ -661,7 +702,7 @@ bool OnnxUtils::EncodeNode(const NodePtr &node, onnx::NodeProto *node_proto) {
 
   if (kDumpLevel != DUMP_WITH_OUT_DESC) {
     // 2.for attr
-    if (!EncodeNodeDesc(node, node_proto)) {
+    if (!EncodeNodeDesc(node, node_proto, context)) {
       GELOGE(GRAPH_FAILED, "[Encode][NodeDesc] failed, node:%s", node->GetName().c_str());
       return false;
     }
@@ -714,7 +755,8 @@ void OnnxUtils::EncodeValueInfo(const NodePtr &node, onnx::ValueInfoProto *value
   EncodeTypeProtoTensorType(node, tensor_type);
 }
 
-bool OnnxUtils::EncodeGraph(const ConstComputeGraphPtr &graph, onnx::GraphProto *graph_proto) {
+bool OnnxUtils::EncodeGraph(const ConstComputeGraphPtr &graph, onnx::GraphProto *graph_proto,
+                            const EncodeOptions &options, GraphThreadPool *pool) {
   if ((graph == nullptr) || (graph_proto == nullptr)) {
     REPORT_INNER_ERROR("E19999", "param graph or graph proto is nullptr, check invalid.");
     GELOGE(GRAPH_FAILED, "[Check][Param] EncodeGraph: Input para Invalid");
@@ -731,17 +773,36 @@ bool OnnxUtils::EncodeGraph(const ConstComputeGraphPtr &graph, onnx::GraphProto
     auto value_info_proto = graph_proto->add_output();
     EncodeValueInfo(output, value_info_proto);
   }
-  // 3. Add nodes
-  for (const auto &node : graph->GetDirectNode()) {
-    if (!EncodeNode(node, graph_proto->add_node())) {
-      GELOGW("[Encode][Graph] Encode node %s failed", node->GetName().c_str());
-      continue;
+  // 3. Add nodes, the protos are added up front so that each shard fills its own range of them
+  const auto nodes = graph->GetDirectNode();
+  std::vector<onnx::NodeProto *> node_protos(nodes.size(), nullptr);
+  graph_proto->mutable_node()->Reserve(static_cast<int>(nodes.size()));
+  for (auto &node_proto : node_protos) {
+    node_proto = graph_proto->add_node();
+  }
+  const auto encode_nodes = [&nodes, &node_protos, &options](size_t begin, size_t end) {
+    EncodeContext context;
+    context.is_dump_weight_data = (kDumpLevel == DUMP_ALL) && (!options.skip_weight_data);
+    for (size_t i = begin; i < end; ++i) {
+      if (!EncodeNode(nodes.at(i), node_protos[i], context)) {
+        GELOGW("[Encode][Graph] Encode node %s failed", nodes.at(i)->GetName().c_str());
+      }
     }
+  };
+  if ((pool == nullptr) || (nodes.size() < kMinNodeNumForParallel)) {
+    encode_nodes(0U, nodes.size());
+  } else {
+    pool->ParallelFor(nodes.size(), encode_nodes);
   }
   return true;
 }
 
 bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelProto &model_proto) {
+  return ConvertGeModelToModelProto(model, model_proto, EncodeOptions());
+}
+
+bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelProto &model_proto,
+                                           const EncodeOptions &options) {
   model_proto.set_model_version(model.GetVersion());
   model_proto.set_ir_version(onnx::IR_VERSION);
   model_proto.set_producer_name(model.GetName());
@@ -758,7 +819,20 @@ bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelPr
     GELOGE(GRAPH_FAILED, "[Invoke][MutableGraph] return nullptr, graph:%s", compute_graph->GetName().c_str());
     return false;
   }
-  if (!EncodeGraph(compute_graph, graph_proto)) {
+  std::unique_ptr<GraphThreadPool> pool;
+  if (options.parallel_num > 1U) {
+    const auto all_subgraphs = compute_graph->GetAllSubgraphs();
+    const bool has_large_graph =
+        (compute_graph->GetDirectNodesSize() >= kMinNodeNumForParallel) ||
+        std::any_of(all_subgraphs.begin(), all_subgraphs.end(), [](const ComputeGraphPtr &subgraph) {
+          return (subgraph != nullptr) && (subgraph->GetDirectNodesSize() >= kMinNodeNumForParallel);
+        });
+    if (has_large_graph) {
+      // the calling thread encodes a shard as well
+      pool.reset(new (std::nothrow) GraphThreadPool(options.parallel_num - 1U));
+    }
+  }
+  if (!EncodeGraph(compute_graph, graph_proto, options, pool.get())) {
     GELOGE(GRAPH_FAILED, "[Invoke][EncodeGraph] fail, graph:%s", compute_graph->GetName().c_str());
     return false;
   }
@@ -784,7 +858,7 @@ bool OnnxUtils::ConvertGeModelToModelProto(const ge::Model &model, onnx::ModelPr
       GELOGW("[Convert][GeModel] Sub graph proto is nullptr");
       continue;
     }
-    if (!EncodeGraph(sub_compute_graph, sub_graph_proto)) {
+    if (!EncodeGraph(sub_compute_graph, sub_graph_proto, options, pool.get())) {
       GELOGW("[Convert][GeModel] Encode sub graph %s failed", sub_compute_graph->GetName().c_str());
       continue;
     }
@@ -44,6 +44,8 @@
 #include "proto/onnx/ge_onnx.pb.h"
 
 namespace ge {
+class GraphThreadPool;
+
 const int kOffsetToString = 2;
 
 ///
@@ -104,41 +106,65 @@ class OnnxUtils {
  public:
   enum DumpLevel { NO_DUMP = 0, DUMP_ALL = 1, DUMP_WITH_OUT_DATA = 2, DUMP_WITH_OUT_DESC = 3, DUMP_LEVEL_END };
 
+  struct EncodeOptions {
+    // Threads used to encode the nodes of a graph, graphs with few nodes are always encoded on the calling thread
+    uint32_t parallel_num = 1U;
+    // Tensor data are dumped with DUMP_ALL, skip them to keep visualization dumps small
+    bool skip_weight_data = false;
+  };
+
   static bool ConvertGeModelToModelProto(const ge::Model &model, ge::onnx::ModelProto &model_proto);
 
+  static bool ConvertGeModelToModelProto(const ge::Model &model, ge::onnx::ModelProto &model_proto,
+                                         const EncodeOptions &options);
+
   static bool ConvertModelProtoToGeModel(const ge::onnx::ModelProto &model_proto, ge::Model &model);
 
  private:
   // Part 1: from IR convert to ONNX Protobuf
+  // State of one encoding thread, the scratch buffer is reused by all the nodes the thread encodes
+  struct EncodeContext {
+    bool is_dump_weight_data = false;
+    std::string attr_name;
+  };
+
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
                            const std::string &name, void *data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<::google::protobuf::int64> data);
+                           const std::string &name,
+                           const ::google::protobuf::RepeatedField<::google::protobuf::int64> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<bool> data);
+                           const std::string &name,
+                           const ::google::protobuf::RepeatedField<bool> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedField<float> data);
+                           const std::string &name,
+                           const ::google::protobuf::RepeatedField<float> &data);
 
   static void AddAttrProto(ge::onnx::NodeProto *node_proto, ge::onnx::AttributeProto_AttributeType type,
-                           const std::string &name, ::google::protobuf::RepeatedPtrField<::std::string> data);
+                           const std::string &name,
+                           const ::google::protobuf::RepeatedPtrField<::std::string> &data);
 
-  static void AddAttrProtoFromNodeMembers(const NodePtr &node, ge::onnx::NodeProto *node_proto);
+  static void AddAttrProtoFromNodeMembers(const NodePtr &node, ge::onnx::NodeProto *node_proto,
+                                          EncodeContext &context);
 
   static void AddAttrProtoFromAttribute(const std::pair<const std::string, ge::GeAttrValue> &string_attr_value,
                                         ge::onnx::NodeProto *node_proto);
 
-  static void AddAttrProtoForOpInDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc);
+  static void AddAttrProtoForOpInDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc, EncodeContext &context);
 
-  static void AddAttrProtoForOpOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc);
+  static void AddAttrProtoForOpOutDesc(onnx::NodeProto *node_proto, const OpDescPtr &op_desc,
+                                       EncodeContext &context);
 
-  static void AddAttrProtoForOpInAndOutDesc(ge::onnx::NodeProto *node_proto, const OpDescPtr &op_desc);
+  static void AddAttrProtoForOpInAndOutDesc(ge::onnx::NodeProto *node_proto, const OpDescPtr &op_desc,
+                                            EncodeContext &context);
 
   static void AddAttrProtoForAttrsFromAttrMap(const ::google::protobuf::Map<std::string,
                                                                             ge::proto::AttrDef> &attr_map,
                                               ge::onnx::NodeProto *node_proto,
+                                              EncodeContext &context,
                                               const std::string& prefix = "",
                                               const std::string& suffix = "");
 
@@ -150,15 +176,16 @@ class OnnxUtils {
 
   static bool EncodeNodeLink(const NodePtr &node, ge::onnx::NodeProto *node_proto);
 
-  static bool EncodeNodeDesc(const NodePtr &node, ge::onnx::NodeProto *node_proto);
+  static bool EncodeNodeDesc(const NodePtr &node, ge::onnx::NodeProto *node_proto, EncodeContext &context);
 
-  static bool EncodeNode(const NodePtr &node, ge::onnx::NodeProto *node_proto);
+  static bool EncodeNode(const NodePtr &node, ge::onnx::NodeProto *node_proto, EncodeContext &context);
 
   static void EncodeTypeProtoTensorType(const NodePtr &node, ge::onnx::TypeProto_Tensor *tensor_type);
 
   static void EncodeValueInfo(const NodePtr &n, ge::onnx::ValueInfoProto *v);
 
-  static bool EncodeGraph(const ConstComputeGraphPtr &graph, ge::onnx::GraphProto *graph_proto);
+  static bool EncodeGraph(const ConstComputeGraphPtr &graph, ge::onnx::GraphProto *graph_proto,
+                          const EncodeOptions &options, GraphThreadPool *pool);
 
   /// Part 2: from ONNX Protobuf convert to IR
   /// Describes node's link relationships
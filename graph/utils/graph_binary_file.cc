@@ -0,0 +1,304 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph_binary_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "debug/ge_log.h"
+#include "debug/ge_util.h"
+#include "external/ge/ge_api_types.h"
+#include "graph/ge_context.h"
+#include "graph/utils/scope_guard.h"
+#include "mmpa/mmpa_api.h"
+
+namespace ge {
+namespace {
+using google::protobuf::internal::WireFormatLite;
+const int32_t kBaseOfIntegerValue = 10;
+
+/// Read only mapping of a whole file, pages are only touched by the parts that are parsed
+class MappedFile {
+ public:
+  explicit MappedFile(const char *file) {
+    const int32_t fd = open(file, O_RDONLY);
+    if (fd < 0) {
+      REPORT_CALL_ERROR("E19999", "open file:%s failed, errormessage:%s", file, strerror(errno));
+      GELOGE(GRAPH_FAILED, "[Open][File] failed for %s, reason:%s", file, strerror(errno));
+      return;
+    }
+    struct stat file_stat;
+    if ((fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0)) {
+      void *const addr = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        addr_ = addr;
+        size_ = static_cast<size_t>(file_stat.st_size);
+      } else {
+        REPORT_CALL_ERROR("E19999", "mmap file:%s failed, errormessage:%s", file, strerror(errno));
+        GELOGE(GRAPH_FAILED, "[Map][File] failed for %s, reason:%s", file, strerror(errno));
+      }
+    }
+    (void)close(fd);
+  }
+
+  ~MappedFile() {
+    if (addr_ != nullptr) {
+      (void)munmap(addr_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *GetData() const {
+    return static_cast<const uint8_t *>(addr_);
+  }
+  size_t GetSize() const {
+    return size_;
+  }
+
+ private:
+  void *addr_ = nullptr;
+  size_t size_ = 0U;
+};
+
+bool IsValidRange(uint64_t offset, uint64_t size, uint64_t total_size) {
+  return (offset <= total_size) && (size <= (total_size - offset));
+}
+
+bool ParseFromBytes(const uint8_t *data, uint64_t size, google::protobuf::Message &proto) {
+  if (size > static_cast<uint64_t>(INT32_MAX)) {
+    REPORT_INNER_ERROR("E19999", "proto size %lu exceeds %d, check invalid.", size, INT32_MAX);
+    GELOGE(GRAPH_FAILED, "[Check][Param] proto size %lu exceeds %d.", size, INT32_MAX);
+    return false;
+  }
+  google::protobuf::io::CodedInputStream coded_stream(data, static_cast<int>(size));
+  // 2048M -1
+  coded_stream.SetTotalBytesLimit(INT32_MAX, -1);
+  return proto.ParseFromCodedStream(&coded_stream);
+}
+
+bool GetHeader(const MappedFile &mapped_file, const char *file, GraphBinaryFileHeader &header) {
+  if ((mapped_file.GetData() == nullptr) || (mapped_file.GetSize() < sizeof(GraphBinaryFileHeader))) {
+    REPORT_INNER_ERROR("E19999", "file:%s is not a graph binary file, size:%zu", file, mapped_file.GetSize());
+    GELOGE(GRAPH_FAILED, "[Check][Param] file:%s is not a graph binary file, size:%zu", file, mapped_file.GetSize());
+    return false;
+  }
+  (void)memcpy(&header, mapped_file.GetData(), sizeof(GraphBinaryFileHeader));
+  const uint64_t sections_size = static_cast<uint64_t>(header.section_num) * sizeof(GraphBinarySection);
+  if ((header.magic != GraphBinaryFile::kMagic) || (header.version != GraphBinaryFile::kVersion) ||
+      !IsValidRange(header.model_offset, header.model_size, mapped_file.GetSize()) ||
+      !IsValidRange(sizeof(GraphBinaryFileHeader), sections_size, header.model_offset)) {
+    REPORT_INNER_ERROR("E19999", "file:%s has an invalid header, magic:%u, version:%u", file, header.magic,
+                       header.version);
+    GELOGE(GRAPH_FAILED, "[Check][Header] file:%s has an invalid header, magic:%u, version:%u", file, header.magic,
+           header.version);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+bool GraphBinaryFile::Write(proto::ModelDef &model_def, const char *real_path, bool with_index) {
+  GE_CHK_BOOL_EXEC(real_path != nullptr, REPORT_INNER_ERROR("E19999", "param real_path is nullptr, check invalid.");
+                   return false, "[Check][Param] real_path is null.");
+  // Writes the model fields first and the graphs one by one after them, the result is still a valid ModelDef
+  google::protobuf::RepeatedPtrField<proto::GraphDef> graphs;
+  graphs.Swap(model_def.mutable_graph());
+  std::function<void()> restore_graphs = [&model_def, &graphs]() { graphs.Swap(model_def.mutable_graph()); };
+  GE_MAKE_GUARD(restore, restore_graphs);
+
+  const uint32_t graph_tag = WireFormatLite::MakeTag(proto::ModelDef::kGraphFieldNumber,
+                                                     WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+#if !defined(__ANDROID__) && !defined(ANDROID)
+  const uint64_t head_size = model_def.ByteSizeLong();
+#else
+  const uint64_t head_size = static_cast<uint64_t>(model_def.ByteSize());
+#endif
+  uint64_t model_size = head_size;
+  std::vector<uint64_t> graph_sizes;
+  graph_sizes.reserve(static_cast<size_t>(graphs.size()));
+  for (const auto &graph_def : graphs) {
+#if !defined(__ANDROID__) && !defined(ANDROID)
+    const uint64_t graph_size = graph_def.ByteSizeLong();
+#else
+    const uint64_t graph_size = static_cast<uint64_t>(graph_def.ByteSize());
+#endif
+    graph_sizes.emplace_back(graph_size);
+    model_size += google::protobuf::io::CodedOutputStream::VarintSize32(graph_tag) +
+                  google::protobuf::io::CodedOutputStream::VarintSize64(graph_size) + graph_size;
+  }
+
+  GraphBinaryFileHeader header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.section_num = with_index ? static_cast<uint32_t>(graphs.size()) : 0U;
+  std::vector<GraphBinarySection> sections(header.section_num);
+  std::string names;
+  const uint64_t names_offset = sizeof(GraphBinaryFileHeader) + sections.size() * sizeof(GraphBinarySection);
+  for (size_t i = 0U; i < sections.size(); ++i) {
+    sections[i].name_offset = names_offset + names.size();
+    sections[i].name_size = graphs.Get(static_cast<int>(i)).name().size();
+    names.append(graphs.Get(static_cast<int>(i)).name());
+  }
+  header.model_offset = names_offset + names.size();
+  header.model_size = model_size;
+  uint64_t graph_offset = header.model_offset + head_size;
+  for (size_t i = 0U; i < sections.size(); ++i) {
+    graph_offset += google::protobuf::io::CodedOutputStream::VarintSize32(graph_tag) +
+                    google::protobuf::io::CodedOutputStream::VarintSize64(graph_sizes[i]);
+    sections[i].offset = graph_offset;
+    sections[i].size = graph_sizes[i];
+    graph_offset += graph_sizes[i];
+  }
+
+  // the size is known before the write, so an oversized dump is not written at all rather than removed after it
+  const uint64_t file_size = header.model_offset + model_size;
+  std::string max_file_size_opt = "0";
+  (void)GetContext().GetOption(OPTION_GE_MAX_DUMP_FILE_SIZE, max_file_size_opt);
+  const uint64_t max_file_size = std::strtoull(max_file_size_opt.c_str(), nullptr, kBaseOfIntegerValue);
+  if ((max_file_size != 0U) && (file_size > max_file_size)) {
+    GELOGW("[Write][Check] size %lu of file %s exceeds max_dump_file_size %lu, skip it.", file_size, real_path,
+           max_file_size);
+    return false;
+  }
+
+  const int32_t kFileAuthority = 0600;
+  const int32_t fd = mmOpen2(real_path, M_WRONLY | M_CREAT | O_TRUNC, kFileAuthority);
+  if (fd < 0) {
+    REPORT_CALL_ERROR("E19999", "open file:%s failed, errormessage:%s", real_path, strerror(errno));
+    GELOGE(GRAPH_FAILED, "[Open][File] failed for %s, reason:%s", real_path, strerror(errno));
+    return false;
+  }
+  google::protobuf::io::FileOutputStream output(fd);
+  bool ret = true;
+  {
+    google::protobuf::io::CodedOutputStream coded_stream(&output);
+    // identical graphs give identical files, so binary dumps can be compared directly
+    coded_stream.SetSerializationDeterministic(true);
+    coded_stream.WriteRaw(&header, static_cast<int>(sizeof(header)));
+    if (!sections.empty()) {
+      coded_stream.WriteRaw(sections.data(), static_cast<int>(sections.size() * sizeof(GraphBinarySection)));
+    }
+    coded_stream.WriteString(names);
+    // sizes are cached by the ByteSizeLong calls above
+    model_def.SerializeWithCachedSizes(&coded_stream);
+    for (size_t i = 0U; i < graph_sizes.size(); ++i) {
+      coded_stream.WriteTag(graph_tag);
+      coded_stream.WriteVarint64(graph_sizes[i]);
+      graphs.Get(static_cast<int>(i)).SerializeWithCachedSizes(&coded_stream);
+    }
+    ret = !coded_stream.HadError();
+  }
+  ret = output.Close() && ret;
+  if (!ret) {
+    REPORT_CALL_ERROR("E19999", "write file:%s failed.", real_path);
+    GELOGE(GRAPH_FAILED, "[Write][File] Fail to write the file: %s", real_path);
+  }
+  return ret;
+}
+
+bool GraphBinaryFile::IsBinaryFile(const char *file) {
+  if (file == nullptr) {
+    return false;
+  }
+  std::ifstream fs(file, std::ifstream::in | std::ifstream::binary);
+  uint32_t magic = 0U;
+  if (!fs.is_open() || !fs.read(reinterpret_cast<char *>(&magic), sizeof(magic))) {
+    return false;
+  }
+  return magic == kMagic;
+}
+
+bool GraphBinaryFile::Read(const char *file, proto::ModelDef &model_def) {
+  GE_CHK_BOOL_EXEC(file != nullptr, REPORT_INNER_ERROR("E19999", "param file is nullptr, check invalid.");
+                   return false, "[Check][Param] file is null.");
+  const MappedFile mapped_file(file);
+  GraphBinaryFileHeader header;
+  if (!GetHeader(mapped_file, file, header)) {
+    return false;
+  }
+  if (!ParseFromBytes(mapped_file.GetData() + header.model_offset, header.model_size, model_def)) {
+    REPORT_CALL_ERROR("E19999", "parse model from binary file:%s failed.", file);
+    GELOGE(GRAPH_FAILED, "[Parse][Proto] parse model from binary file:%s failed.", file);
+    return false;
+  }
+  return true;
+}
+
+bool GraphBinaryFile::ReadGraph(const char *file, const std::string &graph_name, proto::GraphDef &graph_def) {
+  GE_CHK_BOOL_EXEC(file != nullptr, REPORT_INNER_ERROR("E19999", "param file is nullptr, check invalid.");
+                   return false, "[Check][Param] file is null.");
+  const MappedFile mapped_file(file);
+  GraphBinaryFileHeader header;
+  if (!GetHeader(mapped_file, file, header)) {
+    return false;
+  }
+  if (header.section_num == 0U) {
+    proto::ModelDef model_def;
+    if (!ParseFromBytes(mapped_file.GetData() + header.model_offset, header.model_size, model_def)) {
+      REPORT_CALL_ERROR("E19999", "parse model from binary file:%s failed.", file);
+      GELOGE(GRAPH_FAILED, "[Parse][Proto] parse model from binary file:%s failed.", file);
+      return false;
+    }
+    for (auto &graph : *model_def.mutable_graph()) {
+      if (graph.name() == graph_name) {
+        graph_def.Swap(&graph);
+        return true;
+      }
+    }
+  }
+  for (uint32_t i = 0U; i < header.section_num; ++i) {
+    GraphBinarySection section;
+    (void)memcpy(&section, mapped_file.GetData() + sizeof(GraphBinaryFileHeader) + i * sizeof(GraphBinarySection),
+                 sizeof(GraphBinarySection));
+    if (!IsValidRange(section.name_offset, section.name_size, header.model_offset) ||
+        !IsValidRange(section.offset, section.size, mapped_file.GetSize())) {
+      REPORT_INNER_ERROR("E19999", "section %u of file:%s is out of range.", i, file);
+      GELOGE(GRAPH_FAILED, "[Check][Section] section %u of file:%s is out of range.", i, file);
+      return false;
+    }
+    if ((section.name_size != graph_name.size()) ||
+        (memcmp(mapped_file.GetData() + section.name_offset, graph_name.data(), graph_name.size()) != 0)) {
+      continue;
+    }
+    if (!ParseFromBytes(mapped_file.GetData() + section.offset, section.size, graph_def)) {
+      REPORT_CALL_ERROR("E19999", "parse graph %s from binary file:%s failed.", graph_name.c_str(), file);
+      GELOGE(GRAPH_FAILED, "[Parse][Proto] parse graph %s from binary file:%s failed.", graph_name.c_str(), file);
+      return false;
+    }
+    return true;
+  }
+  REPORT_INNER_ERROR("E19999", "graph %s is not found in file:%s.", graph_name.c_str(), file);
+  GELOGE(GRAPH_FAILED, "[Find][Graph] graph %s is not found in file:%s.", graph_name.c_str(), file);
+  return false;
+}
+}  // namespace ge
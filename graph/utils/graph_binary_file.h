@@ -0,0 +1,77 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_GRAPH_UTILS_GRAPH_BINARY_FILE_H_
+#define COMMON_GRAPH_UTILS_GRAPH_BINARY_FILE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "proto/ge_ir.pb.h"
+
+namespace ge {
+/// Binary on-disk form of the GE IR graph dump.
+///
+///   +-------------------------+ 0
+///   | GraphBinaryFileHeader   |
+///   +-------------------------+ sizeof(GraphBinaryFileHeader)
+///   | GraphBinarySection[n]   |  optional, one per GraphDef of the model
+///   +-------------------------+
+///   | section names           |
+///   +-------------------------+ model_offset
+///   | proto::ModelDef         |  model_size bytes
+///   +-------------------------+
+///
+/// The model part is an ordinary serialized ModelDef, each GraphDef is written as its own field so that a
+/// section can point to the bytes of a single graph and that graph can be parsed without the others.
+/// All integers are in host byte order, the file is meant for dump and tuning round trips on one machine.
+struct GraphBinaryFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t section_num;
+  uint32_t reserved;
+  uint64_t model_offset;
+  uint64_t model_size;
+};
+
+struct GraphBinarySection {
+  uint64_t offset;       // offset of the GraphDef bytes from the beginning of the file
+  uint64_t size;
+  uint64_t name_offset;  // offset of the graph name from the beginning of the file
+  uint64_t name_size;
+};
+
+class GraphBinaryFile {
+ public:
+  static const uint32_t kMagic = 0x42495247U;  // "GRIB"
+  static const uint32_t kVersion = 1U;
+
+  /// Writes model_def to real_path, the graphs of model_def are borrowed during the write and restored after it.
+  /// Like the text dump, a file larger than the option ge.maxDumpFileSize is not written
+  static bool Write(proto::ModelDef &model_def, const char *real_path, bool with_index);
+
+  /// Checks the magic number only, a text dump never starts with it
+  static bool IsBinaryFile(const char *file);
+
+  static bool Read(const char *file, proto::ModelDef &model_def);
+
+  /// Parses the graph named graph_name only, uses the section index when the file has one
+  static bool ReadGraph(const char *file, const std::string &graph_name, proto::GraphDef &graph_def);
+};
+}  // namespace ge
+
+#endif  // COMMON_GRAPH_UTILS_GRAPH_BINARY_FILE_H_
@@ -40,11 +40,14 @@
 #include "utils/node_utils.h"
 #include "utils/file_utils.h"
 #include "graph/utils/dumper/ge_graph_dumper.h"
+#include "graph/utils/graph_binary_file.h"
+#include "graph/detail/model_serialize_imp.h"
 #include "debug/ge_op_types.h"
 #include "external/ge/ge_api_types.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/utils/op_desc_utils.h"
 #include "graph/utils/tensor_utils.h"
+#include "graph/utils/thread_pool.h"
 #include "graph/compute_graph_impl.h"
 #include "graph/op_desc_impl.h"
 #include "mmpa/mmpa_api.h"
@@ -69,6 +72,8 @@ const int kDumpGraphIndexWidth = 8;
 const char *const kNpuCollectPath = "NPU_COLLECT_PATH";
 const char *const kDumpGraphPath = "DUMP_GRAPH_PATH";
 const char *const kDumpGraphLevel = "DUMP_GRAPH_LEVEL";
+const char *const kDumpGraphFormat = "DUMP_GRAPH_FORMAT";
+const char *const kDumpGraphFormatBinary = "bin";
 const char *const kDumpStrBuild = "Build";
 const char *const kDumpStrPartition = "partition";
 const char *const kDumpStrOptimizeSubgraph = "OptimizeSubGraph";
@@ -761,33 +766,43 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraph(cons
     }
   }
 
+  const bool is_binary = GraphUtils::IsDumpGraphInBinary();
   stream_file_name << "ge_proto_" << std::setw(kDumpGraphIndexWidth) << std::setfill('0') << file_index;
-  stream_file_name << "_" << suffix << ".txt";
+  stream_file_name << "_" << suffix << (is_binary ? ".bin" : ".txt");
   std::string proto_file = user_graph_name.empty() ? stream_file_name.str() : user_graph_name;
 
-  // Create buffer
-  ge::Model model("", "");
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
-  Buffer buffer;
+  char real_path[MMPA_MAX_PATH] = {0x00};
+  GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH,
+                                 REPORT_INNER_ERROR("E19999", "file path is too longer! file:%s", proto_file.c_str());
+                                 return, "[Check][Param] file path is too longer!");
+  GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
+                  GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
+
   const int64_t kDumpLevel =
       (dump_ge_graph != nullptr) ? std::strtol(dump_ge_graph, nullptr, kBaseOfIntegerValue) : ge::OnnxUtils::NO_DUMP;
-  model.Save(buffer, kDumpLevel != ge::OnnxUtils::DUMP_ALL && !is_always_dump);
+  const bool is_dump_all = (kDumpLevel == ge::OnnxUtils::DUMP_ALL) || is_always_dump;
+  // An asynchronous dumper snapshots the graph and writes the file on its own thread. It may sample or drop dumps,
+  // so forced dumps and dumps to a file named by the caller, which may be read back at once, are written here
+  const GraphDumpFormat format = is_binary ? GraphDumpFormat::kGeIrBinary : GraphDumpFormat::kGeIrText;
+  if ((graph != nullptr) && !is_always_dump && user_graph_name.empty() &&
+      GraphDumperRegistry::GetDumper().DumpToFile(*graph, suffix, real_path, format, is_dump_all)) {
+    return;
+  }
 
-  // Write file
+  // Serialize to ModelDef directly, there is no need to go through a buffer
+  ge::Model model("", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(graph)));
   ge::proto::ModelDef ge_proto;
-  if (buffer.GetData() != nullptr) {
-    std::string str(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
-    if (!ge_proto.ParseFromString(str)) {
-      GELOGE(GRAPH_FAILED, "[Invoke][Parse] parse from string failed.");
-      return;
-    }
-    char real_path[MMPA_MAX_PATH] = {0x00};
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(strlen(proto_file.c_str()) >= MMPA_MAX_PATH,
-                                   REPORT_INNER_ERROR("E19999", "file path is too longer! file:%s", proto_file.c_str());
-                                   return, "[Check][Param] file path is too longer!");
-    GE_IF_BOOL_EXEC(mmRealPath(proto_file.c_str(), real_path, MMPA_MAX_PATH) != EN_OK,
-                    GELOGI("file %s does not exist, it will be created.", proto_file.c_str()));
+  ModelSerializeImp serialize_imp;
+  if (!serialize_imp.SerializeModel(model, &ge_proto, !is_dump_all)) {
+    GELOGE(GRAPH_FAILED, "[Serialize][Model] serialize graph failed, file:%s.", real_path);
+    return;
+  }
 
+  // Write file
+  if (is_binary) {
+    (void)GraphBinaryFile::Write(ge_proto, real_path, true);
+  } else {
     GraphUtils::WriteProtoToTextFile(ge_proto, real_path);
   }
 #else
@@ -847,11 +862,27 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGrph(const
   }
 }
 
+namespace {
+// Dump files are either GE IR text or GraphBinaryFile, the binary ones are recognized by their magic number
+bool ReadModelDefFromFile(const char *file, ge::proto::ModelDef &model_def) {
+  if (GraphBinaryFile::IsBinaryFile(file)) {
+    return GraphBinaryFile::Read(file, model_def);
+  }
+  return GraphUtils::ReadProtoFromTextFile(file, &model_def);
+}
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::IsDumpGraphInBinary() {
+  char dump_graph_format[MMPA_MAX_PATH] = { 0x00 };
+  const INT32 res = mmGetEnv(kDumpGraphFormat, dump_graph_format, MMPA_MAX_PATH);
+  return (res == EN_OK) && (strcmp(dump_graph_format, kDumpGraphFormatBinary) == 0);
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(const char *file,
                                                                             ge::ComputeGraph &compute_graph) {
   ge::proto::ModelDef model_def;
   // Get ModelDef object from file generated by DumpGEGraph()
-  if (!ReadProtoFromTextFile(file, &model_def)) {
+  if (!ReadModelDefFromFile(file, model_def)) {
     GELOGE(GRAPH_FAILED, "[Get][ModelDef] failed from file:%s", file);
     return false;
   }
@@ -874,7 +905,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(cons
                                                                             ge::ComputeGraphPtr &compute_graph) {
   ge::proto::ModelDef model_def;
   // Get ModelDef object from file generated by DumpGEGraph()
-  if (!ReadProtoFromTextFile(file, &model_def)) {
+  if (!ReadModelDefFromFile(file, model_def)) {
     GELOGE(GRAPH_FAILED, "[Get][ModelDef] failed from file:%s", file);
     return false;
   }
@@ -902,6 +933,45 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(cons
   }
 }
 
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool GraphUtils::LoadGEGraph(const char *file,
+                                                                            const std::string &graph_name,
+                                                                            ge::ComputeGraphPtr &compute_graph) {
+  GE_CHK_BOOL_EXEC(file != nullptr, REPORT_INNER_ERROR("E19999", "param file is nullptr, check invalid.");
+                   return false, "[Check][Param] file is null.");
+  const auto graph_def = ComGraphMakeShared<ge::proto::GraphDef>();
+  GE_CHK_BOOL_EXEC(graph_def != nullptr, REPORT_CALL_ERROR("E19999", "create GraphDef failed.");
+                   return false, "[Create][GraphDef] proto::GraphDef make shared failed");
+  if (GraphBinaryFile::IsBinaryFile(file)) {
+    // only the bytes of this graph are parsed when the file has a section index
+    if (!GraphBinaryFile::ReadGraph(file, graph_name, *graph_def)) {
+      GELOGE(GRAPH_FAILED, "[Get][GraphDef] %s failed from file:%s", graph_name.c_str(), file);
+      return false;
+    }
+  } else {
+    ge::proto::ModelDef model_def;
+    if (!ReadProtoFromTextFile(file, &model_def)) {
+      GELOGE(GRAPH_FAILED, "[Get][ModelDef] failed from file:%s", file);
+      return false;
+    }
+    const auto iter = std::find_if(model_def.mutable_graph()->begin(), model_def.mutable_graph()->end(),
+                                   [&graph_name](const ge::proto::GraphDef &def) { return def.name() == graph_name; });
+    if (iter == model_def.mutable_graph()->end()) {
+      REPORT_INNER_ERROR("E19999", "graph %s is not found in file:%s.", graph_name.c_str(), file);
+      GELOGE(GRAPH_FAILED, "[Find][Graph] graph %s is not found in file:%s.", graph_name.c_str(), file);
+      return false;
+    }
+    graph_def->Swap(&(*iter));
+  }
+  ModelSerializeImp imp;
+  imp.SetProtobufOwner(graph_def);
+  if (!imp.UnserializeGraph(compute_graph, *graph_def) || (compute_graph == nullptr)) {
+    REPORT_CALL_ERROR("E19999", "Unserialize graph %s failed, file:%s.", graph_name.c_str(), file);
+    GELOGE(GRAPH_FAILED, "[Unserialize][Graph] %s failed, file:%s", graph_name.c_str(), file);
+    return false;
+  }
+  return true;
+}
+
 // Printing protocol messages in text format is useful for debugging and human editing of messages.
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::WriteProtoToTextFile(
     const google::protobuf::Message &proto, const char *real_path) {
@@ -1013,17 +1083,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
     return;
   }
 
-  // 1.Get ge::onnx::ModelProto from ge::Model
-  ge::Model model("GE", "");
-  std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
-  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
-  onnx::ModelProto model_proto;
-  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
-    GELOGE(GRAPH_FAILED, "[Convert][GeModel] DumpGEGraphToOnnx failed.");
-    return;
-  }
-
-  // 2.Set file name
+  // 1.Set file name
   static std::atomic_long atomic_file_index(0);
   auto file_index = atomic_file_index.fetch_add(1);
   GELOGD("Start to dump ge onnx file: %ld", file_index);
@@ -1078,7 +1138,25 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGEGraphToOnn
     }
   }
 
-  // 3. Serialize to file in current path
+  // 2.An asynchronous dumper converts the graph and writes the file on its own thread
+  if (GraphDumperRegistry::GetDumper().DumpToFile(compute_graph, suffix, real_path.get(), GraphDumpFormat::kOnnxText,
+                                                  dump_ge_graph_level == OnnxUtils::DUMP_ALL)) {
+    return;
+  }
+
+  // 3.Get ge::onnx::ModelProto from ge::Model
+  ge::Model model("GE", "");
+  std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
+  onnx::ModelProto model_proto;
+  OnnxUtils::EncodeOptions encode_options;
+  encode_options.parallel_num = GraphThreadPool::GetDefaultThreadNum();
+  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto, encode_options)) {
+    GELOGE(GRAPH_FAILED, "[Convert][GeModel] DumpGEGraphToOnnx failed.");
+    return;
+  }
+
+  // 4. Serialize to file in current path
   GraphUtils::WriteProtoToTextFile(model_proto, real_path.get());
 #else
   GELOGW("[DumpGraph][Check] Need to define FMK_SUPPORT_DUMP for dump graph.");
@@ -1093,7 +1171,9 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void GraphUtils::DumpGrphToOnnx(c
   std::shared_ptr<ge::ComputeGraph> compute_graph_ptr = ComGraphMakeShared<ge::ComputeGraph>(compute_graph);
   model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(std::const_pointer_cast<ComputeGraph>(compute_graph_ptr)));
   onnx::ModelProto model_proto;
-  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto)) {
+  OnnxUtils::EncodeOptions encode_options;
+  encode_options.parallel_num = GraphThreadPool::GetDefaultThreadNum();
+  if (!OnnxUtils::ConvertGeModelToModelProto(model, model_proto, encode_options)) {
     GELOGE(GRAPH_FAILED, "[Convert][GeModel] DumpGEGraphToOnnx failed.");
     return;
   }
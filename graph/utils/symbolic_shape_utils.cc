@@ -0,0 +1,689 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/utils/symbolic_shape_utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include "debug/ge_log.h"
+#include "debug/ge_op_types.h"
+#include "debug/ge_util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/node_utils.h"
+
+namespace ge {
+namespace {
+const std::string kAttrNameSymbolicShape = "_symbolic_shape";
+// set on a graph whose Data nodes were given symbols, the nodes of other graphs skip the symbolic inference
+const std::string kAttrNameHasSymbolicShape = "_has_symbolic_shape";
+const char *const kSymbolPrefix = "s";
+
+// output 0 has the shape of input 0
+const std::set<std::string> kElementwiseOpTypes{
+    DATA, "RefData", "Identity", "Relu", "Relu6", "LeakyRelu", "Elu", "Gelu", "Sigmoid", "Tanh", "Cast", "Abs",
+    "Neg", "Exp", "Log", "Sqrt", "Rsqrt", "Square", "Reciprocal", "Softmax", "SoftmaxV2", "LogSoftmaxV2", "BiasAdd"};
+// output 0 is the broadcast of all inputs
+const std::set<std::string> kBroadcastOpTypes{
+    "Add", "AddV2", "Sub", "Mul", "RealDiv", "Div", "FloorDiv", "Maximum", "Minimum", "Pow", "SquaredDifference",
+    "Equal", "NotEqual", "Less", "LessEqual", "Greater", "GreaterEqual", "LogicalAnd", "LogicalOr"};
+const std::set<std::string> kReshapeOpTypes{RESHAPE};
+const std::set<std::string> kConcatOpTypes{"Concat", "ConcatV2", "ConcatD", "ConcatV2D"};
+
+bool IsUnknownRank(const std::vector<int64_t> &dims) {
+  return (dims.size() == 1U) && (dims[0] == UNKNOWN_DIM_NUM);
+}
+
+bool ParseInt(const std::string &str, int64_t &value) {
+  if (str.empty() || (str.size() > 18U)) {
+    return false;
+  }
+  int64_t result = 0;
+  for (const auto c : str) {
+    if (!isdigit(static_cast<unsigned char>(c))) {
+      return false;
+    }
+    result = result * 10 + (c - '0');
+  }
+  value = result;
+  return true;
+}
+
+bool IsSymbolName(const std::string &str) {
+  if (str.empty() || (!isalpha(static_cast<unsigned char>(str[0])) && (str[0] != '_'))) {
+    return false;
+  }
+  for (const auto c : str) {
+    if (!isalnum(static_cast<unsigned char>(c)) && (c != '_')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// "3", "s0" or "3*s0"
+bool ParseTerm(const std::string &term, int64_t sign, SymbolicDim &dim) {
+  int64_t coef = 1;
+  std::string name = term;
+  const auto pos = term.find('*');
+  if (pos != std::string::npos) {
+    if (!ParseInt(term.substr(0U, pos), coef)) {
+      return false;
+    }
+    name = term.substr(pos + 1U);
+  } else if (ParseInt(term, coef)) {
+    dim = SymbolicDim(sign * coef);
+    return true;
+  }
+  if (!IsSymbolName(name)) {
+    return false;
+  }
+  dim = SymbolicDim::Symbol(name) * (sign * coef);
+  return true;
+}
+
+// the tensor an input of node reads, the output of the peer node or the input desc itself for graph inputs
+GeTensorDescPtr GetSourceDesc(const NodePtr &node, uint32_t index) {
+  const auto in_anchor = node->GetInDataAnchor(static_cast<int>(index));
+  const auto peer_out_anchor = (in_anchor == nullptr) ? nullptr : in_anchor->GetPeerOutAnchor();
+  if ((peer_out_anchor != nullptr) && (peer_out_anchor->GetOwnerNode() != nullptr)) {
+    const auto peer_op_desc = peer_out_anchor->GetOwnerNode()->GetOpDesc();
+    return (peer_op_desc == nullptr) ? nullptr :
+        peer_op_desc->MutableOutputDesc(static_cast<uint32_t>(peer_out_anchor->GetIdx()));
+  }
+  return node->GetOpDesc()->MutableInputDesc(index);
+}
+
+bool GetInputSymbolicShape(const NodePtr &node, uint32_t index, SymbolicShape &shape) {
+  const auto tensor_desc = GetSourceDesc(node, index);
+  if (tensor_desc == nullptr) {
+    return false;
+  }
+  if (SymbolicShapeUtils::GetSymbolicShape(*tensor_desc, shape)) {
+    return true;
+  }
+  // a fully known numeric shape is a symbolic shape of constants
+  const auto &dims = tensor_desc->GetShape().GetDims();
+  shape.clear();
+  for (const auto dim : dims) {
+    if (dim < 0) {
+      return false;
+    }
+    shape.emplace_back(SymbolicDim(dim));
+  }
+  return true;
+}
+
+bool HasSymbolicInput(const NodePtr &node) {
+  SymbolicShape shape;
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    const auto tensor_desc = GetSourceDesc(node, static_cast<uint32_t>(in_anchor->GetIdx()));
+    if ((tensor_desc != nullptr) && SymbolicShapeUtils::GetSymbolicShape(*tensor_desc, shape)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GetConstInputValues(const NodePtr &node, int32_t index, std::vector<int64_t> &values) {
+  const auto peer_node = NodeUtils::GetInDataNodeByIndex(*node, index);
+  if ((peer_node == nullptr) || ((peer_node->GetType() != CONSTANT) && (peer_node->GetType() != CONSTANTOP))) {
+    return false;
+  }
+  GeTensorPtr weight = nullptr;
+  if (!AttrUtils::MutableTensor(peer_node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight) || (weight == nullptr)) {
+    return false;
+  }
+  const auto data_type = weight->GetTensorDesc().GetDataType();
+  const auto data = weight->GetData().GetData();
+  const auto size = weight->GetData().GetSize();
+  values.clear();
+  if (data_type == DT_INT32) {
+    const auto int32_data = reinterpret_cast<const int32_t *>(data);
+    values.assign(int32_data, int32_data + size / sizeof(int32_t));
+  } else if (data_type == DT_INT64) {
+    const auto int64_data = reinterpret_cast<const int64_t *>(data);
+    values.assign(int64_data, int64_data + size / sizeof(int64_t));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool InferElementwise(const NodePtr &node, SymbolicShape &output) {
+  return GetInputSymbolicShape(node, 0U, output);
+}
+
+bool BroadcastDim(const SymbolicDim &left, const SymbolicDim &right, SymbolicDim &output) {
+  if ((left == right) || (left.IsConstant() && (left.GetConstant() == 1))) {
+    output = right;
+  } else if (right.IsConstant() && (right.GetConstant() == 1)) {
+    output = left;
+  } else if (left.IsConstant()) {
+    // the other side is either equal to it or 1
+    output = left;
+  } else if (right.IsConstant()) {
+    output = right;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool InferBroadcast(const NodePtr &node, SymbolicShape &output) {
+  output.clear();
+  const auto input_num = node->GetAllInDataAnchorsSize();
+  for (uint32_t i = 0U; i < input_num; ++i) {
+    SymbolicShape input;
+    if (!GetInputSymbolicShape(node, i, input)) {
+      return false;
+    }
+    if (input.size() > output.size()) {
+      output.insert(output.begin(), input.size() - output.size(), SymbolicDim(1));
+    }
+    const size_t offset = output.size() - input.size();
+    for (size_t j = 0U; j < input.size(); ++j) {
+      if (!BroadcastDim(output[offset + j], input[j], output[offset + j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool InferReshape(const NodePtr &node, SymbolicShape &output) {
+  int64_t axis = 0;
+  int64_t num_axes = -1;
+  (void)AttrUtils::GetInt(node->GetOpDesc(), "axis", axis);
+  (void)AttrUtils::GetInt(node->GetOpDesc(), "num_axes", num_axes);
+  std::vector<int64_t> shape_values;
+  if ((axis != 0) || (num_axes != -1) ||
+      (!GetConstInputValues(node, 1, shape_values) && !AttrUtils::GetListInt(node->GetOpDesc(), "shape", shape_values))) {
+    return false;
+  }
+  SymbolicShape input;
+  if (!GetInputSymbolicShape(node, 0U, input)) {
+    return false;
+  }
+  // the element count must be an affine expression, so at most one input dim may carry symbols
+  SymbolicDim symbolic_part(1);
+  int64_t const_part = 1;
+  for (const auto &dim : input) {
+    if (dim.IsConstant()) {
+      const_part *= dim.GetConstant();
+    } else if (symbolic_part.IsConstant()) {
+      symbolic_part = dim;
+    } else {
+      return false;
+    }
+  }
+  int64_t known_part = 1;
+  size_t unknown_index = shape_values.size();
+  output.clear();
+  for (size_t i = 0U; i < shape_values.size(); ++i) {
+    if (shape_values[i] == UNKNOWN_DIM) {
+      if (unknown_index != shape_values.size()) {
+        return false;
+      }
+      unknown_index = i;
+      output.emplace_back(SymbolicDim(UNKNOWN_DIM));
+    } else if (shape_values[i] < 0) {
+      return false;
+    } else {
+      known_part *= shape_values[i];
+      output.emplace_back(SymbolicDim(shape_values[i]));
+    }
+  }
+  if (unknown_index == shape_values.size()) {
+    return true;
+  }
+  if (known_part == 0) {
+    return false;
+  }
+  const SymbolicDim element_num = symbolic_part * const_part;
+  return element_num.DivExactly(known_part, output[unknown_index]);
+}
+
+bool InferConcat(const NodePtr &node, SymbolicShape &output) {
+  const auto &type = node->GetType();
+  const auto input_num = static_cast<int32_t>(node->GetAllInDataAnchorsSize());
+  int32_t first_input = 0;
+  int32_t end_input = input_num;
+  std::vector<int64_t> axis_values;
+  if ((type == "ConcatD") || (type == "ConcatV2D")) {
+    int64_t concat_dim = 0;
+    if (!AttrUtils::GetInt(node->GetOpDesc(), "concat_dim", concat_dim)) {
+      return false;
+    }
+    axis_values.emplace_back(concat_dim);
+  } else if (type == "ConcatV2") {
+    end_input = input_num - 1;
+    if (!GetConstInputValues(node, end_input, axis_values)) {
+      return false;
+    }
+  } else {
+    first_input = 1;
+    if (!GetConstInputValues(node, 0, axis_values)) {
+      return false;
+    }
+  }
+  if ((axis_values.size() != 1U) || (first_input >= end_input)) {
+    return false;
+  }
+  int64_t axis = axis_values[0];
+  output.clear();
+  for (int32_t i = first_input; i < end_input; ++i) {
+    SymbolicShape input;
+    if (!GetInputSymbolicShape(node, static_cast<uint32_t>(i), input)) {
+      return false;
+    }
+    if (i == first_input) {
+      const auto rank = static_cast<int64_t>(input.size());
+      axis = (axis < 0) ? (axis + rank) : axis;
+      if ((axis < 0) || (axis >= rank)) {
+        return false;
+      }
+      output = input;
+      continue;
+    }
+    if (input.size() != output.size()) {
+      return false;
+    }
+    for (size_t j = 0U; j < input.size(); ++j) {
+      if (static_cast<int64_t>(j) == axis) {
+        output[j] = output[j] + input[j];
+      } else if (output[j] != input[j]) {
+        // the dims must be equal, prefer the one known as a number
+        if (!output[j].IsConstant() && !input[j].IsConstant()) {
+          return false;
+        }
+        output[j] = output[j].IsConstant() ? output[j] : input[j];
+      }
+    }
+  }
+  return true;
+}
+
+bool InferOutputSymbolicShape(const NodePtr &node, SymbolicShape &output) {
+  const auto &type = node->GetType();
+  if (kElementwiseOpTypes.count(type) > 0U) {
+    return InferElementwise(node, output);
+  }
+  if (kBroadcastOpTypes.count(type) > 0U) {
+    return InferBroadcast(node, output);
+  }
+  if (kReshapeOpTypes.count(type) > 0U) {
+    return InferReshape(node, output);
+  }
+  if (kConcatOpTypes.count(type) > 0U) {
+    return InferConcat(node, output);
+  }
+  return false;
+}
+
+// the numeric shape from the infer func is trusted, a derived dim only fills in what it left unknown
+bool MergeNumericShape(const std::vector<int64_t> &dims, SymbolicShape &shape) {
+  if (IsUnknownRank(dims)) {
+    return true;
+  }
+  if (dims.size() != shape.size()) {
+    return false;
+  }
+  for (size_t i = 0U; i < dims.size(); ++i) {
+    if (dims[i] < 0) {
+      continue;
+    }
+    if (shape[i].IsConstant() && (shape[i].GetConstant() != dims[i])) {
+      return false;
+    }
+    shape[i] = SymbolicDim(dims[i]);
+  }
+  return true;
+}
+
+// a non null batch_symbol gives dim 0 of every Data node the same symbol, it is created on first use
+graphStatus AssignDataSymbols(const ComputeGraphPtr &graph, SymbolTable &table, std::string *batch_symbol) {
+  GE_CHECK_NOTNULL(graph);
+  for (const auto &node : graph->GetDirectNode()) {
+    if (node->GetType() != DATA) {
+      continue;
+    }
+    const auto op_desc = node->GetOpDesc();
+    GE_CHECK_NOTNULL(op_desc);
+    const auto input_desc = op_desc->MutableInputDesc(0U);
+    const auto output_desc = op_desc->MutableOutputDesc(0U);
+    if ((input_desc == nullptr) || (output_desc == nullptr)) {
+      continue;
+    }
+    const auto &dims = output_desc->GetShape().GetDims();
+    if (IsUnknownRank(dims)) {
+      GELOGD("Data %s is of unknown rank, no symbol assigned.", node->GetName().c_str());
+      continue;
+    }
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    (void)output_desc->GetShapeRange(ranges);
+    SymbolicShape shape;
+    bool has_symbol = false;
+    for (size_t i = 0U; i < dims.size(); ++i) {
+      if (dims[i] >= 0) {
+        shape.emplace_back(SymbolicDim(dims[i]));
+        continue;
+      }
+      has_symbol = true;
+      const auto range = (ranges.size() == dims.size()) ? ranges[i] : std::pair<int64_t, int64_t>(1, -1);
+      if ((i == 0U) && (batch_symbol != nullptr)) {
+        if (batch_symbol->empty()) {
+          *batch_symbol = table.NewSymbol(node->GetName(), i, range);
+        }
+        shape.emplace_back(SymbolicDim::Symbol(*batch_symbol));
+        continue;
+      }
+      shape.emplace_back(SymbolicDim::Symbol(table.NewSymbol(node->GetName(), i, range)));
+    }
+    if (!has_symbol) {
+      continue;
+    }
+    if (!SymbolicShapeUtils::SetSymbolicShape(*input_desc, shape) ||
+        !SymbolicShapeUtils::SetSymbolicShape(*output_desc, shape) ||
+        !AttrUtils::SetBool(graph, kAttrNameHasSymbolicShape, true)) {
+      REPORT_CALL_ERROR("E19999", "Set symbolic shape to data %s failed.", node->GetName().c_str());
+      GELOGE(GRAPH_FAILED, "[Set][SymbolicShape] to data %s failed.", node->GetName().c_str());
+      return GRAPH_FAILED;
+    }
+  }
+  return GRAPH_SUCCESS;
+}
+
+struct InstantiatedTensor {
+  GeTensorDescPtr tensor_desc;
+  std::vector<int64_t> dims;
+};
+
+// evaluates the shape of source with symbol_values into the dims to write to dst, source and dst may be the same
+// desc. Nothing is added if source has no symbolic shape, false if dst then still has an unknown dim
+bool EvaluateTensor(const GeTensorDesc &source, const std::map<std::string, int64_t> &symbol_values,
+                    const GeTensorDescPtr &dst, std::vector<InstantiatedTensor> &tensors) {
+  SymbolicShape shape;
+  if (!SymbolicShapeUtils::GetSymbolicShape(source, shape)) {
+    // only a tensor that needs no symbol is fine as it is
+    const auto &dims = dst->GetShape().GetDims();
+    return std::all_of(dims.begin(), dims.end(), [](int64_t dim) { return dim >= 0; });
+  }
+  InstantiatedTensor tensor;
+  tensor.tensor_desc = dst;
+  tensor.dims.resize(shape.size());
+  for (size_t i = 0U; i < shape.size(); ++i) {
+    if (!shape[i].Evaluate(symbol_values, tensor.dims[i]) || (tensor.dims[i] < 0)) {
+      GELOGI("Symbolic dim %s has no valid value.", shape[i].ToString().c_str());
+      return false;
+    }
+  }
+  tensors.emplace_back(std::move(tensor));
+  return true;
+}
+
+void WriteTensor(const InstantiatedTensor &tensor) {
+  GeTensorDesc &dst = *tensor.tensor_desc;
+  // the dims of another format are not the same as the dims of the shape even at the same rank
+  if ((dst.GetOriginFormat() == dst.GetFormat()) && (dst.GetOriginShape().GetDimNum() == tensor.dims.size())) {
+    dst.SetOriginShape(GeShape(tensor.dims));
+  }
+  dst.SetShape(GeShape(tensor.dims));
+  (void)dst.SetShapeRange(std::vector<std::pair<int64_t, int64_t>>());
+}
+}  // namespace
+
+SymbolicDim SymbolicDim::Symbol(const std::string &name) {
+  SymbolicDim dim;
+  dim.terms_[name] = 1;
+  return dim;
+}
+
+bool SymbolicDim::Parse(const std::string &str, SymbolicDim &dim) {
+  dim = SymbolicDim();
+  size_t begin = 0U;
+  int64_t sign = 1;
+  if (!str.empty() && (str[0] == '-')) {
+    sign = -1;
+    begin = 1U;
+  }
+  while (begin <= str.size()) {
+    size_t end = str.find_first_of("+-", begin);
+    end = (end == std::string::npos) ? str.size() : end;
+    SymbolicDim term;
+    if (!ParseTerm(str.substr(begin, end - begin), sign, term)) {
+      return false;
+    }
+    dim = dim + term;
+    if (end == str.size()) {
+      return true;
+    }
+    sign = (str[end] == '-') ? -1 : 1;
+    begin = end + 1U;
+  }
+  return false;
+}
+
+std::string SymbolicDim::ToString() const {
+  std::string str;
+  for (const auto &term : terms_) {
+    if (term.second < 0) {
+      str += "-";
+    } else if (!str.empty()) {
+      str += "+";
+    }
+    const int64_t coef = (term.second < 0) ? -term.second : term.second;
+    if (coef != 1) {
+      str += std::to_string(coef) + "*";
+    }
+    str += term.first;
+  }
+  if (str.empty()) {
+    return std::to_string(constant_);
+  }
+  if (constant_ > 0) {
+    str += "+" + std::to_string(constant_);
+  } else if (constant_ < 0) {
+    str += std::to_string(constant_);
+  }
+  return str;
+}
+
+bool SymbolicDim::Evaluate(const std::map<std::string, int64_t> &symbol_values, int64_t &value) const {
+  value = constant_;
+  for (const auto &term : terms_) {
+    const auto iter = symbol_values.find(term.first);
+    if (iter == symbol_values.end()) {
+      return false;
+    }
+    value += term.second * iter->second;
+  }
+  return true;
+}
+
+SymbolicDim SymbolicDim::operator+(const SymbolicDim &other) const {
+  SymbolicDim result = *this;
+  result.constant_ += other.constant_;
+  for (const auto &term : other.terms_) {
+    const int64_t coef = (result.terms_[term.first] += term.second);
+    if (coef == 0) {
+      (void)result.terms_.erase(term.first);
+    }
+  }
+  return result;
+}
+
+SymbolicDim SymbolicDim::operator*(int64_t factor) const {
+  SymbolicDim result;
+  if (factor == 0) {
+    return result;
+  }
+  result.constant_ = constant_ * factor;
+  for (const auto &term : terms_) {
+    result.terms_[term.first] = term.second * factor;
+  }
+  return result;
+}
+
+bool SymbolicDim::DivExactly(int64_t divisor, SymbolicDim &result) const {
+  if ((divisor == 0) || ((constant_ % divisor) != 0)) {
+    return false;
+  }
+  for (const auto &term : terms_) {
+    if ((term.second % divisor) != 0) {
+      return false;
+    }
+  }
+  SymbolicDim quotient;
+  quotient.constant_ = constant_ / divisor;
+  for (const auto &term : terms_) {
+    quotient.terms_[term.first] = term.second / divisor;
+  }
+  result = quotient;
+  return true;
+}
+
+std::string SymbolTable::NewSymbol(const std::string &node_name, size_t dim_index,
+                                   const std::pair<int64_t, int64_t> &range) {
+  SymbolInfo info;
+  info.name = kSymbolPrefix + std::to_string(symbols_.size());
+  info.node_name = node_name;
+  info.dim_index = dim_index;
+  info.range = range;
+  symbols_.emplace_back(info);
+  return info.name;
+}
+
+bool SymbolicShapeUtils::GetSymbolicShape(const GeTensorDesc &tensor_desc, SymbolicShape &shape) {
+  std::vector<std::string> dim_strs;
+  if (!AttrUtils::GetListStr(tensor_desc, kAttrNameSymbolicShape, dim_strs) || dim_strs.empty()) {
+    return false;
+  }
+  const auto &dims = tensor_desc.GetShape().GetDims();
+  if (!IsUnknownRank(dims) && (dims.size() != dim_strs.size())) {
+    GELOGD("Symbolic shape rank %zu differs from shape rank %zu, ignore it.", dim_strs.size(), dims.size());
+    return false;
+  }
+  shape.resize(dim_strs.size());
+  for (size_t i = 0U; i < dim_strs.size(); ++i) {
+    if (!SymbolicDim::Parse(dim_strs[i], shape[i])) {
+      GELOGW("[Parse][SymbolicDim] Invalid symbolic dim %s.", dim_strs[i].c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SymbolicShapeUtils::SetSymbolicShape(GeTensorDesc &tensor_desc, const SymbolicShape &shape) {
+  std::vector<std::string> dim_strs;
+  for (const auto &dim : shape) {
+    dim_strs.emplace_back(dim.ToString());
+  }
+  return AttrUtils::SetListStr(tensor_desc, kAttrNameSymbolicShape, dim_strs);
+}
+
+void SymbolicShapeUtils::ClearSymbolicShape(GeTensorDesc &tensor_desc) {
+  // an empty list stands for no symbolic shape, the attr is not removable through GeTensorDesc
+  if (AttrUtils::HasAttr(tensor_desc, kAttrNameSymbolicShape)) {
+    (void)AttrUtils::SetListStr(tensor_desc, kAttrNameSymbolicShape, std::vector<std::string>());
+  }
+}
+
+graphStatus SymbolicShapeUtils::AssignInputSymbols(const ComputeGraphPtr &graph, SymbolTable &table) {
+  return AssignDataSymbols(graph, table, nullptr);
+}
+
+graphStatus SymbolicShapeUtils::AssignBatchSymbol(const ComputeGraphPtr &graph, SymbolTable &table,
+                                                  std::string &batch_symbol) {
+  batch_symbol.clear();
+  return AssignDataSymbols(graph, table, &batch_symbol);
+}
+
+graphStatus SymbolicShapeUtils::InstantiateShapes(const ComputeGraphPtr &graph,
+                                                  const std::map<std::string, int64_t> &symbol_values) {
+  GE_CHECK_NOTNULL(graph);
+  // every tensor is evaluated before any is written, so a graph that needs the full inference is left untouched
+  std::vector<InstantiatedTensor> tensors;
+  for (const auto &node : graph->GetAllNodes()) {
+    const auto op_desc = node->GetOpDesc();
+    GE_CHECK_NOTNULL(op_desc);
+    for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+      const auto output_desc = op_desc->MutableOutputDesc(static_cast<uint32_t>(out_anchor->GetIdx()));
+      if ((output_desc != nullptr) && !EvaluateTensor(*output_desc, symbol_values, output_desc, tensors)) {
+        GELOGI("Output %d of %s can not be instantiated without inference.", out_anchor->GetIdx(),
+               node->GetName().c_str());
+        return GRAPH_PARAM_INVALID;
+      }
+    }
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      const auto input_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(in_anchor->GetIdx()));
+      const auto source_desc = GetSourceDesc(node, static_cast<uint32_t>(in_anchor->GetIdx()));
+      if ((input_desc != nullptr) && (source_desc != nullptr) &&
+          !EvaluateTensor(*source_desc, symbol_values, input_desc, tensors)) {
+        GELOGI("Input %d of %s can not be instantiated without inference.", in_anchor->GetIdx(),
+               node->GetName().c_str());
+        return GRAPH_PARAM_INVALID;
+      }
+    }
+  }
+  for (const auto &tensor : tensors) {
+    WriteTensor(tensor);
+  }
+  return GRAPH_SUCCESS;
+}
+
+graphStatus SymbolicShapeUtils::InferSymbolicShape(const NodePtr &node) {
+  GE_CHECK_NOTNULL(node);
+  const auto op_desc = node->GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  const auto output_desc = op_desc->MutableOutputDesc(0U);
+  const auto graph = node->GetOwnerComputeGraph();
+  // one attr of the graph is read instead of the attrs of every input and output of a node without symbols
+  if ((output_desc == nullptr) || (graph == nullptr) || !AttrUtils::HasAttr(graph, kAttrNameHasSymbolicShape)) {
+    return GRAPH_SUCCESS;
+  }
+  SymbolicShape output;
+  if (!HasSymbolicInput(node) || !InferOutputSymbolicShape(node, output) ||
+      !MergeNumericShape(output_desc->GetShape().GetDims(), output)) {
+    // falls back to the numeric shape
+    for (const auto &tensor_desc : op_desc->GetAllOutputsDescPtr()) {
+      ClearSymbolicShape(*tensor_desc);
+    }
+    return GRAPH_SUCCESS;
+  }
+  bool has_symbol = false;
+  for (const auto &dim : output) {
+    has_symbol = has_symbol || !dim.IsConstant();
+  }
+  if (!has_symbol) {
+    ClearSymbolicShape(*output_desc);
+    return GRAPH_SUCCESS;
+  }
+  if (!SetSymbolicShape(*output_desc, output)) {
+    REPORT_CALL_ERROR("E19999", "Set symbolic shape to node %s failed.", node->GetName().c_str());
+    GELOGE(GRAPH_FAILED, "[Set][SymbolicShape] to node %s failed.", node->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  std::string shape_str;
+  for (const auto &dim : output) {
+    shape_str += (shape_str.empty() ? "" : ",") + dim.ToString();
+  }
+  GELOGD("Symbolic shape of %s output 0 is [%s].", node->GetName().c_str(), shape_str.c_str());
+  return GRAPH_SUCCESS;
+}
+}  // namespace ge
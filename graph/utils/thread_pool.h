@@ -0,0 +1,143 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_GRAPH_UTILS_THREAD_POOL_H_
+#define COMMON_GRAPH_UTILS_THREAD_POOL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ge {
+/// Fixed size worker pool used by the parallel graph utilities.
+/// Usage:
+///   GraphThreadPool pool(4);
+///   auto fut = pool.Commit([]() { return 1; });
+///   pool.ParallelFor(total, [&](size_t begin, size_t end) { ... });
+/// ParallelFor blocks until every shard is finished, so it must not be called from a pool worker.
+class GraphThreadPool {
+ public:
+  explicit GraphThreadPool(uint32_t size) : is_stopped_(false) {
+    if (size == 0U) {
+      size = 1U;
+    }
+    for (uint32_t i = 0U; i < size; ++i) {
+      try {
+        workers_.emplace_back(&GraphThreadPool::WorkerLoop, this);
+      } catch (...) {
+        // run with the workers we already have, Commit falls back to the caller thread when there is none
+        break;
+      }
+    }
+  }
+
+  ~GraphThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopped_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  GraphThreadPool(const GraphThreadPool &) = delete;
+  GraphThreadPool &operator=(const GraphThreadPool &) = delete;
+
+  template <class Func, class... Args>
+  auto Commit(Func &&func, Args &&... args) -> std::future<decltype(func(args...))> {
+    using RetType = decltype(func(args...));
+    auto task = std::make_shared<std::packaged_task<RetType()>>(
+        std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
+    auto future = task->get_future();
+    if (workers_.empty()) {
+      (*task)();
+      return future;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cond_.notify_one();
+    return future;
+  }
+
+  /// Splits [0, total) into contiguous shards and calls func(begin, end) for each of them.
+  /// The calling thread runs the first shard itself.
+  void ParallelFor(size_t total, const std::function<void(size_t, size_t)> &func) {
+    if (total == 0U) {
+      return;
+    }
+    const size_t shard_num = std::min(total, static_cast<size_t>(GetThreadNum()) + 1U);
+    const size_t shard_size = (total + shard_num - 1U) / shard_num;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = shard_size; begin < total; begin += shard_size) {
+      const size_t end = std::min(total, begin + shard_size);
+      futures.emplace_back(Commit([&func, begin, end]() { func(begin, end); }));
+    }
+    func(0U, std::min(total, shard_size));
+    for (auto &future : futures) {
+      future.get();
+    }
+  }
+
+  uint32_t GetThreadNum() const {
+    return static_cast<uint32_t>(workers_.size());
+  }
+
+  static uint32_t GetDefaultThreadNum() {
+    const uint32_t default_thread_num = 4U;
+    const uint32_t max_thread_num = 16U;
+    const uint32_t hardware_num = std::thread::hardware_concurrency();
+    return (hardware_num == 0U) ? default_thread_num : std::min(hardware_num, max_thread_num);
+  }
+
+ private:
+  void WorkerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return is_stopped_ || !tasks_.empty(); });
+        if (is_stopped_ && tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool is_stopped_;
+};
+}  // namespace ge
+
+#endif  // COMMON_GRAPH_UTILS_THREAD_POOL_H_
@@ -187,18 +187,22 @@ graphStatus TuningUtils::MakeExeGraph(ComputeGraphPtr &exe_graph,
 
 void TuningUtils::DumpGraphToPath(ComputeGraphPtr &exe_graph, int64_t index,
                                   bool is_tuning_graph, std::string path) {
+  // ConvertFileToGraph loads either format, binary files are much faster for big subgraphs
+  const std::string file_ext = GraphUtils::IsDumpGraphInBinary() ? ".bin" : ".txt";
   if (!path.empty()) {
     if (is_tuning_graph) {
-      GraphUtils::DumpGEGraph(exe_graph, "", true, path + tuning_subgraph_prefix + std::to_string(index) + ".txt");
+      GraphUtils::DumpGEGraph(exe_graph, "", true, path + tuning_subgraph_prefix + std::to_string(index) + file_ext);
     } else {
-      GraphUtils::DumpGEGraph(exe_graph, "", true, path + non_tuning_subgraph_prefix + std::to_string(index) + ".txt");
+      GraphUtils::DumpGEGraph(exe_graph, "", true,
+                              path + non_tuning_subgraph_prefix + std::to_string(index) + file_ext);
     }
   } else {
     path = "./";
     if (is_tuning_graph) {
-      GraphUtils::DumpGEGraph(exe_graph, "", true, path + tuning_subgraph_prefix + std::to_string(index) + ".txt");
+      GraphUtils::DumpGEGraph(exe_graph, "", true, path + tuning_subgraph_prefix + std::to_string(index) + file_ext);
     } else {
-      GraphUtils::DumpGEGraph(exe_graph, "", true, path + non_tuning_subgraph_prefix + std::to_string(index) + ".txt");
+      GraphUtils::DumpGEGraph(exe_graph, "", true,
+                              path + non_tuning_subgraph_prefix + std::to_string(index) + file_ext);
     }
   }
 }
@@ -0,0 +1,261 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/utils/value_range_utils.h"
+
+#include <limits>
+#include "debug/ge_log.h"
+#include "debug/ge_op_types.h"
+#include "debug/ge_util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/op_desc_utils.h"
+
+namespace ge {
+namespace {
+// value ranges are kept in the tensor descs and so in the model, only shape like values are worth it
+const size_t kMaxValueRangeNum = 64U;
+
+bool IsConstType(const std::string &type) {
+  return (type == CONSTANT) || (type == CONSTANTOP);
+}
+
+int64_t GetElementNum(const GeShape &shape) {
+  return (shape.GetDimNum() == 0U) ? 1 : shape.GetShapeSize();
+}
+
+bool GetConstValueRange(const NodePtr &node, ValueRange &value_range) {
+  GeTensorPtr weight = nullptr;
+  if (!AttrUtils::MutableTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight) || (weight == nullptr)) {
+    return false;
+  }
+  const auto data_type = weight->GetTensorDesc().GetDataType();
+  const auto data = weight->GetData().GetData();
+  const auto size = weight->GetData().GetSize();
+  value_range.clear();
+  const size_t element_size = (data_type == DT_INT32) ? sizeof(int32_t) : sizeof(int64_t);
+  if (size / element_size > kMaxValueRangeNum) {
+    return false;
+  }
+  if (data_type == DT_INT32) {
+    const auto int32_data = reinterpret_cast<const int32_t *>(data);
+    for (size_t i = 0U; i < size / sizeof(int32_t); ++i) {
+      value_range.emplace_back(int32_data[i], int32_data[i]);
+    }
+  } else if (data_type == DT_INT64) {
+    const auto int64_data = reinterpret_cast<const int64_t *>(data);
+    for (size_t i = 0U; i < size / sizeof(int64_t); ++i) {
+      value_range.emplace_back(int64_data[i], int64_data[i]);
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// value ranges of the inputs are taken from the producers, the ones left from a former run are dropped
+void FeedInputValueRanges(const NodePtr &node, bool &all_has_range, bool &any_has_range, bool &any_dynamic) {
+  all_has_range = true;
+  any_has_range = false;
+  any_dynamic = false;
+  const auto op_desc = node->GetOpDesc();
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    const auto input_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(in_anchor->GetIdx()));
+    if (input_desc == nullptr) {
+      continue;
+    }
+    any_dynamic = any_dynamic || input_desc->GetShape().IsUnknownShape();
+    ValueRange value_range;
+    const auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    const bool has_range = (peer_out_anchor != nullptr) &&
+        ValueRangeUtils::GetOutputValueRange(peer_out_anchor->GetOwnerNode(),
+                                             static_cast<uint32_t>(peer_out_anchor->GetIdx()), value_range) &&
+        (value_range.size() <= kMaxValueRangeNum);
+    all_has_range = all_has_range && has_range;
+    any_has_range = any_has_range || has_range;
+    (void)input_desc->SetValueRange(has_range ? value_range : ValueRange());
+  }
+}
+
+bool IsFoldable(const NodePtr &node) {
+  const auto op_desc = node->GetOpDesc();
+  return (op_desc->GetOutputsSize() == 1U) && op_desc->GetSubgraphInstanceNames().empty() &&
+         (node->GetType() != NETOUTPUT) && (node->GetType() != DATA);
+}
+}  // namespace
+
+bool ValueRangeUtils::GetOutputValueRange(const NodePtr &node, uint32_t out_idx, ValueRange &value_range) {
+  if ((node == nullptr) || (node->GetOpDesc() == nullptr)) {
+    return false;
+  }
+  if (IsConstType(node->GetType())) {
+    return GetConstValueRange(node, value_range);
+  }
+  const auto output_desc = node->GetOpDesc()->MutableOutputDesc(out_idx);
+  value_range.clear();
+  if ((output_desc == nullptr) || (output_desc->GetValueRange(value_range) != GRAPH_SUCCESS)) {
+    return false;
+  }
+  return !value_range.empty();
+}
+
+bool ValueRangeUtils::IsValueKnown(const GeTensorDesc &desc, const ValueRange &value_range) {
+  const auto &shape = desc.GetShape();
+  if (shape.IsUnknownShape() || (GetElementNum(shape) != static_cast<int64_t>(value_range.size()))) {
+    return false;
+  }
+  for (const auto &range : value_range) {
+    if (range.first != range.second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+graphStatus ValueRangeUtils::InferValueRange(const ComputeGraphPtr &graph, bool fold_known_values,
+                                             size_t &folded_num) {
+  GE_CHECK_NOTNULL(graph);
+  folded_num = 0U;
+  if (graph->TopologicalSorting() != GRAPH_SUCCESS) {
+    REPORT_CALL_ERROR("E19999", "Topological sort graph %s failed.", graph->GetName().c_str());
+    GELOGE(GRAPH_FAILED, "[Sort][Graph] %s failed.", graph->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  // the nodes are taken before folding changes the node list of graph
+  const auto nodes = graph->GetDirectNode();
+  for (const auto &node : nodes) {
+    GE_CHECK_NOTNULL(node);
+    const auto op_desc = node->GetOpDesc();
+    GE_CHECK_NOTNULL(op_desc);
+    if (IsConstType(node->GetType())) {
+      continue;
+    }
+    const auto para = OperatorFactoryImpl::GetInferValueRangePara(node->GetType());
+    if (!para.is_initialized || (para.infer_value_func == nullptr)) {
+      continue;
+    }
+    bool all_has_range = true;
+    bool any_has_range = false;
+    bool any_dynamic = false;
+    FeedInputValueRanges(node, all_has_range, any_has_range, any_dynamic);
+    if ((para.when_call == INPUT_HAS_VALUE_RANGE) ? !all_has_range : !(any_dynamic || any_has_range)) {
+      GELOGD("Skip inferring value range of node %s, when_call:%d.", node->GetName().c_str(), para.when_call);
+      continue;
+    }
+
+    Operator op = OpDescUtils::GetOperatorViewFromNode(node);
+    const auto ret = op_desc->CallInferValueRangeFunc(op);
+    if (ret != GRAPH_SUCCESS) {
+      REPORT_CALL_ERROR("E19999", "Infer value range of node %s(%s) failed, ret:%u.", node->GetName().c_str(),
+                        node->GetType().c_str(), ret);
+      GELOGE(GRAPH_FAILED, "[Infer][ValueRange] of node %s(%s) failed, ret:%u.", node->GetName().c_str(),
+             node->GetType().c_str(), ret);
+      return GRAPH_FAILED;
+    }
+
+    ValueRange output_range;
+    if (!fold_known_values || !IsFoldable(node) || !GetOutputValueRange(node, 0U, output_range) ||
+        !IsValueKnown(op_desc->GetOutputDesc(0U), output_range)) {
+      continue;
+    }
+    NodePtr const_node = nullptr;
+    const auto fold_ret = FoldToConst(node, output_range, const_node);
+    if (fold_ret == GRAPH_PARAM_INVALID) {
+      continue;
+    }
+    if (fold_ret != GRAPH_SUCCESS) {
+      GELOGE(fold_ret, "[Fold][Const] node %s in graph %s failed.", node->GetName().c_str(),
+             graph->GetName().c_str());
+      return fold_ret;
+    }
+    ++folded_num;
+  }
+  GELOGI("Infer value range of graph %s end, %zu nodes folded.", graph->GetName().c_str(), folded_num);
+  return GRAPH_SUCCESS;
+}
+
+graphStatus ValueRangeUtils::FoldToConst(const NodePtr &node, const ValueRange &value_range, NodePtr &const_node) {
+  GE_CHECK_NOTNULL(node);
+  const auto op_desc = node->GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  const auto graph = node->GetOwnerComputeGraph();
+  GE_CHECK_NOTNULL(graph);
+  const auto output_desc = op_desc->MutableOutputDesc(0U);
+  GE_CHECK_NOTNULL(output_desc);
+  if (!IsValueKnown(*output_desc, value_range)) {
+    GELOGW("[Fold][Const] value of node %s is not known.", node->GetName().c_str());
+    return GRAPH_PARAM_INVALID;
+  }
+
+  GeTensorDesc tensor_desc(output_desc->GetShape(), output_desc->GetFormat(), output_desc->GetDataType());
+  tensor_desc.SetOriginShape(output_desc->GetOriginShape());
+  tensor_desc.SetOriginFormat(output_desc->GetOriginFormat());
+  tensor_desc.SetOriginDataType(output_desc->GetOriginDataType());
+  GeTensorPtr tensor = nullptr;
+  if (output_desc->GetDataType() == DT_INT32) {
+    std::vector<int32_t> values;
+    for (const auto &range : value_range) {
+      if ((range.first < std::numeric_limits<int32_t>::min()) || (range.first > std::numeric_limits<int32_t>::max())) {
+        GELOGW("[Fold][Const] value %ld of node %s overflows int32.", range.first, node->GetName().c_str());
+        return GRAPH_PARAM_INVALID;
+      }
+      values.emplace_back(static_cast<int32_t>(range.first));
+    }
+    tensor = ComGraphMakeShared<GeTensor>(tensor_desc, reinterpret_cast<const uint8_t *>(values.data()),
+                                          values.size() * sizeof(int32_t));
+  } else if (output_desc->GetDataType() == DT_INT64) {
+    std::vector<int64_t> values;
+    for (const auto &range : value_range) {
+      values.emplace_back(range.first);
+    }
+    tensor = ComGraphMakeShared<GeTensor>(tensor_desc, reinterpret_cast<const uint8_t *>(values.data()),
+                                          values.size() * sizeof(int64_t));
+  } else {
+    GELOGD("Node %s of data type %d is not folded.", node->GetName().c_str(), output_desc->GetDataType());
+    return GRAPH_PARAM_INVALID;
+  }
+  GE_CHECK_NOTNULL(tensor);
+  const auto const_desc = OpDescUtils::CreateConstOp(tensor);
+  GE_CHECK_NOTNULL(const_desc);
+  const_node = graph->AddNode(const_desc);
+  GE_CHECK_NOTNULL(const_node);
+
+  if (GraphUtils::ReplaceNodeAnchors(const_node, node, {}, {0}) != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "[Replace][NodeAnchors] from %s to %s failed.", node->GetName().c_str(),
+           const_node->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  // the control edges are copied to the const node, the ones left on node go with it
+  for (const auto &in_anchor : node->GetAllInAnchors()) {
+    in_anchor->UnlinkAll();
+  }
+  for (const auto &out_anchor : node->GetAllOutAnchors()) {
+    out_anchor->UnlinkAll();
+  }
+  if (GraphUtils::RemoveNodeWithoutRelink(graph, node) != GRAPH_SUCCESS) {
+    REPORT_CALL_ERROR("E19999", "Remove node %s from graph %s failed.", node->GetName().c_str(),
+                      graph->GetName().c_str());
+    GELOGE(GRAPH_FAILED, "[Remove][Node] %s from graph %s failed.", node->GetName().c_str(),
+           graph->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  GELOGD("Node %s is folded to const %s.", node->GetName().c_str(), const_node->GetName().c_str());
+  return GRAPH_SUCCESS;
+}
+}  // namespace ge
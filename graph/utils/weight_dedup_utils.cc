@@ -0,0 +1,255 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/utils/weight_dedup_utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include "debug/ge_log.h"
+#include "debug/ge_util.h"
+#include "proto/ge_ir.pb.h"
+#include "utils/tensor_utils.h"
+
+namespace ge {
+namespace {
+const char *const kAttrSharedWeightPool = "_shared_weight_pool";
+const char *const kAttrSharedWeightIndex = "_shared_weight_index";
+
+const uint64_t kHashPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kHashPrime3 = 0x165667B19E3779F9ULL;
+const size_t kHashLaneNum = 4U;
+const size_t kHashStripeSize = kHashLaneNum * sizeof(uint64_t);
+
+inline uint64_t RotateLeft(uint64_t value, uint32_t bits) {
+  return (value << bits) | (value >> (64U - bits));
+}
+
+inline uint64_t LoadWord(const uint8_t *data) {
+  uint64_t word = 0U;
+  (void)memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+inline uint64_t MixWord(uint64_t acc, uint64_t word) {
+  return RotateLeft(acc + (word * kHashPrime2), 31U) * kHashPrime1;
+}
+
+struct BlobRef {
+  const uint8_t *data;
+  size_t size;
+};
+
+/// Groups blobs with identical bytes, returns the group of each blob in visiting order
+class BlobGrouper {
+ public:
+  size_t Add(const BlobRef &blob) {
+    auto &candidates = hash_to_groups_[WeightDedupUtils::HashData(blob.data, blob.size)];
+    for (const auto group : candidates) {
+      const auto &head = group_heads_[group];
+      if ((head.size == blob.size) && (memcmp(head.data, blob.data, blob.size) == 0)) {
+        return group;
+      }
+    }
+    candidates.emplace_back(group_heads_.size());
+    group_heads_.emplace_back(blob);
+    return group_heads_.size() - 1U;
+  }
+
+  size_t GetGroupNum() const {
+    return group_heads_.size();
+  }
+
+ private:
+  std::unordered_map<uint64_t, std::vector<size_t>> hash_to_groups_;
+  std::vector<BlobRef> group_heads_;
+};
+
+void VisitAttrTensors(google::protobuf::Map<std::string, proto::AttrDef> &attrs,
+                      const std::function<void(proto::TensorDef &)> &visitor) {
+  // the map iterates in hash order, sorting the keys keeps the pool layout stable between runs
+  std::vector<std::string> names;
+  names.reserve(attrs.size());
+  for (const auto &attr : attrs) {
+    if (attr.second.has_t() || (attr.second.has_list() && (attr.second.list().t_size() > 0))) {
+      names.emplace_back(attr.first);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  for (const auto &name : names) {
+    auto &attr = attrs[name];
+    if (attr.has_t()) {
+      visitor(*attr.mutable_t());
+      continue;
+    }
+    for (auto &tensor : *attr.mutable_list()->mutable_t()) {
+      visitor(tensor);
+    }
+  }
+}
+
+void VisitModelTensors(proto::ModelDef &model_def, const std::function<void(proto::TensorDef &)> &visitor) {
+  for (auto &graph_def : *model_def.mutable_graph()) {
+    for (auto &op_def : *graph_def.mutable_op()) {
+      VisitAttrTensors(*op_def.mutable_attr(), visitor);
+    }
+  }
+}
+}  // namespace
+
+uint64_t WeightDedupUtils::HashData(const uint8_t *data, size_t size) {
+  uint64_t hash = kHashPrime3 + static_cast<uint64_t>(size);
+  if (data == nullptr) {
+    return hash;
+  }
+  size_t offset = 0U;
+  if (size >= kHashStripeSize) {
+    // independent lanes keep several multiplications in flight, the loop is what makes the hash cheap on
+    // weights of hundreds of megabytes
+    uint64_t lanes[kHashLaneNum] = {kHashPrime1 + kHashPrime2, kHashPrime2, 0U, 0U - kHashPrime1};
+    for (; (offset + kHashStripeSize) <= size; offset += kHashStripeSize) {
+      for (size_t i = 0U; i < kHashLaneNum; ++i) {
+        lanes[i] = MixWord(lanes[i], LoadWord(data + offset + (i * sizeof(uint64_t))));
+      }
+    }
+    hash += RotateLeft(lanes[0U], 1U) + RotateLeft(lanes[1U], 7U) + RotateLeft(lanes[2U], 12U) +
+            RotateLeft(lanes[3U], 18U);
+    for (size_t i = 0U; i < kHashLaneNum; ++i) {
+      hash = ((hash ^ MixWord(0U, lanes[i])) * kHashPrime1) + kHashPrime3;
+    }
+  }
+  for (; (offset + sizeof(uint64_t)) <= size; offset += sizeof(uint64_t)) {
+    hash = (RotateLeft(hash ^ MixWord(0U, LoadWord(data + offset)), 27U) * kHashPrime1) + kHashPrime3;
+  }
+  for (; offset < size; ++offset) {
+    hash = RotateLeft(hash ^ (static_cast<uint64_t>(data[offset]) * kHashPrime3), 11U) * kHashPrime1;
+  }
+  // final avalanche, so that close buffers end up far apart in the hash table
+  hash ^= hash >> 33U;
+  hash *= kHashPrime2;
+  hash ^= hash >> 29U;
+  hash *= kHashPrime3;
+  hash ^= hash >> 32U;
+  return hash;
+}
+
+size_t WeightDedupUtils::ShareIdenticalTensorData(const std::vector<GeTensorPtr> &tensors) {
+  BlobGrouper grouper;
+  std::vector<GeTensorPtr> group_owners;
+  size_t released_size = 0U;
+  for (const auto &tensor : tensors) {
+    if ((tensor == nullptr) || (tensor->GetData().GetSize() == 0U) || (tensor->GetData().GetData() == nullptr)) {
+      continue;
+    }
+    const size_t group = grouper.Add({tensor->GetData().GetData(), tensor->GetData().GetSize()});
+    if (group == group_owners.size()) {
+      group_owners.emplace_back(tensor);
+      continue;
+    }
+    const auto &owner = group_owners[group];
+    if ((owner == tensor) || (owner->GetData().GetData() == tensor->GetData().GetData())) {
+      continue;
+    }
+    released_size += tensor->GetData().GetSize();
+    TensorUtils::ShareAlignedPtr(owner->GetAlignedPtr(), owner->GetData().GetSize(), *tensor);
+  }
+  GELOGD("Share data of %zu tensors in %zu buffers, %zu bytes released.", tensors.size(), group_owners.size(),
+         released_size);
+  return released_size;
+}
+
+size_t WeightDedupUtils::DedupModelDef(proto::ModelDef &model_def, size_t min_data_size) {
+  if (model_def.attr().count(kAttrSharedWeightPool) > 0U) {
+    GELOGW("[Dedup][Weight] Model %s is already deduplicated.", model_def.name().c_str());
+    return 0U;
+  }
+  BlobGrouper grouper;
+  std::vector<std::vector<proto::TensorDef *>> groups;
+  VisitModelTensors(model_def, [&grouper, &groups, min_data_size](proto::TensorDef &tensor_def) {
+    const auto &data = tensor_def.data();
+    if (data.empty() || (data.size() < min_data_size)) {
+      return;
+    }
+    const size_t group = grouper.Add({reinterpret_cast<const uint8_t *>(data.data()), data.size()});
+    if (group == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[group].emplace_back(&tensor_def);
+  });
+
+  size_t removed_size = 0U;
+  proto::AttrDef::ListValue *pool = nullptr;
+  for (const auto &group : groups) {
+    if (group.size() < 2U) {
+      continue;
+    }
+    if (pool == nullptr) {
+      pool = (*model_def.mutable_attr())[kAttrSharedWeightPool].mutable_list();
+      pool->set_val_type(proto::AttrDef::ListValue::VT_LIST_BYTES);
+    }
+    const int64_t index = pool->bt_size();
+    const size_t data_size = group[0U]->data().size();
+    // the grouper points into the data of group heads, so the blob is moved only after all groups are formed
+    pool->add_bt()->swap(*group[0U]->mutable_data());
+    for (const auto tensor_def : group) {
+      tensor_def->clear_data();
+      (*tensor_def->mutable_desc()->mutable_attr())[kAttrSharedWeightIndex].set_i(index);
+    }
+    removed_size += data_size * (group.size() - 1U);
+  }
+  GELOGI("Dedup weights of model %s, %zu unique blobs, %d pooled, %zu bytes removed.", model_def.name().c_str(),
+         grouper.GetGroupNum(), (pool == nullptr) ? 0 : pool->bt_size(), removed_size);
+  return removed_size;
+}
+
+bool WeightDedupUtils::RestoreModelDef(proto::ModelDef &model_def) {
+  const auto pool_iter = model_def.attr().find(kAttrSharedWeightPool);
+  if (pool_iter == model_def.attr().end()) {
+    return true;
+  }
+  const auto &pool = pool_iter->second.list();
+  bool is_valid = true;
+  VisitModelTensors(model_def, [&pool, &is_valid](proto::TensorDef &tensor_def) {
+    if (!tensor_def.has_desc()) {
+      return;
+    }
+    auto &desc_attrs = *tensor_def.mutable_desc()->mutable_attr();
+    const auto index_iter = desc_attrs.find(kAttrSharedWeightIndex);
+    if (index_iter == desc_attrs.end()) {
+      return;
+    }
+    const int64_t index = index_iter->second.i();
+    if ((index < 0) || (index >= pool.bt_size())) {
+      REPORT_INNER_ERROR("E19999", "shared weight index %ld is out of pool size %d.", index, pool.bt_size());
+      GELOGE(GRAPH_FAILED, "[Check][Param] shared weight index %ld is out of pool size %d.", index, pool.bt_size());
+      is_valid = false;
+      return;
+    }
+    tensor_def.set_data(pool.bt(static_cast<int>(index)));
+    (void)desc_attrs.erase(index_iter);
+  });
+  if (!is_valid) {
+    return false;
+  }
+  (void)model_def.mutable_attr()->erase(kAttrSharedWeightPool);
+  return true;
+}
+}  // namespace ge
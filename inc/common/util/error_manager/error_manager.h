@@ -209,6 +209,10 @@ class ErrorManager {
 
   void SetStage(const std::string &first_stage, const std::string &second_stage);
 
+  // @brief move messages stored by work_stream_id to current work stream in report order, clear them by work_stream_id
+  // used to gather messages reported by worker threads under their own work stream
+  void MoveMessagesToCurrentWorkStream(uint64_t work_stream_id);
+
  private:
   struct ErrorInfoConfig {
     std::string error_id;
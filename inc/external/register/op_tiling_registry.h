@@ -25,8 +25,10 @@
 #include "external/register/register_types.h"
 #include <functional>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 extern const char *ATTR_NAME_ATOMIC_CLEAN_WORKSPACE;
@@ -45,6 +47,16 @@ extern const char *ATTR_NAME_ATOMIC_CLEAN_WORKSPACE;
 #define REGISTER_OP_TILING_UNIQ_V2(optype, opfunc, counter)                                                            \
   static optiling::utils::OpTilingRegistryInterf_V2 g_##optype##TilingRegistryInterf##counter(#optype, opfunc)
 
+#define REGISTER_OP_TILING_WITH_PARSE_V2(optype, opfunc, parsefunc)                                                   \
+  REGISTER_OP_TILING_UNIQ_HELPER_WITH_PARSE_V2(optype, opfunc, parsefunc, __COUNTER__)
+
+#define REGISTER_OP_TILING_UNIQ_HELPER_WITH_PARSE_V2(optype, opfunc, parsefunc, counter)                              \
+  REGISTER_OP_TILING_UNIQ_WITH_PARSE_V2(optype, opfunc, parsefunc, counter)
+
+#define REGISTER_OP_TILING_UNIQ_WITH_PARSE_V2(optype, opfunc, parsefunc, counter)                                     \
+  static optiling::utils::OpTilingRegistryInterf_V2 g_##optype##TilingRegistryInterf##counter(#optype, opfunc,        \
+                                                                                             parsefunc)
+
 using Status = domi::Status;
 namespace optiling {
 
@@ -140,6 +152,36 @@ size_t ByteBufferGetAll(ByteBuffer &buf, char *dest, size_t dest_len);
 ByteBuffer &ByteBufferPut(ByteBuffer &buf, const uint8_t *data, size_t dest_len);
 
 namespace utils {
+// Contiguous tiling data of fixed capacity. Append copies straight into the reserved memory and never allocates,
+// it fails instead once the capacity would be exceeded.
+class FMK_FUNC_HOST_VISIBILITY TilingDataBuffer {
+ public:
+  explicit TilingDataBuffer(size_t capacity = 0U);
+  ~TilingDataBuffer() = default;
+  TilingDataBuffer(const TilingDataBuffer &other);
+  TilingDataBuffer &operator=(const TilingDataBuffer &other);
+
+  template<class T>
+  bool Append(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "tiling data must be trivially copyable");
+    return Append(&value, sizeof(value));
+  }
+  bool Append(const void *data, size_t size);
+
+  // Grows the capacity to at least capacity, the data is kept
+  void Reserve(size_t capacity);
+  void Clear();
+
+  const uint8_t *GetData() const;
+  size_t GetSize() const;
+  size_t GetCapacity() const;
+
+ private:
+  std::unique_ptr<uint8_t[]> data_;
+  size_t size_ = 0U;
+  size_t capacity_ = 0U;
+};
+
 class OpRunInfoImpl;
 class OpRunInfo {
  public:
@@ -168,9 +210,16 @@ class OpRunInfo {
     AddTilingData(reinterpret_cast<const char *>(&value), sizeof(value));
   }
   void AddTilingData(const char *value, size_t size);
+  // The tiling data as a stream, kept for compatibility. The stream holds the data until the next call of
+  // GetTilingData, the reference must not be used after it.
   ByteBuffer &GetAllTilingData();
   void InternelSetTiling(ByteBuffer &value);
 
+  // The tiling data in one piece. A tiling func may reserve its buffer and append to it without allocating,
+  // AddTilingData grows the buffer when it is full.
+  TilingDataBuffer &GetTilingData();
+  void ReserveTilingData(size_t capacity);
+
   void SetClearAtomic(bool clear_atomic);
   bool GetClearAtomic() const;
 
@@ -202,16 +251,25 @@ class OpCompileInfo {
   void SetValue(const ge::AscendString &value);
   const ge::AscendString &GetValue() const;
 
+  // Object made from the value by the parse func registered with the tiling func, null if there is none.
+  // It is shared by all ops of the same compile info key and must be treated as read only.
+  void SetParsedInfo(const std::shared_ptr<void> &parsed_info);
+  const std::shared_ptr<void> &GetParsedInfo() const;
+
  private:
   std::shared_ptr<OpCompileInfoImpl> impl_;
 };
 using OpTilingFuncV2 = std::function<bool(const ge::Operator &, const OpCompileInfo &, OpRunInfo &)>;
 using OpTilingFuncV2Ptr = bool (*)(const ge::Operator &, const OpCompileInfo &, OpRunInfo &);
+// Parses the compile info json once per compile info key, returns null on failure
+using OpTilingParseFuncV2 = std::function<std::shared_ptr<void>(const ge::AscendString &compile_info_json)>;
 class FMK_FUNC_HOST_VISIBILITY OpTilingRegistryInterf_V2 {
  public:
   OpTilingRegistryInterf_V2(std::string op_type, OpTilingFuncV2 func);
+  OpTilingRegistryInterf_V2(std::string op_type, OpTilingFuncV2 func, OpTilingParseFuncV2 parse_func);
   ~OpTilingRegistryInterf_V2() = default;
   static std::map<std::string, OpTilingFuncV2> &RegisteredOpInterf();
+  static std::map<std::string, OpTilingParseFuncV2> &RegisteredParseFunc();
 };
 }  // namespace utils
 }  // namespace optiling
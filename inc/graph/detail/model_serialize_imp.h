@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "graph/anchor.h"
@@ -59,6 +60,13 @@ class ModelSerializeImp {
 
   bool SerializeTensor(const ConstGeTensorPtr &tensor, proto::TensorDef *tensorProto);
 
+  // Appends what describes op_desc rather than its node to input_key: the type, the attrs out of ignored_attrs in
+  // name order, the input names, the subgraph names
+  // and the input descs, and appends the output descs to output_key. The messages are
+  // read in place, nothing is copied into an OpDef
+  static bool SerializeOpDescKey(const ConstOpDescPtr &op_desc, const std::set<std::string> &ignored_attrs,
+                                 std::string &input_key, std::string &output_key);
+
   bool UnserializeModel(Model &model, proto::ModelDef &modeProto);
 
   bool UnserializeGraphWithoutEdge(ComputeGraphPtr &graph, proto::GraphDef &graphProto);
@@ -80,14 +88,27 @@ class ModelSerializeImp {
 
   void SetProtobufOwner(const ProtoMsgOwner &bufferProtobufOnwer) { protobuf_owner_ = bufferProtobufOnwer; }
 
+  // Number of threads used to convert nodes to OpDef, 0 or 1 means serializing on the calling thread
+  void SetParallelNum(uint32_t parallel_num) { parallel_num_ = parallel_num; }
+
+  // Tensor data shared by several ops is written once into a pool of the model, see WeightDedupUtils
+  void SetDedupWeights(bool dedup_weights) { dedup_weights_ = dedup_weights; }
+
  private:
   bool RebuildOwnership(ComputeGraphPtr &compute_graph, std::map<std::string, ComputeGraphPtr> &subgraphs);
 
+  bool SerializeGraphHead(const ConstComputeGraphPtr &graph, proto::GraphDef *graph_proto);
+
+  bool SerializeGraphsParallel(const std::vector<ConstComputeGraphPtr> &graphs,
+                               const std::vector<proto::GraphDef *> &graph_protos, bool is_dump);
+
   std::vector<NodeNameGraphReq> graph_input_node_names_;
   std::vector<NodeNameGraphReq> graph_output_node_names_;
   std::vector<NodeNameNodeReq> node_input_node_names_;
   std::map<string, NodePtr> node_map_;
   ProtoMsgOwner protobuf_owner_;
+  uint32_t parallel_num_ = 0U;
+  bool dedup_weights_ = false;
 };
 }  // namespace ge
 
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_INFER_SHAPE_CACHE_H_
+#define INC_GRAPH_INFER_SHAPE_CACHE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "external/graph/operator_factory.h"
+#include "graph/ge_tensor.h"
+#include "graph/op_desc.h"
+
+namespace ge {
+struct InferShapeCacheOptions {
+  // Results cached at most, later results are not cached once it is reached
+  size_t max_entry_num = 4096U;
+  // Op attrs left out of the key besides the data dump bookkeeping attrs, they must not affect inference
+  std::set<std::string> ignored_attrs;
+};
+
+struct InferShapeCacheStatistics {
+  uint64_t hit_num = 0U;
+  uint64_t miss_num = 0U;
+  // calls the cache did not apply to, see InferShapeCache
+  uint64_t skip_num = 0U;
+};
+
+/// Opt-in memoization of OpDesc::CallInferFunc.
+/// The key is the op type, the infer func, the attrs and all input and output tensor descs of the op.
+/// A hit writes the cached output descs and skips the infer func. Results are not cached when the infer func
+/// reads const input data, the inference context or the node, changes anything but the output descs, or when
+/// the op is a constant or has subgraphs. Infer funcs registered for an op type are told apart by their type,
+/// so a functor whose behavior depends on captured state must not be used while the cache is enabled.
+class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY InferShapeCache {
+ public:
+  static InferShapeCache &Instance();
+
+  void Enable(const InferShapeCacheOptions &options);
+  // Drops the entries and logs the hit rate
+  void Disable();
+  bool IsEnabled() const { return is_enabled_; }
+  void Clear();
+
+  InferShapeCacheStatistics GetStatistics() const;
+  // hit_num / (hit_num + miss_num), 0 before the first lookup
+  double GetHitRate() const;
+
+  // Called by the Operator accessors which make an infer result depend on more than the op desc
+  static void MarkUncacheable();
+
+ private:
+  friend class OpDescImpl;
+  InferShapeCache() = default;
+
+  struct CacheEntry {
+    std::vector<std::pair<uint32_t, GeTensorDesc>> input_descs;
+    std::vector<std::pair<uint32_t, GeTensorDesc>> output_descs;
+  };
+
+  bool BuildKey(const OpDescPtr &op_desc, const InferShapeFunc &infer_func, std::string &key);
+  bool Lookup(const std::string &key, const OpDescPtr &op_desc);
+  // Watches the infer func of the calling thread, it is cacheable when it changed only the output descs
+  void BeginWatch(const OpDescPtr &op_desc, std::string &watch_key) const;
+  bool EndWatch(const OpDescPtr &op_desc, const std::string &watch_key) const;
+  void Store(const std::string &key, const OpDescPtr &op_desc, bool is_cacheable);
+  bool BuildInputKey(const OpDescPtr &op_desc, std::string &input_key, std::string &output_key) const;
+
+  std::atomic<bool> is_enabled_{false};
+  InferShapeCacheOptions options_;
+  std::shared_ptr<const std::set<std::string>> ignored_attrs_;
+  std::unordered_map<std::string, CacheEntry> entries_;
+  InferShapeCacheStatistics statistics_;
+  mutable std::mutex mutex_;
+};
+}  // namespace ge
+#endif  // INC_GRAPH_INFER_SHAPE_CACHE_H_
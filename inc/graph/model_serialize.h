@@ -28,6 +28,10 @@ namespace ge {
 class ModelSerialize {
  public:
   Buffer SerializeModel(const Model &model, bool is_dump = false);
+  // Same output as above, nodes of the root graph and all subgraphs are converted by parallel_num threads
+  Buffer SerializeModel(const Model &model, bool is_dump, uint32_t parallel_num);
+  // Identical weights are written once when dedup_weights is set, UnserializeModel restores them
+  Buffer SerializeModel(const Model &model, bool is_dump, uint32_t parallel_num, bool dedup_weights);
 
   Model UnserializeModel(const uint8_t *data, size_t len);
   Model UnserializeModel(ge::proto::ModelDef &model_def);
@@ -36,6 +40,7 @@ class ModelSerialize {
   bool UnserializeModel(ge::proto::ModelDef &model_def, Model &model);
 
   Buffer SerializeGraph(const ComputeGraphPtr &graph);
+  Buffer SerializeGraph(const ComputeGraphPtr &graph, uint32_t parallel_num);
 
   ComputeGraphPtr UnserializeGraph(const uint8_t *data, size_t len);
 
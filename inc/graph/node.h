@@ -187,6 +187,7 @@ class Node : public std::enable_shared_from_this<Node> {
   NodeImplPtr impl_;
   friend class NodeUtils;
   friend class OnnxUtils;
+  friend class OpDescUtils;
   friend class TuningUtils;
 };
 }  // namespace ge
@@ -277,6 +277,12 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
 
   std::string GetOpEngineName() const;
 
+  /// what the tiling of the register resolves for the op once, read by every tiling of the op instead of a lookup
+  /// by name. It is neither serialized nor compared, and SetType drops it
+  void SetTilingFuncInfo(const std::shared_ptr<void> &tiling_func_info);
+
+  const std::shared_ptr<void> &GetTilingFuncInfo() const;
+
   void RegisterSubgraphIrName(const std::string &name, SubgraphType type);
   const std::map<std::string, SubgraphType> &GetSubgraphIrNames() const;
   SubgraphType GetSubgraphTypeByIrName(const std::string &name) const;
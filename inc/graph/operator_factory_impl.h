@@ -43,6 +43,15 @@ struct InferValueRangePara {
   InferValueRangeFunc infer_value_func = nullptr;
 };
 
+// Functions registered for one op type, every OpDesc of the type refers to the same table
+struct OpFuncTable {
+  InferShapeFunc infer_shape_func = nullptr;
+  InferFormatFunc infer_format_func = nullptr;
+  VerifyFunc verify_func = nullptr;
+  InferDataSliceFunc infer_data_slice_func = nullptr;
+  InferValueRangePara infer_value_range_para;
+};
+
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
  public:
   static Operator CreateOperator(const std::string &operator_name, const std::string &operator_type);
@@ -61,6 +70,11 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
 
   static InferDataSliceFunc GetInferDataSliceFunc(const std::string &operator_type);
 
+  /// Returns the function table of operator_type, it is built on the first call and the address stays valid for
+  /// the rest of the process. A table is only refreshed by a later registration of the same op type, so
+  /// registration is expected to finish before graphs are inferred.
+  static const OpFuncTable *GetOpFuncTable(const std::string &operator_type);
+
   static graphStatus RegisterOperatorCreator(const std::string &operator_type, OpCreator const &op_creator);
 
   static graphStatus RegisterOperatorCreator(const std::string &operator_type, OpCreatorV2 const &op_creator);
@@ -88,6 +102,11 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY OperatorFactoryImpl {
   static shared_ptr<std::map<string, VerifyFunc>> operator_verify_funcs_;
   static shared_ptr<std::map<string, InferDataSliceFunc>> operator_infer_data_slice_funcs_;
   static shared_ptr<std::map<string, InferValueRangePara>> operator_infer_value_range_paras_;
+  static shared_ptr<std::map<string, OpFuncTable>> operator_func_tables_;
+
+ private:
+  static void BuildOpFuncTable(const std::string &operator_type, OpFuncTable &func_table);
+  static void RefreshOpFuncTable(const std::string &operator_type);
 };
 }  // namespace ge
 
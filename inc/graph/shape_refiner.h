@@ -18,8 +18,11 @@
 #ifndef INC_GRAPH_SHAPE_REFINER_H_
 #define INC_GRAPH_SHAPE_REFINER_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 #include "external/graph/inference_context.h"
+#include "external/graph/operator.h"
 
 #include "external/graph/ge_error_codes.h"
 #include "graph/node.h"
@@ -37,9 +40,39 @@ class ShapeRefiner {
   static void ClearContextMap();
   static InferenceContextPtr CreateInferenceContext(const NodePtr &node);
   static void PushToContextMap(const NodePtr &node, const InferenceContextPtr &inference_context);
+  // Infers all nodes of graph and its subgraphs, nodes whose inputs are all inferred run together on
+  // parallel_num threads. Shapes and contexts are the same as inferring the nodes one by one in topological order.
+  static graphStatus InferShapeAndTypeParallel(const ComputeGraphPtr &graph, uint32_t parallel_num);
+  // Re-infers changed_nodes, then in topological order only the nodes downstream of them whose input descs no longer
+  // match the output descs of their producers. infer_num is the number of nodes actually inferred.
+  static graphStatus ReInferShapeAndType(const std::vector<NodePtr> &changed_nodes, size_t &infer_num);
 
  private:
+  friend class RuntimeInferPlan;
   static void PrintInOutTensorShape(const ge::NodePtr &node, const std::string &phase);
 };
+
+// Per node state of InferShapeAndTypeForRunning, built once before the first execution of a dynamic shape graph.
+// The bound operator, the infer func and the output descs are resolved at build time, so every Run only calls the
+// infer func and restores the output dtypes.
+class RuntimeInferPlan {
+ public:
+  static std::unique_ptr<RuntimeInferPlan> Build(const NodePtr &node, bool before_subgraph);
+  graphStatus Run();
+  // indexes of the inputs whose values the infer func reads, the executor has to copy them to host before Run
+  const std::vector<uint32_t> &GetDependInputIndexes() const { return depend_input_indexes_; }
+
+ private:
+  RuntimeInferPlan() = default;
+
+  NodePtr node_;
+  OpDescPtr op_desc_;
+  Operator op_;
+  bool before_subgraph_ = true;
+  bool need_dummy_context_ = false;
+  std::vector<GeTensorDescPtr> output_descs_;
+  std::vector<DataType> output_dtypes_;
+  std::vector<uint32_t> depend_input_indexes_;
+};
 }  // namespace ge
 #endif  // INC_GRAPH_SHAPE_REFINER_H_
@@ -182,6 +182,18 @@ class GraphUtils {
 
   static bool LoadGEGraph(const char *file, ge::ComputeGraphPtr &compute_graph);
 
+  ///
+  /// Load the graph named graph_name from a file generated by DumpGEGraph, subgraphs are not loaded.
+  /// A binary dump with a section index is read without parsing the other graphs in it.
+  ///
+  static bool LoadGEGraph(const char *file, const std::string &graph_name, ge::ComputeGraphPtr &compute_graph);
+
+  ///
+  /// DumpGEGraph writes GraphBinaryFile instead of text when env DUMP_GRAPH_FORMAT is "bin",
+  /// LoadGEGraph accepts both formats.
+  ///
+  static bool IsDumpGraphInBinary();
+
   static void BreakConnect(const std::map<OperatorImplPtr, NodePtr> &all_nodes_infos);
 
   static void DumpGEGraphToOnnx(const ge::ComputeGraph &compute_graph, const std::string &suffix);
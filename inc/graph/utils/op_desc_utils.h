@@ -74,6 +74,13 @@ class OpDescUtils {
 
   static Operator CreateOperatorFromOpDesc(OpDescPtr op_desc);
   static Operator CreateOperatorFromNode(ge::ConstNodePtr node_ptr);
+  /// Returns a new operator of op_desc, a patched copy of the op desc of node_ptr, whose const inputs are still
+  /// taken from the peers of node_ptr. Nothing of node_ptr is changed.
+  static Operator CreateOperatorFromNode(const ge::ConstNodePtr &node_ptr, const OpDescPtr &op_desc);
+  /// Returns the operator bound to node_ptr, it is created on the first call and reused by later calls, the links
+  /// and inference context left by the last user are dropped. Meant for per-call infer and tiling paths, the
+  /// returned operator must not be kept or shared between threads working on the same node.
+  static Operator GetOperatorViewFromNode(const ge::ConstNodePtr &node_ptr);
   static OpDescPtr GetOpDescFromOperator(const Operator& oprt);
   static graphStatus CopyOperatorLinks(const std::map<string, ge::Operator> &src_op_list,
                                        std::map<string, ge::Operator> &dst_op_list);
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_UTILS_SYMBOLIC_SHAPE_UTILS_H_
+#define INC_GRAPH_UTILS_SYMBOLIC_SHAPE_UTILS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/ge_tensor.h"
+#include "graph/node.h"
+
+namespace ge {
+///
+/// Affine expression of symbols, the sum of coef * symbol plus a constant, for example "s0", "2*s0+1" or "s0+s1".
+/// A dim without symbols is a plain number.
+///
+class SymbolicDim {
+ public:
+  SymbolicDim() = default;
+  explicit SymbolicDim(int64_t value) : constant_(value) {}
+  ~SymbolicDim() = default;
+
+  static SymbolicDim Symbol(const std::string &name);
+  static bool Parse(const std::string &str, SymbolicDim &dim);
+
+  bool IsConstant() const { return terms_.empty(); }
+  int64_t GetConstant() const { return constant_; }
+  const std::map<std::string, int64_t> &GetTerms() const { return terms_; }
+  std::string ToString() const;
+
+  /// fails when a symbol of the expression has no value
+  bool Evaluate(const std::map<std::string, int64_t> &symbol_values, int64_t &value) const;
+
+  SymbolicDim operator+(const SymbolicDim &other) const;
+  SymbolicDim operator*(int64_t factor) const;
+  /// exact division only, fails when the constant or a coefficient is not a multiple of divisor
+  bool DivExactly(int64_t divisor, SymbolicDim &result) const;
+
+  bool operator==(const SymbolicDim &other) const { return (constant_ == other.constant_) && (terms_ == other.terms_); }
+  bool operator!=(const SymbolicDim &other) const { return !(*this == other); }
+
+ private:
+  // symbol name to coefficient, zero coefficients are never kept
+  std::map<std::string, int64_t> terms_;
+  int64_t constant_ = 0;
+};
+
+using SymbolicShape = std::vector<SymbolicDim>;
+
+struct SymbolInfo {
+  std::string name;
+  // where the symbol comes from, the dim_index dim of the output of the node
+  std::string node_name;
+  size_t dim_index = 0U;
+  // from the shape range of the dim, -1 as max means unbounded
+  std::pair<int64_t, int64_t> range{1, -1};
+};
+
+class SymbolTable {
+ public:
+  std::string NewSymbol(const std::string &node_name, size_t dim_index, const std::pair<int64_t, int64_t> &range);
+  const std::vector<SymbolInfo> &GetSymbols() const { return symbols_; }
+
+ private:
+  std::vector<SymbolInfo> symbols_;
+};
+
+class SymbolicShapeUtils {
+ public:
+  ///
+  /// @return false if tensor_desc carries no symbolic shape or its rank differs from the numeric shape
+  ///
+  static bool GetSymbolicShape(const GeTensorDesc &tensor_desc, SymbolicShape &shape);
+  static bool SetSymbolicShape(GeTensorDesc &tensor_desc, const SymbolicShape &shape);
+  static void ClearSymbolicShape(GeTensorDesc &tensor_desc);
+
+  ///
+  /// give every unknown dim of the Data nodes of graph a new symbol of table. Dims that are known to be equal,
+  /// such as the batch of two inputs, can be bound afterwards by SetSymbolicShape on the Data node.
+  ///
+  static graphStatus AssignInputSymbols(const ComputeGraphPtr &graph, SymbolTable &table);
+
+  ///
+  /// same as AssignInputSymbols, except that dim 0 of every Data node with an unknown dim 0 gets one shared
+  /// symbol, returned by batch_symbol. Used to infer a multi-batch graph once for all gears.
+  ///
+  static graphStatus AssignBatchSymbol(const ComputeGraphPtr &graph, SymbolTable &table, std::string &batch_symbol);
+
+  ///
+  /// stamp the concrete shapes of one gear into graph by evaluating the symbolic shapes with symbol_values,
+  /// no infer func is called. Meant for a clone of a graph inferred once with symbols, returns
+  /// GRAPH_PARAM_INVALID if a tensor has an unknown dim no symbol covers, the caller then falls back to a
+  /// full inference of the clone.
+  ///
+  static graphStatus InstantiateShapes(const ComputeGraphPtr &graph,
+                                       const std::map<std::string, int64_t> &symbol_values);
+
+  ///
+  /// derive the symbolic shape of the output of node from the symbolic shapes of its inputs, ShapeRefiner calls
+  /// it after the numeric inference. Elementwise, broadcast, reshape and concat ops are covered, the outputs of
+  /// other ops keep their numeric shape only. A known numeric dim always wins over the derived one. Nodes of a
+  /// graph that AssignInputSymbols or AssignBatchSymbol gave no symbol are left as they are.
+  ///
+  static graphStatus InferSymbolicShape(const NodePtr &node);
+};
+}  // namespace ge
+#endif  // INC_GRAPH_UTILS_SYMBOLIC_SHAPE_UTILS_H_
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_UTILS_VALUE_RANGE_UTILS_H_
+#define INC_GRAPH_UTILS_VALUE_RANGE_UTILS_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "graph/compute_graph.h"
+#include "graph/ge_tensor.h"
+#include "graph/node.h"
+
+namespace ge {
+using ValueRange = std::vector<std::pair<int64_t, int64_t>>;
+
+class ValueRangeUtils {
+ public:
+  ///
+  /// value range of the out_idx output of node as its consumers see it. The exact values of an int32 or int64
+  /// Const of at most 64 elements are returned as ranges whose min equals max, a larger Const has no value range.
+  /// Other nodes return the value range of their output desc.
+  /// @return false if node gives no value range for the output
+  ///
+  static bool GetOutputValueRange(const NodePtr &node, uint32_t out_idx, ValueRange &value_range);
+
+  ///
+  /// @return true if every element of value_range is exact and their number matches the static shape of desc
+  ///
+  static bool IsValueKnown(const GeTensorDesc &desc, const ValueRange &value_range);
+
+  ///
+  /// sort graph, then propagate value ranges through its direct nodes in topological order. The value ranges of the
+  /// producers of at most 64 elements are copied to the input descs of every node whose type registers an infer
+  /// value range func, then the func is called as its WHEN_CALL allows. With fold_known_values, a single output
+  /// node whose output becomes fully known is replaced by a Const node holding the values, folded_num counts the
+  /// replaced nodes.
+  ///
+  static graphStatus InferValueRange(const ComputeGraphPtr &graph, bool fold_known_values, size_t &folded_num);
+
+  ///
+  /// replace node by a Const node holding the exact values of value_range, the data consumers and the control
+  /// edges of node move to the Const node and node is removed from its graph.
+  /// @return GRAPH_PARAM_INVALID if node is left unchanged as its values cannot be folded
+  ///
+  static graphStatus FoldToConst(const NodePtr &node, const ValueRange &value_range, NodePtr &const_node);
+};
+}  // namespace ge
+#endif  // INC_GRAPH_UTILS_VALUE_RANGE_UTILS_H_
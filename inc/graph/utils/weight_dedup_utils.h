@@ -0,0 +1,62 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_GRAPH_UTILS_WEIGHT_DEDUP_UTILS_H_
+#define INC_GRAPH_UTILS_WEIGHT_DEDUP_UTILS_H_
+
+#include <cstdint>
+#include <vector>
+#include "graph/ge_attr_value.h"
+
+namespace ge {
+namespace proto {
+class ModelDef;
+}
+
+class WeightDedupUtils {
+ public:
+  // Tensor data below this size is cheaper to keep inline than to reference
+  static const size_t kMinDedupDataSize = 64U;
+
+  ///
+  /// content hash of a weight buffer, equal data always gives equal hash, the data is still compared before
+  /// two buffers are merged
+  ///
+  static uint64_t HashData(const uint8_t *data, size_t size);
+
+  ///
+  /// let tensors with byte-identical data share the aligned ptr of the first one
+  /// @param tensors tensors to merge, null and empty tensors are skipped
+  /// @return bytes released
+  ///
+  static size_t ShareIdenticalTensorData(const std::vector<GeTensorPtr> &tensors);
+
+  ///
+  /// move the data of tensors held by more than one op attr into a pool in the model attrs, each unique
+  /// blob is then written only once. The pool is resolved by RestoreModelDef when the model is loaded.
+  /// @return bytes removed from model_def
+  ///
+  static size_t DedupModelDef(proto::ModelDef &model_def, size_t min_data_size = kMinDedupDataSize);
+
+  ///
+  /// copy the pooled blobs back into the tensors referencing them and drop the pool,
+  /// a model_def without pool is left untouched
+  ///
+  static bool RestoreModelDef(proto::ModelDef &model_def);
+};
+}  // namespace ge
+#endif  // INC_GRAPH_UTILS_WEIGHT_DEDUP_UTILS_H_
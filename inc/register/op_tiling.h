@@ -18,15 +18,77 @@
 #ifndef INC_REGISTER_OP_TILING_H_
 #define INC_REGISTER_OP_TILING_H_
 
+#include <vector>
+#include "graph/compute_graph.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/node.h"
 #include "register/op_tiling_registry.h"
 
+namespace ge {
+class GraphThreadPool;
+}  // namespace ge
+
 namespace optiling {
 
 extern "C" ge::graphStatus OpParaCalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info);
 extern "C" ge::graphStatus OpAtomicCalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info);
 
+///
+/// freeze the tiling func registries into a hash table, called once the tiling plugins are loaded.
+/// A func registered later drops the table until the next freeze
+///
+void FreezeOpTilingRegistry();
+
+///
+/// drop the compile infos kept by tiling type and compile info key, called when a model is unloaded as they only
+/// ever grow otherwise. Nodes prepared by PrepareOpTilingFunc keep their own compile info
+///
+void ClearOpTilingCompileInfos();
+
+///
+/// keep the tiling func of node and the compile info of a V2 func on its op desc, so later tiling of node skips the
+/// lookups by op type and compile info key, and parse the run infos precomputed for node. The tiling func is kept
+/// only once the registries are frozen.
+/// Writes the op desc, it must not run along with a tiling of node
+///
+ge::graphStatus PrepareOpTilingFunc(const ge::Node &node);
+
+struct OpTilingResult {
+  ge::graphStatus status = ge::GRAPH_SUCCESS;
+  utils::OpRunInfo run_info;
+  // set if the node has outputs to be cleaned by the atomic clean op
+  bool has_atomic_clean = false;
+  ge::graphStatus atomic_status = ge::GRAPH_SUCCESS;
+  utils::OpRunInfo atomic_run_info;
+};
+
+///
+/// tile node and, if it has atomic outputs, its atomic clean in one call. It is OpParaCalculateV2 followed by
+/// OpAtomicCalculateV2, only the read of the atomic output indexes is shared, so it saves the second read and
+/// nothing else. The atomic clean is tiled even if the tiling of node fails.
+/// @return the status of the tiling of node if it fails, else the status of the atomic clean tiling
+///
+ge::graphStatus OpTilingCalculateV2(const ge::Node &node, OpTilingResult &result);
+
+///
+/// tile nodes on the workers of pool and the caller, results[i] holds the run infos of nodes[i]. pool belongs to the
+/// caller and is meant to be kept across batches, the nodes are tiled on the caller thread alone if it is null.
+/// It must not be called from a worker of pool. A node with atomic outputs gets its atomic clean tiling as well.
+/// The tiling of a node must not depend on the tiling of another one. Each node reports under the error context of
+/// the caller, its messages and failures reach the caller in node order once all nodes are done, the same way a
+/// serial run would report them.
+/// @return the first failed status in node order
+///
+ge::graphStatus OpParaCalculateBatch(const std::vector<ge::NodePtr> &nodes, ge::GraphThreadPool *pool,
+                                     std::vector<OpTilingResult> &results);
+
+///
+/// sort graph topologically, then tile the nodes of graph and its subgraphs which carry compile info, nodes returns
+/// them in topological order
+///
+ge::graphStatus OpParaCalculateGraph(const ge::ComputeGraphPtr &graph, ge::GraphThreadPool *pool,
+                                     std::vector<ge::NodePtr> &nodes, std::vector<OpTilingResult> &results);
+
 }  // namespace optiling
 
 #endif  // INC_REGISTER_OP_TILING_H_
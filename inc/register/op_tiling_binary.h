@@ -0,0 +1,79 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_REGISTER_OP_TILING_BINARY_H_
+#define INC_REGISTER_OP_TILING_BINARY_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+#include "register/register_types.h"
+#else
+// register_types.h is C++ only, the visibility only matters to the library exporting the interface
+#define FMK_FUNC_HOST_VISIBILITY
+#endif
+
+// Binary counterpart of TbeOpTilingPyInterfaceEx2. The structs hold fixed width fields only and are shared with
+// callers built against a plain C compiler, so fields are only ever appended.
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct TbeOpTilingTensor {
+  // required for a const input, the tiling func reads the const data by this name
+  const char *name;
+  // ge::DataType
+  int32_t dtype;
+  // ge::Format
+  int32_t format;
+  int32_t ori_format;
+  uint32_t dim_num;
+  const int64_t *dims;
+  uint32_t ori_dim_num;
+  const int64_t *ori_dims;
+  // null if the tensor is not a const input
+  const void *const_data;
+  uint64_t const_size;
+} TbeOpTilingTensor;
+
+typedef struct TbeOpTilingRunInfo {
+  uint32_t block_dim;
+  uint32_t tiling_key;
+  int32_t clear_atomic;
+  // capacity of workspaces on input, the number written on output
+  uint32_t workspace_num;
+  int64_t *workspaces;
+  // capacity of tiling_data on input, the size written on output
+  uint64_t tiling_data_size;
+  uint8_t *tiling_data;
+} TbeOpTilingRunInfo;
+
+///
+/// tile an op of optype by its V2 tiling func. The run info goes to caller owned buffers, when a buffer is too
+/// small the call fails and run_info holds the sizes needed. elapse is the same as TbeOpTilingPyInterfaceEx2.
+/// Like TbeOpTilingPyInterfaceEx2 the op carries no attrs, ops whose tiling funcs read attrs are not supported
+/// @return 1 on success, 0 on failure
+///
+FMK_FUNC_HOST_VISIBILITY int TbeOpTilingBinaryInterface(const char *optype, const char *compile_info,
+                                                        const char *compile_info_hash,
+                                                        const TbeOpTilingTensor *inputs, uint32_t input_num,
+                                                        const TbeOpTilingTensor *outputs, uint32_t output_num,
+                                                        TbeOpTilingRunInfo *run_info, uint64_t *elapse);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // INC_REGISTER_OP_TILING_BINARY_H_
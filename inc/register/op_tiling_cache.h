@@ -0,0 +1,88 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_REGISTER_OP_TILING_CACHE_H_
+#define INC_REGISTER_OP_TILING_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "graph/node.h"
+#include "register/op_tiling_registry.h"
+
+namespace optiling {
+struct OpTilingCacheOptions {
+  // Run infos kept at most, the least recently used one is evicted once it is reached
+  size_t capacity = 1024U;
+  // Op types whose tiling funcs are not pure, their results are never cached
+  std::set<std::string> uncacheable_op_types;
+};
+
+struct OpTilingCacheStatistics {
+  uint64_t hit_num = 0U;
+  uint64_t miss_num = 0U;
+  // calls of uncacheable op types or of nodes without compile info
+  uint64_t skip_num = 0U;
+  uint64_t evict_num = 0U;
+};
+
+/// Opt-in memoization of OpParaCalculateV2.
+/// The key is the op type, the compile info key, the shapes, origin shapes, formats and data types of all inputs
+/// and outputs, and the data of the const inputs the op depends on, a call whose depended input has no const data
+/// is not cached. A node without a compile info key is keyed by the hash and size of its compile info json.
+/// A tiling func is assumed to depend on nothing else, the ones which read the node name, op attrs left out of the
+/// compile info or any global state must be listed as uncacheable. A hit overwrites the run info given by the
+/// caller with the cached one.
+class FMK_FUNC_HOST_VISIBILITY OpTilingCache {
+ public:
+  static OpTilingCache &Instance();
+
+  void Enable(const OpTilingCacheOptions &options);
+  // Drops the entries and logs the hit rate
+  void Disable();
+  bool IsEnabled() const { return is_enabled_; }
+  void Clear();
+  void SetUncacheable(const std::string &op_type);
+
+  OpTilingCacheStatistics GetStatistics() const;
+  // hit_num / (hit_num + miss_num), 0 before the first lookup
+  double GetHitRate() const;
+
+  // false if the tiling of node is not to be cached
+  bool BuildKey(const ge::Node &node, std::string &key);
+  bool Lookup(const std::string &key, utils::OpRunInfo &run_info);
+  void Store(const std::string &key, const utils::OpRunInfo &run_info);
+
+ private:
+  OpTilingCache() = default;
+
+  using CacheEntry = std::pair<std::string, utils::OpRunInfo>;
+
+  std::atomic<bool> is_enabled_{false};
+  OpTilingCacheOptions options_;
+  // most recently used first
+  std::list<CacheEntry> entries_;
+  std::unordered_map<std::string, std::list<CacheEntry>::iterator> entry_index_;
+  OpTilingCacheStatistics statistics_;
+  mutable std::mutex mutex_;
+};
+}  // namespace optiling
+#endif  // INC_REGISTER_OP_TILING_CACHE_H_
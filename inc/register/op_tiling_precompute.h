@@ -0,0 +1,64 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_REGISTER_OP_TILING_PRECOMPUTE_H_
+#define INC_REGISTER_OP_TILING_PRECOMPUTE_H_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "graph/compute_graph.h"
+#include "graph/node.h"
+#include "register/op_tiling_registry.h"
+
+namespace optiling {
+// bytes attr holding the run infos precomputed for a node
+extern const char *ATTR_NAME_OP_TILING_PRECOMPUTED;
+
+// run infos by the shapes and origin shapes of the inputs
+using OpTilingPrecomputedTable = std::unordered_map<std::string, utils::OpRunInfo>;
+
+struct OpTilingPrecomputeOptions {
+  // ops with more input shapes within their shape ranges get no precomputed run info at all, not even for part of
+  // their shapes, and are left to the runtime tiling
+  size_t max_shape_num = 64U;
+  // op types to precompute, every op with compile info if empty
+  std::set<std::string> op_types;
+};
+
+/// Tiles node at compile time for every input shape within the shape ranges of its dynamic inputs and keeps the
+/// run infos on node, once PrepareOpTilingFunc has loaded them OpParaCalculateV2 hands them out without calling the
+/// tiling func.
+/// Every shape is tiled exactly, the tiling of a shape never stands for another one. Static ops, ops reading the
+/// data of const inputs, ops with unbounded ranges or more than max_shape_num shapes, and ops with dynamic outputs
+/// but no infer func are skipped with precomputed false. A shape the tiling func fails on is left out of the table.
+ge::graphStatus OpTilingPrecompute(const ge::NodePtr &node, const OpTilingPrecomputeOptions &options,
+                                   bool &precomputed);
+ge::graphStatus OpTilingPrecomputeGraph(const ge::ComputeGraphPtr &graph, const OpTilingPrecomputeOptions &options,
+                                        size_t &precomputed_num);
+
+/// parses the precomputed run infos of op_desc, called once by PrepareOpTilingFunc which keeps the table along with
+/// the tiling func of the node. table is null if op_desc has no precomputed run info
+ge::graphStatus LoadOpTilingPrecomputed(const ge::OpDescPtr &op_desc,
+                                        std::shared_ptr<const OpTilingPrecomputedTable> &table);
+// false if no run info of table is precomputed for the current input shapes of op_desc
+bool FindOpTilingPrecomputed(const ge::OpDescPtr &op_desc, const OpTilingPrecomputedTable &table,
+                             utils::OpRunInfo &run_info);
+}  // namespace optiling
+
+#endif  // INC_REGISTER_OP_TILING_PRECOMPUTE_H_
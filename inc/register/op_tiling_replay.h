@@ -0,0 +1,102 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INC_REGISTER_OP_TILING_REPLAY_H_
+#define INC_REGISTER_OP_TILING_REPLAY_H_
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "graph/node.h"
+
+namespace optiling {
+// A tiling corpus holds one json object per line:
+//   {"op_type": ..., "compile_info_key": ..., "compile_info": ..., "inputs": [...], "outputs": [...]}
+// inputs and outputs take the form of the inputs and outputs of TbeOpTilingPyInterfaceEx2, const inputs carry
+// their "const_value".
+
+// Records the ops tiled by OpParaCalculateV2. Starts recording to the file named by the env OP_TILING_RECORD_PATH
+// if it is set, records are appended.
+class OpTilingRecorder {
+ public:
+  static OpTilingRecorder &Instance();
+
+  ge::graphStatus Start(const std::string &corpus_path);
+  void Stop();
+  bool IsRecording() const {
+    return recording_.load();
+  }
+  // appends the tiling of node, failures are logged only, recording never fails the tiling
+  void Record(const ge::Node &node);
+  size_t GetRecordNum() const;
+
+ private:
+  OpTilingRecorder();
+  ~OpTilingRecorder() = default;
+
+  std::atomic<bool> recording_{false};
+  size_t record_num_ = 0U;
+  std::ofstream corpus_;
+  mutable std::mutex mutex_;
+};
+
+struct OpTilingReplayStat {
+  std::string op_type;
+  size_t record_num = 0U;
+  size_t call_num = 0U;
+  size_t fail_num = 0U;
+  // latency of the tiling func alone, in us
+  double p50_us = 0.0;
+  double p90_us = 0.0;
+  double p99_us = 0.0;
+  double max_us = 0.0;
+  // allocations by the tiling func, 0 if the replay has no allocation counter
+  double alloc_per_call = 0.0;
+  double avg_tiling_data_size = 0.0;
+  size_t max_tiling_data_size = 0U;
+};
+
+// Replays a tiling corpus through the registered V1 and V2 tiling funcs. The ops and compile infos are built once
+// at Load, a replay times the tiling funcs only.
+class OpTilingReplayer {
+ public:
+  // returns the number of allocations made by the process so far
+  using AllocCounter = std::function<uint64_t()>;
+
+  OpTilingReplayer() = default;
+  ~OpTilingReplayer() = default;
+
+  // records of op types without a tiling func are skipped with a warning
+  ge::graphStatus Load(const std::string &corpus_path);
+  // tiles every record loop_num times, stats are ordered by op type
+  ge::graphStatus Replay(uint32_t loop_num, const AllocCounter &alloc_counter,
+                         std::vector<OpTilingReplayStat> &stats) const;
+  size_t GetRecordNum() const {
+    return records_.size();
+  }
+
+ private:
+  struct Record;
+  std::vector<std::shared_ptr<Record>> records_;
+};
+}  // namespace optiling
+
+#endif  // INC_REGISTER_OP_TILING_REPLAY_H_
@@ -56,7 +56,12 @@ local_lib_inc_path :=   \
                         third_party/json/include \
 
 tiling_src_files := op_tiling.cpp \
+                    op_tiling_batch.cc \
+                    op_tiling_binary.cc \
+                    op_tiling_cache.cc \
+                    op_tiling_precompute.cc \
                     op_tiling_registry.cpp \
+                    op_tiling_replay.cc \
 
 #compiler for host
 include $(CLEAR_VARS)
@@ -33,6 +33,10 @@
 #include "graph/utils/op_desc_utils.h"
 #include "graph/utils/tensor_utils.h"
 #include "graph/utils/type_utils.h"
+#include "op_tiling_registry_impl.h"
+#include "register/op_tiling_cache.h"
+#include "register/op_tiling_precompute.h"
+#include "register/op_tiling_replay.h"
 #include "securec.h"
 
 #define LOG_ENABLED(loglvl) CheckLogLevel(GE_MODULE_NAME, loglvl)
@@ -180,21 +184,22 @@ const char *COMPILE_INFO_KEY = "compile_info_key";
 const char *ATOMIC_COMPILE_INFO_JSON = "_atomic_compile_info_json";
 const char *ATOMIC_COMPILE_INFO_KEY = "_atomic_compile_info_key";
 
-const std::map<ge::DataType, std::string> DATATYPE_STRING_MAP{{ge::DT_FLOAT, "float32"},
-                                                              {ge::DT_FLOAT16, "float16"},
-                                                              {ge::DT_INT8, "int8"},
-                                                              {ge::DT_INT16, "int16"},
-                                                              {ge::DT_INT32, "int32"},
-                                                              {ge::DT_INT64, "int64"},
-                                                              {ge::DT_UINT8, "uint8"},
-                                                              {ge::DT_UINT16, "uint16"},
-                                                              {ge::DT_UINT32, "uint32"},
-                                                              {ge::DT_UINT64, "uint64"},
-                                                              {ge::DT_BOOL, "bool"},
-                                                              {ge::DT_DOUBLE, "double"},
-                                                              {ge::DT_DUAL, "dual"},
-                                                              {ge::DT_DUAL_SUB_INT8, "dual_sub_int8"},
-                                                              {ge::DT_DUAL_SUB_UINT8, "dual_sub_uint8"}};
+// dtype names of the tbe tensors, shared with the tiling recorder
+extern const std::map<ge::DataType, std::string> DATATYPE_STRING_MAP{{ge::DT_FLOAT, "float32"},
+                                                                     {ge::DT_FLOAT16, "float16"},
+                                                                     {ge::DT_INT8, "int8"},
+                                                                     {ge::DT_INT16, "int16"},
+                                                                     {ge::DT_INT32, "int32"},
+                                                                     {ge::DT_INT64, "int64"},
+                                                                     {ge::DT_UINT8, "uint8"},
+                                                                     {ge::DT_UINT16, "uint16"},
+                                                                     {ge::DT_UINT32, "uint32"},
+                                                                     {ge::DT_UINT64, "uint64"},
+                                                                     {ge::DT_BOOL, "bool"},
+                                                                     {ge::DT_DOUBLE, "double"},
+                                                                     {ge::DT_DUAL, "dual"},
+                                                                     {ge::DT_DUAL_SUB_INT8, "dual_sub_int8"},
+                                                                     {ge::DT_DUAL_SUB_UINT8, "dual_sub_uint8"}};
 
 std::map<std::string, std::function<Status(TeOpVarAttrArgsImpl *, const std::string &, DataBuf &)>>
     TeOpVarAttrArgsImpl::data_getter_ = {{"Int8", &TeOpVarAttrArgsImpl::GetNodeAttrDataTmpl<int8_t>},
@@ -291,6 +296,7 @@ bool FeedTeOpTensorArg(ge::OpDesc::Vistor<ge::GeTensorDescPtr> &tensor_desc, std
 
 void FeedTeOpConstTensor(const ge::Node &node, const ge::OpDescPtr &op_desc,
                          std::map<std::string, TeConstTensorData> &const_inputs) {
+  // a new operator rather than the view of the node, the node may be tiled by other threads
   ge::Operator op = ge::OpDescUtils::CreateOperatorFromNode(node.shared_from_this());
   std::vector<std::string> inferDepends = op_desc->GetOpInferDepends();
 
@@ -326,33 +332,48 @@ bool GetCompileInfo(const ge::OpDescPtr &op_desc, const char *op_type, const cha
   return true;
 }
 
-bool GetCompileInfoV2(const ge::OpDescPtr &op_desc, const char *op_type, const char *op_name,
-                      optiling::utils::OpCompileInfo &op_compile_info) {
+// key and json attrs of op_desc are read into op_compile_info, the json is taken from the compile info registry
+// once tiling_type has met the key before so it is neither copied nor parsed again
+bool GetRegisteredCompileInfo(const ge::OpDescPtr &op_desc, const std::string &tiling_type, const char *key_attr,
+                              const char *json_attr, const char *op_type, const char *op_name,
+                              optiling::utils::OpCompileInfo &op_compile_info) {
   std::string op_compile_info_key;
-  std::string op_compile_info_json;
-  bool bres = ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_KEY, op_compile_info_key);
+  bool bres = ge::AttrUtils::GetStr(op_desc, key_attr, op_compile_info_key);
   if (!bres) {
     REPORT_CALL_ERROR("E19999",
                       "Can not find the attribute compile info key %s. "
                       "op_type:%s, op_name:%s",
-                      COMPILE_INFO_KEY, op_type, op_name);
+                      key_attr, op_type, op_name);
     return false;
   }
-  ge::AscendString compile_info_key(op_compile_info_key.c_str());
-  op_compile_info.SetKey(compile_info_key);
-  bres = ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_JSON, op_compile_info_json);
+  auto &registry = optiling::utils::OpCompileInfoRegistry::Instance();
+  if (registry.Find(tiling_type, op_compile_info_key, op_compile_info)) {
+    return true;
+  }
+  std::string op_compile_info_json;
+  bres = ge::AttrUtils::GetStr(op_desc, json_attr, op_compile_info_json);
   if (!bres) {
     REPORT_CALL_ERROR("E19999",
                       "Can not find the attribute compile info json%s. "
                       "op_type:%s, op_name:%s",
-                      COMPILE_INFO_JSON, op_type, op_name);
+                      json_attr, op_type, op_name);
     return false;
   }
   ge::AscendString compile_info_value(op_compile_info_json.c_str());
-  op_compile_info.SetValue(compile_info_value);
+  if (!registry.Add(tiling_type, op_compile_info_key, compile_info_value, op_compile_info)) {
+    REPORT_CALL_ERROR("E19999", "Failed to parse compile info of key %s. op_type:%s, op_name:%s",
+                      op_compile_info_key.c_str(), op_type, op_name);
+    return false;
+  }
   return true;
 }
 
+bool GetCompileInfoV2(const ge::OpDescPtr &op_desc, const char *op_type, const char *op_name,
+                      const std::string &tiling_type, optiling::utils::OpCompileInfo &op_compile_info) {
+  return GetRegisteredCompileInfo(op_desc, tiling_type, COMPILE_INFO_KEY, COMPILE_INFO_JSON, op_type, op_name,
+                                  op_compile_info);
+}
+
 bool GetAtomicCleanCompileInfo(const ge::OpDescPtr &op_desc, const char *op_type, const char *op_name,
                                OpCompileInfo &op_compile_info) {
   bool bres = ge::AttrUtils::GetStr(op_desc, ATOMIC_COMPILE_INFO_KEY, op_compile_info.key);
@@ -371,26 +392,8 @@ bool GetAtomicCleanCompileInfo(const ge::OpDescPtr &op_desc, const char *op_type
 
 bool GetAtomicCleanCompileInfoV2(const ge::OpDescPtr &op_desc, const char *op_type, const char *op_name,
                                  optiling::utils::OpCompileInfo &op_compile_info) {
-  std::string op_compile_info_key;
-  std::string op_compile_info_json;
-  bool bres = ge::AttrUtils::GetStr(op_desc, ATOMIC_COMPILE_INFO_KEY, op_compile_info_key);
-  if (!bres) {
-    REPORT_CALL_ERROR("E19999", "Can not find the attribute %s. op_type:%s, op_name:%s", ATOMIC_COMPILE_INFO_KEY,
-                      op_type, op_name);
-    return false;
-  }
-  ge::AscendString compile_info_key(op_compile_info_key.c_str());
-  op_compile_info.SetKey(compile_info_key);
-
-  bres = ge::AttrUtils::GetStr(op_desc, ATOMIC_COMPILE_INFO_JSON, op_compile_info_json);
-  if (!bres) {
-    REPORT_CALL_ERROR("E19999", "Can not find the attribute %s. op_type:%s, op_name:%s", ATOMIC_COMPILE_INFO_JSON,
-                      op_type, op_name);
-    return false;
-  }
-  ge::AscendString compile_info_value(op_compile_info_json.c_str());
-  op_compile_info.SetValue(compile_info_value);
-  return true;
+  return GetRegisteredCompileInfo(op_desc, op_type, ATOMIC_COMPILE_INFO_KEY, ATOMIC_COMPILE_INFO_JSON, op_type,
+                                  op_name, op_compile_info);
 }
 
 void ParseShapeDesc(const nlohmann::json &shape, std::vector<TeOpTensor> &tensors) {
@@ -594,18 +597,22 @@ void ParseConstTensorList(const nlohmann::json &shape_list, std::map<std::string
   }
 }
 
-std::string DumpByteBuffer(const ByteBuffer &buf) {
+std::string DumpTilingData(const uint8_t *data, size_t size) {
   static const char hex_digits[] = "0123456789ABCDEF";
-  std::string str = buf.str();
   std::string output;
-  output.reserve(str.size() * 2);
-  for (unsigned char c : str) {
-    output.push_back(hex_digits[c >> 4]);
-    output.push_back(hex_digits[c & 15]);
+  output.reserve(size * 2);
+  for (size_t i = 0; i < size; ++i) {
+    output.push_back(hex_digits[data[i] >> 4]);
+    output.push_back(hex_digits[data[i] & 15]);
   }
   return output;
 }
 
+std::string DumpByteBuffer(const ByteBuffer &buf) {
+  std::string str = buf.str();
+  return DumpTilingData(reinterpret_cast<const uint8_t *>(str.data()), str.size());
+}
+
 bool DumpRunInfoV2(optiling::utils::OpRunInfo &run_info, char *run_info_json, size_t run_info_len) {
   if (run_info_json == nullptr) {
     REPORT_CALL_ERROR("E19999", "run_info buffer is null");
@@ -621,7 +628,8 @@ bool DumpRunInfoV2(optiling::utils::OpRunInfo &run_info, char *run_info_json, si
   }
   json_obj["block_dim"] = run_info.GetBlockDim();
   json_obj["workspaces"] = workspaces;
-  json_obj["tiling_data"] = DumpByteBuffer(run_info.GetAllTilingData());
+  const auto &tiling_data = run_info.GetTilingData();
+  json_obj["tiling_data"] = DumpTilingData(tiling_data.GetData(), tiling_data.GetSize());
   json_obj["clear_atomic"] = run_info.GetClearAtomic();
   json_obj["tiling_key"] = run_info.GetTilingKey();
 
@@ -802,9 +810,13 @@ extern "C" int TbeOpTilingPyInterfaceEx2New(const char *optype, const char *comp
   }
 
   optiling::utils::OpCompileInfo op_compile_info{"", compile_info};
-  ge::AscendString opCompileInfoHash(compile_info_hash);
-  if (compile_info_hash) {
-    op_compile_info.SetKey(opCompileInfoHash);
+  const std::string compile_info_key = (compile_info_hash == nullptr) ? "" : compile_info_hash;
+  auto &registry = optiling::utils::OpCompileInfoRegistry::Instance();
+  if (!registry.Find(iter->first, compile_info_key, op_compile_info) &&
+      !registry.Add(iter->first, compile_info_key, ge::AscendString(compile_info), op_compile_info)) {
+    REPORT_CALL_ERROR("E19999", "Failed to parse compile info of key %s. op_type:%s", compile_info_key.c_str(),
+                      optype);
+    return 0;
   }
 
   optiling::utils::OpRunInfo run_info(uint32_t(0), false, uint32_t(0));
@@ -966,125 +978,237 @@ ge::graphStatus TurnToOpParaCalculate(const ge::Node &node, optiling::utils::OpR
   return ge::GRAPH_SUCCESS;
 }
 
-void checkTensordescShape(ge::OpDescPtr &op_desc, std::vector<size_t> &inputsIndexes,
-                          std::vector<size_t> &outputsIndexes) {
-  size_t input_size = op_desc->GetAllInputsSize();
-  ge::GeTensorDesc tensor_temp;
-  for (size_t i = 0; i < input_size; ++ i) {
-    tensor_temp = op_desc->GetInputDesc(i);
-    if (tensor_temp.GetShape().GetShapeSize() == 0) {
-      inputsIndexes.push_back(i);
-      tensor_temp.SetShape(ge::GeShape({1}));
-      op_desc->UpdateInputDesc(i, tensor_temp);
+// The operator handed to a V2 tiling func. Empty shapes are presented as {1} and the infer depend inputs carry
+// their names, as the tiling funcs expect. The patches go to a private copy of the op desc made only when one is
+// needed, so tiling never writes to the graph and one node may be tiled by several threads at once.
+class OpTilingContext {
+ public:
+  explicit OpTilingContext(const ge::Node &node) : node_(node) {}
+  ~OpTilingContext() = default;
+
+  ge::graphStatus Init() {
+    const ge::OpDescPtr op_desc = node_.GetOpDesc();
+    GE_CHECK_NOTNULL(op_desc);
+    if (!NeedPatch(op_desc)) {
+      op_ = ge::OpDescUtils::CreateOperatorFromNode(node_.shared_from_this(), op_desc);
+      return ge::GRAPH_SUCCESS;
     }
-  }
-
-  size_t output_size = op_desc->GetOutputsSize();
-  for (size_t i = 0; i < output_size; ++ i) {
-    tensor_temp = op_desc->GetOutputDesc(i);
-    if (tensor_temp.GetShape().GetShapeSize() == 0) {
-      outputsIndexes.push_back(i);
-      tensor_temp.SetShape(ge::GeShape({1}));
-      op_desc->UpdateOutputDesc(i, tensor_temp);
+    // the copy shares the tensor descs of the node, they are replaced rather than changed
+    const ge::OpDescPtr patched_op_desc = ComGraphMakeShared<ge::OpDesc>(*op_desc);
+    GE_CHECK_NOTNULL(patched_op_desc);
+    for (size_t i = 0U; i < patched_op_desc->GetAllInputsSize(); ++i) {
+      const auto input_desc = patched_op_desc->MutableInputDesc(static_cast<uint32_t>(i));
+      if ((input_desc != nullptr) && (input_desc->GetShape().GetShapeSize() == 0)) {
+        ge::GeTensorDesc tensor_temp = *input_desc;
+        tensor_temp.SetShape(ge::GeShape({1}));
+        (void)patched_op_desc->UpdateInputDesc(static_cast<uint32_t>(i), tensor_temp);
+      }
+    }
+    for (size_t i = 0U; i < patched_op_desc->GetOutputsSize(); ++i) {
+      const auto output_desc = patched_op_desc->MutableOutputDesc(static_cast<uint32_t>(i));
+      if ((output_desc != nullptr) && (output_desc->GetShape().GetShapeSize() == 0)) {
+        ge::GeTensorDesc tensor_temp = *output_desc;
+        tensor_temp.SetShape(ge::GeShape({1}));
+        (void)patched_op_desc->UpdateOutputDesc(static_cast<uint32_t>(i), tensor_temp);
+      }
     }
+    for (const auto &name : patched_op_desc->GetOpInferDepends()) {
+      const auto input_desc = patched_op_desc->MutableInputDesc(name);
+      if ((input_desc != nullptr) && (input_desc->GetName() != name)) {
+        ge::GeTensorDesc tensor_temp = *input_desc;
+        tensor_temp.SetName(name);
+        (void)patched_op_desc->UpdateInputDesc(name, tensor_temp);
+      }
+    }
+    op_ = ge::OpDescUtils::CreateOperatorFromNode(node_.shared_from_this(), patched_op_desc);
+    return ge::GRAPH_SUCCESS;
   }
-}
 
-void backTraceTensordescShape(ge::OpDescPtr &op_desc, const std::vector<size_t> &inputsIndexes,
-                              const std::vector<size_t> &outputsIndexes) {
-  auto iter = inputsIndexes.begin();
-  ge::GeTensorDesc tensor_temp;
-  std::vector<int64_t> noneVec;
-  while(iter != inputsIndexes.end()) {
-    tensor_temp = op_desc->GetInputDesc(*iter);
-    tensor_temp.SetShape(ge::GeShape(noneVec));
-    op_desc->UpdateInputDesc(*iter, tensor_temp);
-    ++ iter;
-  }
-  iter = outputsIndexes.begin();
-  while(iter != outputsIndexes.end()) {
-    tensor_temp = op_desc->GetOutputDesc(*iter);
-    tensor_temp.SetShape(ge::GeShape(noneVec));
-    op_desc->UpdateOutputDesc(*iter, tensor_temp);
-    ++ iter;
+  const ge::Operator &GetOperator() const {
+    return op_;
   }
-}
 
-void addNameToTensordesc(ge::OpDescPtr &op_desc) {
-  std::vector<std::string> inferDepends = op_desc->GetOpInferDepends();
-  ge::GeTensorDesc tensor_temp;
-  for (auto name : inferDepends) {
-    tensor_temp = op_desc->GetInputDesc(name);
-    tensor_temp.SetName(name);
-    op_desc->UpdateInputDesc(name, tensor_temp);
+ private:
+  static bool NeedPatch(const ge::OpDescPtr &op_desc) {
+    for (size_t i = 0U; i < op_desc->GetAllInputsSize(); ++i) {
+      const auto input_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(i));
+      if ((input_desc != nullptr) && (input_desc->GetShape().GetShapeSize() == 0)) {
+        return true;
+      }
+    }
+    for (size_t i = 0U; i < op_desc->GetOutputsSize(); ++i) {
+      const auto output_desc = op_desc->MutableOutputDesc(static_cast<uint32_t>(i));
+      if ((output_desc != nullptr) && (output_desc->GetShape().GetShapeSize() == 0)) {
+        return true;
+      }
+    }
+    for (const auto &name : op_desc->GetOpInferDepends()) {
+      const auto input_desc = op_desc->MutableInputDesc(name);
+      if ((input_desc != nullptr) && (input_desc->GetName() != name)) {
+        return true;
+      }
+    }
+    return false;
   }
-}
 
-extern "C" ge::graphStatus OpParaCalculateNew(const ge::Node &node, optiling::utils::OpRunInfo &run_info,
-                                              std::map<std::string, optiling::utils::OpTilingFuncV2>::iterator iter) {
+  const ge::Node &node_;
+  ge::Operator op_;
+};
+
+namespace {
+// compile_info is the one kept for node at prepare, read from the op and the compile info registry if it is null
+ge::graphStatus CalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info,
+                            std::map<std::string, optiling::utils::OpTilingFuncV2>::iterator iter,
+                            const optiling::utils::OpCompileInfo *compile_info) {
   ge::OpDescPtr op_desc = node.GetOpDesc();
   std::string op_type = op_desc->GetType();
   std::string op_name = op_desc->GetName();
-  std::vector<size_t> inputsIndexes;
-  std::vector<size_t> outputsIndexes;
-  checkTensordescShape(op_desc, inputsIndexes, outputsIndexes);
-  addNameToTensordesc(op_desc);
-  ge::Operator op_param = ge::OpDescUtils::CreateOperatorFromNode(node.shared_from_this());
+  OpTilingContext tiling_context(node);
+  if (tiling_context.Init() != ge::GRAPH_SUCCESS) {
+    REPORT_CALL_ERROR("E19999", "Failed to init tiling context, op_type:%s, op_name:%s", op_type.c_str(),
+                      op_name.c_str());
+    return ge::GRAPH_FAILED;
+  }
+  const ge::Operator &op_param = tiling_context.GetOperator();
   GELOGI("Do optiling, op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
 
   optiling::utils::OpCompileInfo op_compile_info("", "");
-  bool bres = GetCompileInfoV2(op_desc, op_type.c_str(), op_name.c_str(), op_compile_info);
-  if (!bres) {
-    REPORT_CALL_ERROR("E19999", "Failed to get compile_info, op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
-    backTraceTensordescShape(op_desc, inputsIndexes, outputsIndexes);
-    return ge::GRAPH_FAILED;
+  if (compile_info == nullptr) {
+    bool bres = GetCompileInfoV2(op_desc, op_type.c_str(), op_name.c_str(), iter->first, op_compile_info);
+    if (!bres) {
+      REPORT_CALL_ERROR("E19999", "Failed to get compile_info, op_type:%s, op_name:%s", op_type.c_str(),
+                        op_name.c_str());
+      return ge::GRAPH_FAILED;
+    }
+    compile_info = &op_compile_info;
   }
 
   GELOGI("Optiling func found, op_type:%s, op_name:%s, func:[%s:%p]", op_type.c_str(), op_name.c_str(),
          iter->first.c_str(), iter->second.target<optiling::utils::OpTilingFuncV2Ptr>());
-  bool rc = (iter->second)(op_param, op_compile_info, run_info);
+  bool rc = (iter->second)(op_param, *compile_info, run_info);
   if (rc) {
     GELOGI("Optiling succeed. op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
   } else {
     REPORT_CALL_ERROR("E19999", "Optiling failed. op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
   }
-  backTraceTensordescShape(op_desc, inputsIndexes, outputsIndexes);
   return rc ? ge::GRAPH_SUCCESS : ge::GRAPH_FAILED;
 }
+}  // namespace
+
+extern "C" ge::graphStatus OpParaCalculateNew(const ge::Node &node, optiling::utils::OpRunInfo &run_info,
+                                              std::map<std::string, optiling::utils::OpTilingFuncV2>::iterator iter) {
+  return CalculateV2(node, run_info, iter, nullptr);
+}
+
+namespace {
+// resolved for a node once by PrepareOpTilingFunc and kept on its op desc, so a tiling of the node reads it through
+// a pointer rather than a lookup by name
+struct OpTilingPrepared {
+  utils::OpTilingFuncEntry entry;
+  // compile info of a V2 entry, so a tiling neither reads the op attrs nor locks the compile info registry
+  bool has_compile_info = false;
+  utils::OpCompileInfo compile_info;
+  // null if the node has no precomputed run info
+  std::shared_ptr<const OpTilingPrecomputedTable> precomputed;
+};
+
+const OpTilingPrepared *GetOpTilingPrepared(const ge::OpDescPtr &op_desc) {
+  return static_cast<const OpTilingPrepared *>(op_desc->GetTilingFuncInfo().get());
+}
+
+// the entry kept at prepare while the table it came from is current, else the one resolved into resolved_entry.
+// null if the op type has no tiling func
+const utils::OpTilingFuncEntry *FindOpTilingFunc(const ge::OpDescPtr &op_desc, const OpTilingPrepared *prepared,
+                                                 utils::OpTilingFuncEntry &resolved_entry) {
+  auto &table = utils::OpTilingFuncTable::Instance();
+  const utils::OpTilingFuncEntry *entry = &resolved_entry;
+  if ((prepared != nullptr) && (prepared->entry.generation != 0U) &&
+      (prepared->entry.generation == table.GetGeneration())) {
+    entry = &prepared->entry;
+  } else {
+    (void)table.Find(op_desc->GetType(), resolved_entry);
+  }
+  return entry->found ? entry : nullptr;
+}
+}  // namespace
+
+void FreezeOpTilingRegistry() {
+  utils::OpTilingFuncTable::Instance().Freeze();
+}
+
+void ClearOpTilingCompileInfos() {
+  utils::OpCompileInfoRegistry::Instance().Clear();
+}
+
+ge::graphStatus PrepareOpTilingFunc(const ge::Node &node) {
+  const ge::OpDescPtr op_desc = node.GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  std::shared_ptr<const OpTilingPrecomputedTable> precomputed;
+  const ge::graphStatus ret = LoadOpTilingPrecomputed(op_desc, precomputed);
+  if (ret != ge::GRAPH_SUCCESS) {
+    return ret;
+  }
+  auto &table = utils::OpTilingFuncTable::Instance();
+  const bool is_frozen = table.IsFrozen();
+  if (!is_frozen && (precomputed == nullptr)) {
+    GELOGD("Tiling funcs are not frozen, skip preparing node %s.", op_desc->GetName().c_str());
+    op_desc->SetTilingFuncInfo(nullptr);
+    return ge::GRAPH_SUCCESS;
+  }
+  const auto prepared = ComGraphMakeShared<OpTilingPrepared>();
+  GE_CHECK_NOTNULL(prepared);
+  prepared->precomputed = precomputed;
+  // an entry of an unfrozen table keeps generation 0 and is never used, a missing func is kept as well, the tiling
+  // of the node reports it
+  const bool found = !is_frozen || table.Find(op_desc->GetType(), prepared->entry);
+  if (is_frozen && found && prepared->entry.is_v2 && op_desc->HasAttr(COMPILE_INFO_KEY)) {
+    prepared->has_compile_info = GetCompileInfoV2(op_desc, op_desc->GetType().c_str(), op_desc->GetName().c_str(),
+                                                  prepared->entry.v2_iter->first, prepared->compile_info);
+  }
+  op_desc->SetTilingFuncInfo(prepared);
+  if (!found) {
+    GELOGW("Optiling func not found. op_type:%s, op_name:%s", op_desc->GetType().c_str(), op_desc->GetName().c_str());
+    return ge::GRAPH_FAILED;
+  }
+  return ge::GRAPH_SUCCESS;
+}
 
 extern "C" ge::graphStatus OpParaCalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info) {
   ge::OpDescPtr op_desc = node.GetOpDesc();
-  std::string optype = op_desc->GetType();
-  auto &interf_2 = optiling::utils::OpTilingRegistryInterf_V2::RegisteredOpInterf();
-  auto &interf_1 = OpTilingRegistryInterf::RegisteredOpInterf();
-  int flag = 1;
-  auto iter_2 = interf_2.find(optype);
-  auto iter_1 = interf_1.find(optype);
-  if (iter_2 == interf_2.end()) {
-    GELOGI("Optiling func[optype] in V2 not found, turn to find it in V1[optype]. "
-           "op_type:%s",
-           optype.c_str());
-    flag = 0;
-    if (iter_1 == interf_1.end()) {
-      GELOGI("Optiling func[optype] in V1 not found, turn to find it in "
-             "V2[Autotiling]. op_type:%s",
-             optype.c_str());
-      iter_2 = interf_2.find("AutoTiling");
-      flag = 1;
-      if (iter_2 == interf_2.end()) {
-        GELOGI("Optiling func[AutoTiling] in V2 not found, turn to find it in "
-               "V1[Autotiling]. op_type:%s",
-               optype.c_str());
-        iter_1 = interf_1.find("AutoTiling");
-        flag = 0;
-        if (iter_1 == interf_1.end()) {
-          REPORT_CALL_ERROR("E19999", "Optiling func not found. op_type:%s", optype.c_str());
-          return ge::GRAPH_FAILED;
-        }
-      }
-    }
+  // what PrepareOpTilingFunc decided, a node not prepared is tiled by its tiling func
+  const OpTilingPrepared *const prepared = GetOpTilingPrepared(op_desc);
+  if ((prepared != nullptr) && (prepared->precomputed != nullptr) &&
+      FindOpTilingPrecomputed(op_desc, *prepared->precomputed, run_info)) {
+    GELOGD("Tiling of op %s is precomputed. op_type:%s", op_desc->GetName().c_str(), op_desc->GetType().c_str());
+    return ge::GRAPH_SUCCESS;
+  }
+  utils::OpTilingFuncEntry resolved_entry;
+  const utils::OpTilingFuncEntry *const entry = FindOpTilingFunc(op_desc, prepared, resolved_entry);
+  if (entry == nullptr) {
+    REPORT_CALL_ERROR("E19999", "Optiling func not found. op_type:%s", op_desc->GetType().c_str());
+    return ge::GRAPH_FAILED;
   }
-  return (flag == 1 ? OpParaCalculateNew(node, run_info, iter_2) : TurnToOpParaCalculate(node, run_info, iter_1));
+  GELOGD("Optiling func of op %s found in %s. op_type:%s", op_desc->GetName().c_str(), entry->is_v2 ? "V2" : "V1",
+         op_desc->GetType().c_str());
+  auto &recorder = optiling::OpTilingRecorder::Instance();
+  if (recorder.IsRecording()) {
+    recorder.Record(node);
+  }
+  auto &cache = optiling::OpTilingCache::Instance();
+  std::string cache_key;
+  if (cache.IsEnabled() && cache.BuildKey(node, cache_key) && cache.Lookup(cache_key, run_info)) {
+    GELOGD("Tiling of op %s hit the cache. op_type:%s", op_desc->GetName().c_str(), op_desc->GetType().c_str());
+    return ge::GRAPH_SUCCESS;
+  }
+  const bool use_prepared_compile_info =
+      (prepared != nullptr) && (entry == &prepared->entry) && prepared->has_compile_info;
+  const utils::OpCompileInfo *const compile_info = use_prepared_compile_info ? &prepared->compile_info : nullptr;
+  const ge::graphStatus ret = entry->is_v2 ? CalculateV2(node, run_info, entry->v2_iter, compile_info)
+                                           : TurnToOpParaCalculate(node, run_info, entry->v1_iter);
+  if ((ret == ge::GRAPH_SUCCESS) && !cache_key.empty()) {
+    cache.Store(cache_key, run_info);
+  }
+  return ret;
 }
 
 extern "C" ge::graphStatus OpAtomicCalculate(const ge::Node &node, OpRunInfo &run_info) {
@@ -1164,66 +1288,84 @@ ge::graphStatus TurnToOpAtomicCalculate(const ge::Node &node, optiling::utils::O
   return ge::GRAPH_SUCCESS;
 }
 
-bool checkOpRegistryInterf(std::map<std::string, optiling::utils::OpTilingFuncV2> &interf,
-                           std::map<std::string, optiling::utils::OpTilingFuncV2>::iterator iter, std::string op_name,
-                           std::string op_type) {
-  if (iter == interf.end()) {
-    GELOGI("Atomic optiling func on the new way is not found, turn "
-           "to the old way, op_type:%s, op_name:%s",
-           op_type.c_str(), op_name.c_str());
-    return false;
-  }
-  return true;
+namespace {
+const char *const kAtomicCleanOpType = "DynamicAtomicAddrClean";
+
+// The atomic clean tiling reads nothing of its operator but the workspace attr, which every call sets. A thread
+// reuses one operator rather than building a new one per node, each of which would stay in the operator keeper.
+ge::Operator &GetAtomicCleanOperator() {
+  static thread_local ge::Operator atomic_op =
+      ge::OpDescUtils::CreateOperatorFromOpDesc(std::make_shared<ge::OpDesc>(kAtomicCleanOpType, kAtomicCleanOpType));
+  return atomic_op;
 }
 
-extern "C" ge::graphStatus OpAtomicCalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info) {
-  ge::OpDescPtr op_desc = node.GetOpDesc();
-  std::string op_type = "DynamicAtomicAddrClean";
-  std::string op_name = op_desc->GetName();
-  std::string origin_op_type = "DynamicAtomicAddrClean";
-  ge::Operator op_param(op_type);
-  auto &interf = optiling::utils::OpTilingRegistryInterf_V2::RegisteredOpInterf();
-  auto iter = interf.find(op_type);
-  if (!checkOpRegistryInterf(interf, iter, op_type, op_name)) {
+ge::graphStatus AtomicCalculateV2(const ge::Node &node, const std::vector<int64_t> &atomic_output_indices,
+                                  optiling::utils::OpRunInfo &run_info) {
+  const ge::OpDescPtr op_desc = node.GetOpDesc();
+  const std::string &op_name = op_desc->GetName();
+  utils::OpTilingFuncEntry entry;
+  if (!utils::OpTilingFuncTable::Instance().FindAtomicClean(entry)) {
+    GELOGI("Atomic optiling func on the new way is not found, turn "
+           "to the old way, op_type:%s, op_name:%s",
+           kAtomicCleanOpType, op_name.c_str());
     return TurnToOpAtomicCalculate(node, run_info);
   }
-  GELOGI("Do Atomic optiling. op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
-  std::vector<int64_t> atomic_output_indices;
-  (void) ge::AttrUtils::GetListInt(op_desc, ge::ATOMIC_ATTR_OUTPUT_INDEX, atomic_output_indices);
+  GELOGI("Do Atomic optiling. op_type:%s, op_name:%s", kAtomicCleanOpType, op_name.c_str());
   if (atomic_output_indices.empty()) {
-    REPORT_CALL_ERROR("E19999", "No ATOMIC_ATTR_OUTPUT_INDEX found, op_type:%s, op_name:%s", origin_op_type.c_str(),
+    REPORT_CALL_ERROR("E19999", "No ATOMIC_ATTR_OUTPUT_INDEX found, op_type:%s, op_name:%s", kAtomicCleanOpType,
                       op_name.c_str());
     return ge::GRAPH_FAILED;
   }
   ge::GeTensorDescPtr tensor = op_desc->MutableOutputDesc(atomic_output_indices[0]);
   if (tensor == nullptr) {
-    REPORT_CALL_ERROR("E19999", "Get MutableOutputDesc failed. op_type:%s, op_name:%s", origin_op_type.c_str(),
+    REPORT_CALL_ERROR("E19999", "Get MutableOutputDesc failed. op_type:%s, op_name:%s", kAtomicCleanOpType,
                       op_name.c_str());
     return ge::GRAPH_FAILED;
   }
   int64_t clean_size = 0;
-  vector<int> workspace_list;
   auto res = ge::TensorUtils::GetSize(*tensor, clean_size);
   if (res != ge::GRAPH_SUCCESS) {
-    REPORT_CALL_ERROR("E19999", "Get size of tensor desc failed. op_type:%s, op_name:%s", origin_op_type.c_str(),
+    REPORT_CALL_ERROR("E19999", "Get size of tensor desc failed. op_type:%s, op_name:%s", kAtomicCleanOpType,
                       op_name.c_str());
     return ge::GRAPH_FAILED;
   }
-  GELOGI("Atomic clean size: %ld, op_type:%s, op_name:%s", clean_size, origin_op_type.c_str(), op_name.c_str());
-  workspace_list.push_back(clean_size);
-  op_param.SetAttr(ATTR_NAME_ATOMIC_CLEAN_WORKSPACE, workspace_list);
+  GELOGI("Atomic clean size: %ld, op_type:%s, op_name:%s", clean_size, kAtomicCleanOpType, op_name.c_str());
   optiling::utils::OpCompileInfo op_compile_info("", "");
-  bool bres = GetAtomicCleanCompileInfoV2(op_desc, op_type.c_str(), op_name.c_str(), op_compile_info);
+  bool bres = GetAtomicCleanCompileInfoV2(op_desc, kAtomicCleanOpType, op_name.c_str(), op_compile_info);
   if (!bres) {
-    REPORT_CALL_ERROR("E19999", "Failed to get compile_info, op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
+    REPORT_CALL_ERROR("E19999", "Failed to get compile_info, op_type:%s, op_name:%s", kAtomicCleanOpType,
+                      op_name.c_str());
     return ge::GRAPH_FAILED;
   }
-  bool rc = (iter->second)(op_param, op_compile_info, run_info);
+  ge::Operator &op_param = GetAtomicCleanOperator();
+  const vector<int> workspace_list = {static_cast<int>(clean_size)};
+  op_param.SetAttr(ATTR_NAME_ATOMIC_CLEAN_WORKSPACE, workspace_list);
+  bool rc = (entry.v2_iter->second)(op_param, op_compile_info, run_info);
   if (rc) {
-    GELOGI("Atomic optiling succeed. op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
+    GELOGI("Atomic optiling succeed. op_type:%s, op_name:%s", kAtomicCleanOpType, op_name.c_str());
   } else {
-    REPORT_CALL_ERROR("E19999", "Atomic optiling failed. op_type:%s, op_name:%s", op_type.c_str(), op_name.c_str());
+    REPORT_CALL_ERROR("E19999", "Atomic optiling failed. op_type:%s, op_name:%s", kAtomicCleanOpType,
+                      op_name.c_str());
   }
   return rc ? ge::GRAPH_SUCCESS : ge::GRAPH_FAILED;
 }
+}  // namespace
+
+extern "C" ge::graphStatus OpAtomicCalculateV2(const ge::Node &node, optiling::utils::OpRunInfo &run_info) {
+  std::vector<int64_t> atomic_output_indices;
+  (void) ge::AttrUtils::GetListInt(node.GetOpDesc(), ge::ATOMIC_ATTR_OUTPUT_INDEX, atomic_output_indices);
+  return AtomicCalculateV2(node, atomic_output_indices, run_info);
+}
+
+ge::graphStatus OpTilingCalculateV2(const ge::Node &node, OpTilingResult &result) {
+  const ge::OpDescPtr op_desc = node.GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  result.status = OpParaCalculateV2(node, result.run_info);
+  std::vector<int64_t> atomic_output_indices;
+  result.has_atomic_clean = ge::AttrUtils::GetListInt(op_desc, ge::ATOMIC_ATTR_OUTPUT_INDEX, atomic_output_indices) &&
+                            !atomic_output_indices.empty();
+  result.atomic_status = result.has_atomic_clean ?
+                         AtomicCalculateV2(node, atomic_output_indices, result.atomic_run_info) : ge::GRAPH_SUCCESS;
+  return (result.status != ge::GRAPH_SUCCESS) ? result.status : result.atomic_status;
+}
 }  // namespace optiling
@@ -0,0 +1,113 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register/op_tiling.h"
+
+#include <atomic>
+#include "common/util/error_manager/error_manager.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_util.h"
+#include "graph/utils/thread_pool.h"
+
+namespace optiling {
+extern const char *COMPILE_INFO_KEY;
+
+namespace {
+// nodes of a batch report to their own work streams, kept apart from the ids generated by the error manager
+const uint64_t kBatchWorkStreamIdBase = 0xFFFF000000000000UL;
+std::atomic<uint64_t> g_batch_work_stream_id{0UL};
+
+void TileNode(const ge::NodePtr &node, const error_message::Context &node_context, OpTilingResult &result) {
+  if ((node == nullptr) || (node->GetOpDesc() == nullptr)) {
+    result.status = ge::GRAPH_PARAM_INVALID;
+    return;
+  }
+  const error_message::Context thread_context = ErrorManager::GetInstance().GetErrorManagerContext();
+  ErrorManager::GetInstance().SetErrorContext(node_context);
+  (void)OpTilingCalculateV2(*node, result);
+  ErrorManager::GetInstance().SetErrorContext(thread_context);
+}
+}  // namespace
+
+ge::graphStatus OpParaCalculateBatch(const std::vector<ge::NodePtr> &nodes, ge::GraphThreadPool *pool,
+                                     std::vector<OpTilingResult> &results) {
+  results.clear();
+  results.resize(nodes.size());
+  // the tiling funcs are kept on the op descs before the workers read them
+  for (const auto &node : nodes) {
+    if (node != nullptr) {
+      (void)PrepareOpTilingFunc(*node);
+    }
+  }
+  // every node reports under the stages of the caller to a work stream of its own
+  const error_message::Context &caller_context = ErrorManager::GetInstance().GetErrorManagerContext();
+  std::vector<error_message::Context> node_contexts(nodes.size(), caller_context);
+  const uint64_t first_id = kBatchWorkStreamIdBase + g_batch_work_stream_id.fetch_add(nodes.size());
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    node_contexts[i].work_stream_id = first_id + i;
+  }
+  const auto tile_nodes = [&nodes, &node_contexts, &results](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      TileNode(nodes[i], node_contexts[i], results[i]);
+    }
+  };
+  if ((pool != nullptr) && (nodes.size() > 1U)) {
+    pool->ParallelFor(nodes.size(), tile_nodes);
+  } else {
+    tile_nodes(0U, nodes.size());
+  }
+
+  // the caller gets the messages and the failures in node order, the same as a serial run on its own context
+  ge::graphStatus ret = ge::GRAPH_SUCCESS;
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    ErrorManager::GetInstance().MoveMessagesToCurrentWorkStream(node_contexts[i].work_stream_id);
+    const auto &result = results[i];
+    const ge::graphStatus status = (result.status != ge::GRAPH_SUCCESS) ? result.status : result.atomic_status;
+    if (status == ge::GRAPH_SUCCESS) {
+      continue;
+    }
+    const std::string node_name = (nodes[i] == nullptr) ? "null" : nodes[i]->GetName();
+    const char *const stage = (result.status != ge::GRAPH_SUCCESS) ? "tiling" : "atomic clean tiling";
+    REPORT_CALL_ERROR("E19999", "The %s of node %s failed, index:%zu.", stage, node_name.c_str(), i);
+    GELOGE(status, "[Calculate][OpPara] The %s of node %s failed, index:%zu.", stage, node_name.c_str(), i);
+    if (ret == ge::GRAPH_SUCCESS) {
+      ret = status;
+    }
+  }
+  return ret;
+}
+
+ge::graphStatus OpParaCalculateGraph(const ge::ComputeGraphPtr &graph, ge::GraphThreadPool *pool,
+                                     std::vector<ge::NodePtr> &nodes, std::vector<OpTilingResult> &results) {
+  GE_CHECK_NOTNULL(graph);
+  nodes.clear();
+  const ge::graphStatus ret = graph->TopologicalSorting();
+  if (ret != ge::GRAPH_SUCCESS) {
+    REPORT_CALL_ERROR("E19999", "TopologicalSorting failed, graph:%s.", graph->GetName().c_str());
+    GELOGE(ret, "[Call][TopologicalSorting] failed, graph:%s.", graph->GetName().c_str());
+    return ret;
+  }
+  for (const auto &node : graph->GetAllNodes()) {
+    if ((node->GetOpDesc() != nullptr) && node->GetOpDesc()->HasAttr(COMPILE_INFO_KEY)) {
+      nodes.emplace_back(node);
+    }
+  }
+  GELOGD("Tile %zu nodes of graph %s, thread num:%u.", nodes.size(), graph->GetName().c_str(),
+         (pool == nullptr) ? 0U : pool->GetThreadNum());
+  return OpParaCalculateBatch(nodes, pool, results);
+}
+}  // namespace optiling
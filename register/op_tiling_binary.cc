@@ -0,0 +1,209 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register/op_tiling_binary.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "common/util/error_manager/error_manager.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_util.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph/utils/scope_guard.h"
+#include "op_tiling_registry_impl.h"
+#include "securec.h"
+
+namespace optiling {
+namespace {
+bool ToGeTensorDesc(const TbeOpTilingTensor &tensor, ge::GeTensorDesc &tensor_desc) {
+  if (((tensor.dims == nullptr) && (tensor.dim_num != 0U)) ||
+      ((tensor.ori_dims == nullptr) && (tensor.ori_dim_num != 0U))) {
+    REPORT_INNER_ERROR("E19999", "dims of tensor %s is null, dim num:%u, ori dim num:%u.",
+                       (tensor.name == nullptr) ? "" : tensor.name, tensor.dim_num, tensor.ori_dim_num);
+    return false;
+  }
+  tensor_desc.SetShape(ge::GeShape(std::vector<int64_t>(tensor.dims, tensor.dims + tensor.dim_num)));
+  tensor_desc.SetFormat(static_cast<ge::Format>(tensor.format));
+  tensor_desc.SetDataType(static_cast<ge::DataType>(tensor.dtype));
+  if (tensor.ori_dims != nullptr) {
+    tensor_desc.SetOriginShape(
+        ge::GeShape(std::vector<int64_t>(tensor.ori_dims, tensor.ori_dims + tensor.ori_dim_num)));
+  }
+  tensor_desc.SetOriginFormat(static_cast<ge::Format>(tensor.ori_format));
+  if (tensor.name != nullptr) {
+    tensor_desc.SetName(tensor.name);
+  }
+  return true;
+}
+
+bool AddTensorDescs(const TbeOpTilingTensor *tensors, uint32_t tensor_num, bool is_input,
+                    const ge::OpDescPtr &op_desc) {
+  if ((tensors == nullptr) && (tensor_num != 0U)) {
+    REPORT_INNER_ERROR("E19999", "%s is null, num:%u.", is_input ? "inputs" : "outputs", tensor_num);
+    return false;
+  }
+  for (uint32_t i = 0U; i < tensor_num; ++i) {
+    ge::GeTensorDesc tensor_desc;
+    if (!ToGeTensorDesc(tensors[i], tensor_desc)) {
+      return false;
+    }
+    ge::graphStatus ret;
+    if (tensors[i].name != nullptr) {
+      ret = is_input ? op_desc->AddInputDesc(tensors[i].name, tensor_desc)
+                     : op_desc->AddOutputDesc(tensors[i].name, tensor_desc);
+    } else {
+      ret = is_input ? op_desc->AddInputDesc(tensor_desc) : op_desc->AddOutputDesc(tensor_desc);
+    }
+    if (ret != ge::GRAPH_SUCCESS) {
+      REPORT_CALL_ERROR("E19999", "Add %s desc %u failed.", is_input ? "input" : "output", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SetConstInputs(const TbeOpTilingTensor *inputs, uint32_t input_num, ge::Operator &op,
+                    std::vector<ge::Operator> &const_ops) {
+  for (uint32_t i = 0U; i < input_num; ++i) {
+    const auto &input = inputs[i];
+    if (input.const_data == nullptr) {
+      continue;
+    }
+    if (input.name == nullptr) {
+      REPORT_INNER_ERROR("E19999", "const input %u has no name.", i);
+      return false;
+    }
+    ge::GeTensorDesc tensor_desc;
+    (void)ToGeTensorDesc(input, tensor_desc);
+    const auto const_tensor = ComGraphMakeShared<ge::GeTensor>(
+        tensor_desc, static_cast<const uint8_t *>(input.const_data), static_cast<size_t>(input.const_size));
+    if (const_tensor == nullptr) {
+      REPORT_CALL_ERROR("E19999", "Create const tensor of input %s failed.", input.name);
+      return false;
+    }
+    const ge::OpDescPtr const_op_desc = ge::OpDescUtils::CreateConstOp(const_tensor);
+    if (const_op_desc == nullptr) {
+      REPORT_CALL_ERROR("E19999", "Create const op of input %s failed.", input.name);
+      return false;
+    }
+    const_ops.emplace_back(ge::OpDescUtils::CreateOperatorFromOpDesc(const_op_desc));
+    (void)op.SetInput(input.name, const_ops.back());
+  }
+  return true;
+}
+
+bool FillRunInfo(utils::OpRunInfo &src, TbeOpTilingRunInfo &dst) {
+  std::vector<int64_t> workspaces;
+  (void)src.GetAllWorkspaces(workspaces);
+  const auto &tiling_data = src.GetTilingData();
+  const uint32_t workspace_capacity = dst.workspace_num;
+  const uint64_t tiling_data_capacity = dst.tiling_data_size;
+  dst.block_dim = src.GetBlockDim();
+  dst.tiling_key = src.GetTilingKey();
+  dst.clear_atomic = src.GetClearAtomic() ? 1 : 0;
+  dst.workspace_num = static_cast<uint32_t>(workspaces.size());
+  dst.tiling_data_size = static_cast<uint64_t>(tiling_data.GetSize());
+  if ((workspaces.size() > workspace_capacity) || (tiling_data.GetSize() > tiling_data_capacity)) {
+    REPORT_INNER_ERROR("E19999", "run info buffer too small, workspace num:%zu/%u, tiling data size:%zu/%lu.",
+                       workspaces.size(), workspace_capacity, tiling_data.GetSize(), tiling_data_capacity);
+    return false;
+  }
+  if (!workspaces.empty()) {
+    if ((dst.workspaces == nullptr) ||
+        (memcpy_s(dst.workspaces, workspace_capacity * sizeof(int64_t), workspaces.data(),
+                  workspaces.size() * sizeof(int64_t)) != EOK)) {
+      REPORT_INNER_ERROR("E19999", "Copy %zu workspaces failed.", workspaces.size());
+      return false;
+    }
+  }
+  if (tiling_data.GetSize() > 0U) {
+    if ((dst.tiling_data == nullptr) ||
+        (memcpy_s(dst.tiling_data, tiling_data_capacity, tiling_data.GetData(), tiling_data.GetSize()) != EOK)) {
+      REPORT_INNER_ERROR("E19999", "Copy tiling data of size %zu failed.", tiling_data.GetSize());
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+}  // namespace optiling
+
+extern "C" int TbeOpTilingBinaryInterface(const char *optype, const char *compile_info, const char *compile_info_hash,
+                                          const TbeOpTilingTensor *inputs, uint32_t input_num,
+                                          const TbeOpTilingTensor *outputs, uint32_t output_num,
+                                          TbeOpTilingRunInfo *run_info, uint64_t *elapse) {
+  if ((optype == nullptr) || (compile_info == nullptr) || (run_info == nullptr)) {
+    REPORT_INNER_ERROR("E19999", "optype/compile_info/run_info is null.");
+    return 0;
+  }
+  optiling::utils::OpTilingFuncEntry entry;
+  if (!optiling::utils::OpTilingFuncTable::Instance().Find(optype, entry)) {
+    REPORT_CALL_ERROR("E19999", "Optiling func not found. op_type:%s", optype);
+    return 0;
+  }
+  if (!entry.is_v2) {
+    REPORT_INNER_ERROR("E19999", "Binary tiling needs a V2 tiling func, op_type:%s", optype);
+    return 0;
+  }
+
+  const ge::OpDescPtr op_desc = ComGraphMakeShared<ge::OpDesc>("", optype);
+  if ((op_desc == nullptr) || !optiling::AddTensorDescs(inputs, input_num, true, op_desc) ||
+      !optiling::AddTensorDescs(outputs, output_num, false, op_desc)) {
+    REPORT_CALL_ERROR("E19999", "Failed to build op desc. op_type:%s", optype);
+    return 0;
+  }
+  // the operators are checked in the operator keeper on creation, they are checked out on every return
+  ge::Operator op_param = ge::OpDescUtils::CreateOperatorFromOpDesc(op_desc);
+  std::vector<ge::Operator> const_ops;
+  const ge::ScopeGuard break_connect([&op_param, &const_ops]() {
+    op_param.BreakConnect();
+    for (const auto &const_op : const_ops) {
+      const_op.BreakConnect();
+    }
+  });
+  if (!optiling::SetConstInputs(inputs, input_num, op_param, const_ops)) {
+    REPORT_CALL_ERROR("E19999", "Failed to set const inputs. op_type:%s", optype);
+    return 0;
+  }
+
+  optiling::utils::OpCompileInfo op_compile_info{"", compile_info};
+  const std::string compile_info_key = (compile_info_hash == nullptr) ? "" : compile_info_hash;
+  auto &registry = optiling::utils::OpCompileInfoRegistry::Instance();
+  if (!registry.Find(entry.v2_iter->first, compile_info_key, op_compile_info) &&
+      !registry.Add(entry.v2_iter->first, compile_info_key, ge::AscendString(compile_info), op_compile_info)) {
+    REPORT_CALL_ERROR("E19999", "Failed to parse compile info of key %s. op_type:%s", compile_info_key.c_str(),
+                      optype);
+    return 0;
+  }
+
+  optiling::utils::OpRunInfo op_run_info(0U, false, 0U);
+  const auto before_tiling = std::chrono::steady_clock::now();
+  const bool rc = (entry.v2_iter->second)(op_param, op_compile_info, op_run_info);
+  const auto after_tiling = std::chrono::steady_clock::now();
+  if (!rc) {
+    REPORT_CALL_ERROR("E19999", "Optiling failed. op_type:%s", optype);
+    return 0;
+  }
+  if (elapse != nullptr) {
+    *elapse = std::chrono::duration_cast<std::chrono::microseconds>(after_tiling - before_tiling).count();
+    *(elapse + 1) = optiling::last_op_tiling_perf;
+    optiling::last_op_tiling_perf = -1;
+  }
+  GELOGD("Optiling succeed. op_type:%s", optype);
+  return optiling::FillRunInfo(op_run_info, *run_info) ? 1 : 0;
+}
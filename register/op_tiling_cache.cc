@@ -0,0 +1,182 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register/op_tiling_cache.h"
+
+#include <functional>
+#include "framework/common/debug/ge_log.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+
+namespace optiling {
+extern const char *COMPILE_INFO_KEY;
+extern const char *COMPILE_INFO_JSON;
+
+namespace {
+template<typename T>
+void AppendValue(const T &value, std::string &key) {
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendDims(const std::vector<int64_t> &dims, std::string &key) {
+  AppendValue(dims.size(), key);
+  for (const auto dim : dims) {
+    AppendValue(dim, key);
+  }
+}
+
+void AppendTensorDescs(const ge::OpDesc::Vistor<ge::GeTensorDescPtr> &descs, std::string &key) {
+  AppendValue(descs.size(), key);
+  for (const auto &desc : descs) {
+    AppendValue(desc->GetDataType(), key);
+    AppendValue(desc->GetFormat(), key);
+    AppendValue(desc->GetOriginFormat(), key);
+    AppendDims(desc->GetShape().GetDims(), key);
+    AppendDims(desc->GetOriginShape().GetDims(), key);
+  }
+}
+}  // namespace
+
+OpTilingCache &OpTilingCache::Instance() {
+  static OpTilingCache instance;
+  return instance;
+}
+
+void OpTilingCache::Enable(const OpTilingCacheOptions &options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_ = options;
+  is_enabled_ = true;
+}
+
+void OpTilingCache::Disable() {
+  is_enabled_ = false;
+  const auto statistics = GetStatistics();
+  GELOGI("Op tiling cache hit %lu, miss %lu, skip %lu, evict %lu, hit rate %.2f%%.", statistics.hit_num,
+         statistics.miss_num, statistics.skip_num, statistics.evict_num, GetHitRate() * 100.0);
+  Clear();
+}
+
+void OpTilingCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  entry_index_.clear();
+  statistics_ = OpTilingCacheStatistics();
+}
+
+void OpTilingCache::SetUncacheable(const std::string &op_type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  (void)options_.uncacheable_op_types.insert(op_type);
+}
+
+OpTilingCacheStatistics OpTilingCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+double OpTilingCache::GetHitRate() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t lookup_num = statistics_.hit_num + statistics_.miss_num;
+  return (lookup_num == 0U) ? 0.0 : (static_cast<double>(statistics_.hit_num) / static_cast<double>(lookup_num));
+}
+
+bool OpTilingCache::BuildKey(const ge::Node &node, std::string &key) {
+  key.clear();
+  const auto op_desc = node.GetOpDesc();
+  if (!is_enabled_ || (op_desc == nullptr)) {
+    return false;
+  }
+  const std::string &op_type = op_desc->GetType();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.uncacheable_op_types.count(op_type) > 0U) {
+      ++statistics_.skip_num;
+      return false;
+    }
+  }
+  key.append(op_type);
+  key.push_back('\0');
+  std::string compile_info_key;
+  if (ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_KEY, compile_info_key) && !compile_info_key.empty()) {
+    key.append(compile_info_key);
+  } else {
+    // without a key the compile info itself tells the kernels apart, its hash and size keep the key short
+    std::string compile_info_json;
+    if (!ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_JSON, compile_info_json)) {
+      key.clear();
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++statistics_.skip_num;
+      return false;
+    }
+    AppendValue(std::hash<std::string>()(compile_info_json), key);
+    AppendValue(compile_info_json.size(), key);
+  }
+  key.push_back('\0');
+  AppendTensorDescs(op_desc->GetAllInputsDescPtr(), key);
+  AppendTensorDescs(op_desc->GetAllOutputsDescPtr(), key);
+  const auto depend_names = op_desc->GetOpInferDepends();
+  if (!depend_names.empty()) {
+    // a new operator rather than the view of the node, the node may be tiled by other threads
+    ge::Operator op = ge::OpDescUtils::CreateOperatorFromNode(node.shared_from_this());
+    for (const auto &depend_name : depend_names) {
+      ge::Tensor data;
+      // the tiling may read a value only known at runtime, such calls must not share a key
+      if (op.GetInputConstData(depend_name.c_str(), data) != ge::GRAPH_SUCCESS) {
+        key.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++statistics_.skip_num;
+        return false;
+      }
+      AppendValue(data.GetSize(), key);
+      key.append(reinterpret_cast<const char *>(data.GetData()), data.GetSize());
+    }
+  }
+  return true;
+}
+
+bool OpTilingCache::Lookup(const std::string &key, utils::OpRunInfo &run_info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto iter = entry_index_.find(key);
+  if (iter == entry_index_.end()) {
+    ++statistics_.miss_num;
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, iter->second);
+  run_info = iter->second->second;
+  ++statistics_.hit_num;
+  return true;
+}
+
+void OpTilingCache::Store(const std::string &key, const utils::OpRunInfo &run_info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!is_enabled_ || (options_.capacity == 0U)) {
+    return;
+  }
+  const auto iter = entry_index_.find(key);
+  if (iter != entry_index_.end()) {
+    iter->second->second = run_info;
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return;
+  }
+  while (entries_.size() >= options_.capacity) {
+    (void)entry_index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++statistics_.evict_num;
+  }
+  entries_.emplace_front(key, run_info);
+  entry_index_[key] = entries_.begin();
+}
+}  // namespace optiling
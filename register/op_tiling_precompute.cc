@@ -0,0 +1,392 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register/op_tiling_precompute.h"
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_util.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+#include "register/op_tiling.h"
+#include "securec.h"
+
+namespace optiling {
+extern const char *COMPILE_INFO_KEY;
+extern const char *COMPILE_INFO_JSON;
+
+const char *ATTR_NAME_OP_TILING_PRECOMPUTED = "_op_tiling_precomputed";
+
+namespace {
+const uint32_t kPrecomputedVersion = 1U;
+
+// a dim of an input which takes every value of its shape range
+struct RangeDim {
+  uint32_t input_index;
+  size_t dim_index;
+  // the origin shape of the input is the same as its shape and follows it
+  bool with_origin;
+  int64_t min_dim;
+  int64_t max_dim;
+};
+
+template<typename T>
+void AppendValue(const T &value, std::string &buffer) {
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendDims(const std::vector<int64_t> &dims, std::string &key) {
+  AppendValue(static_cast<uint64_t>(dims.size()), key);
+  for (const auto dim : dims) {
+    AppendValue(dim, key);
+  }
+}
+
+// the shapes and origin shapes of the inputs tell the precomputed run infos apart
+std::string BuildShapeKey(const ge::OpDescPtr &op_desc) {
+  std::string key;
+  for (const auto &desc : op_desc->GetAllInputsDescPtr()) {
+    AppendDims(desc->GetShape().GetDims(), key);
+    AppendDims(desc->GetOriginShape().GetDims(), key);
+  }
+  return key;
+}
+
+class BufferReader {
+ public:
+  BufferReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+  template<typename T>
+  bool Read(T &value) {
+    const uint8_t *src = nullptr;
+    return Take(sizeof(value), src) && (memcpy_s(&value, sizeof(value), src, sizeof(value)) == EOK);
+  }
+
+  bool Take(size_t size, const uint8_t *&data) {
+    if (size > (size_ - offset_)) {
+      return false;
+    }
+    data = data_ + offset_;
+    offset_ += size;
+    return true;
+  }
+
+  bool IsEnd() const {
+    return offset_ == size_;
+  }
+
+ private:
+  const uint8_t *data_;
+  size_t size_;
+  size_t offset_ = 0U;
+};
+
+// version, entry num, then per entry: key, block dim, tiling key, clear atomic, workspaces, tiling data
+void SerializeTable(std::vector<std::pair<std::string, utils::OpRunInfo>> &entries, std::string &buffer) {
+  AppendValue(kPrecomputedVersion, buffer);
+  AppendValue(static_cast<uint32_t>(entries.size()), buffer);
+  for (auto &entry : entries) {
+    auto &run_info = entry.second;
+    AppendValue(static_cast<uint64_t>(entry.first.size()), buffer);
+    (void)buffer.append(entry.first);
+    AppendValue(run_info.GetBlockDim(), buffer);
+    AppendValue(run_info.GetTilingKey(), buffer);
+    AppendValue(static_cast<uint8_t>(run_info.GetClearAtomic() ? 1U : 0U), buffer);
+    std::vector<int64_t> workspaces;
+    (void)run_info.GetAllWorkspaces(workspaces);
+    AppendValue(static_cast<uint64_t>(workspaces.size()), buffer);
+    for (const auto workspace : workspaces) {
+      AppendValue(workspace, buffer);
+    }
+    const auto &tiling_data = run_info.GetTilingData();
+    AppendValue(static_cast<uint64_t>(tiling_data.GetSize()), buffer);
+    (void)buffer.append(reinterpret_cast<const char *>(tiling_data.GetData()), tiling_data.GetSize());
+  }
+}
+
+bool ParseRunInfo(BufferReader &reader, utils::OpRunInfo &run_info) {
+  uint32_t block_dim = 0U;
+  uint32_t tiling_key = 0U;
+  uint8_t clear_atomic = 0U;
+  uint64_t workspace_num = 0U;
+  if (!reader.Read(block_dim) || !reader.Read(tiling_key) || !reader.Read(clear_atomic) ||
+      !reader.Read(workspace_num)) {
+    return false;
+  }
+  run_info.SetBlockDim(block_dim);
+  run_info.SetTilingKey(tiling_key);
+  run_info.SetClearAtomic(clear_atomic != 0U);
+  for (uint64_t i = 0U; i < workspace_num; ++i) {
+    int64_t workspace = 0;
+    if (!reader.Read(workspace)) {
+      return false;
+    }
+    run_info.AddWorkspace(workspace);
+  }
+  uint64_t tiling_data_size = 0U;
+  const uint8_t *tiling_data = nullptr;
+  if (!reader.Read(tiling_data_size) || !reader.Take(static_cast<size_t>(tiling_data_size), tiling_data)) {
+    return false;
+  }
+  run_info.AddTilingData(reinterpret_cast<const char *>(tiling_data), static_cast<size_t>(tiling_data_size));
+  return true;
+}
+
+bool ParseTable(const ge::OpDescPtr &op_desc, OpTilingPrecomputedTable &table) {
+  ge::Buffer buffer;
+  if (!ge::AttrUtils::GetBytes(op_desc, ATTR_NAME_OP_TILING_PRECOMPUTED, buffer)) {
+    return false;
+  }
+  BufferReader reader(buffer.GetData(), buffer.GetSize());
+  uint32_t version = 0U;
+  uint32_t entry_num = 0U;
+  if (!reader.Read(version) || (version != kPrecomputedVersion) || !reader.Read(entry_num)) {
+    GELOGW("Precomputed run infos of op %s are of version %u rather than %u, ignore them.",
+           op_desc->GetName().c_str(), version, kPrecomputedVersion);
+    return false;
+  }
+  for (uint32_t i = 0U; i < entry_num; ++i) {
+    uint64_t key_size = 0U;
+    const uint8_t *key = nullptr;
+    utils::OpRunInfo run_info;
+    if (!reader.Read(key_size) || !reader.Take(static_cast<size_t>(key_size), key) || !ParseRunInfo(reader, run_info)) {
+      GELOGW("Precomputed run infos of op %s are truncated, ignore them.", op_desc->GetName().c_str());
+      return false;
+    }
+    table[std::string(reinterpret_cast<const char *>(key), static_cast<size_t>(key_size))] = std::move(run_info);
+  }
+  return reader.IsEnd();
+}
+
+bool IsUnknownRank(const ge::GeShape &shape) {
+  return (shape.GetDimNum() == 1U) && (shape.GetDim(0U) == ge::UNKNOWN_DIM_NUM);
+}
+
+bool CollectRangeDims(const ge::OpDescPtr &op_desc, size_t max_shape_num, std::vector<RangeDim> &range_dims,
+                      size_t &shape_num) {
+  shape_num = 1U;
+  for (size_t i = 0U; i < op_desc->GetAllInputsSize(); ++i) {
+    const auto input_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(i));
+    if ((input_desc == nullptr) || !input_desc->GetShape().IsUnknownShape()) {
+      continue;
+    }
+    const auto &shape = input_desc->GetShape();
+    std::vector<std::pair<int64_t, int64_t>> shape_range;
+    if (IsUnknownRank(shape) || (input_desc->GetShapeRange(shape_range) != ge::GRAPH_SUCCESS) ||
+        (shape_range.size() != shape.GetDimNum())) {
+      GELOGI("Input %zu of op %s has no shape range, skip precomputing its tiling.", i, op_desc->GetName().c_str());
+      return false;
+    }
+    const auto &origin_shape = input_desc->GetOriginShape();
+    const bool with_origin = (origin_shape.GetDims() == shape.GetDims());
+    if (!with_origin && origin_shape.IsUnknownShape()) {
+      GELOGI("Origin shape of input %zu of op %s does not follow its shape, skip precomputing its tiling.", i,
+             op_desc->GetName().c_str());
+      return false;
+    }
+    for (size_t j = 0U; j < shape.GetDimNum(); ++j) {
+      if (shape.GetDim(j) != ge::UNKNOWN_DIM) {
+        continue;
+      }
+      const int64_t min_dim = shape_range[j].first;
+      const int64_t max_dim = shape_range[j].second;
+      if ((min_dim < 0) || (max_dim < min_dim) ||
+          (static_cast<uint64_t>(max_dim - min_dim) >= static_cast<uint64_t>(max_shape_num))) {
+        GELOGI("Range [%ld, %ld] of input %zu of op %s is unbounded or too wide, skip precomputing its tiling.",
+               min_dim, max_dim, i, op_desc->GetName().c_str());
+        return false;
+      }
+      shape_num *= static_cast<size_t>(max_dim - min_dim + 1);
+      if (shape_num > max_shape_num) {
+        GELOGI("Op %s has more than %zu shapes, skip precomputing its tiling.", op_desc->GetName().c_str(),
+               max_shape_num);
+        return false;
+      }
+      range_dims.push_back({static_cast<uint32_t>(i), j, with_origin, min_dim, max_dim});
+    }
+  }
+  return true;
+}
+
+// the copy shares the tensor descs of the node, they are replaced before anything writes them
+ge::OpDescPtr CopyOpDesc(const ge::OpDescPtr &op_desc) {
+  const ge::OpDescPtr op_desc_copy = ComGraphMakeShared<ge::OpDesc>(*op_desc);
+  if (op_desc_copy == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0U; i < op_desc_copy->GetAllInputsSize(); ++i) {
+    const auto input_desc = op_desc_copy->MutableInputDesc(static_cast<uint32_t>(i));
+    if (input_desc != nullptr) {
+      (void)op_desc_copy->UpdateInputDesc(static_cast<uint32_t>(i), ge::GeTensorDesc(*input_desc));
+    }
+  }
+  for (size_t i = 0U; i < op_desc_copy->GetOutputsSize(); ++i) {
+    const auto output_desc = op_desc_copy->MutableOutputDesc(static_cast<uint32_t>(i));
+    if (output_desc != nullptr) {
+      (void)op_desc_copy->UpdateOutputDesc(static_cast<uint32_t>(i), ge::GeTensorDesc(*output_desc));
+    }
+  }
+  // the copy is tiled by its tiling func rather than by the run infos of a former precompute
+  (void)op_desc_copy->DelAttr(ATTR_NAME_OP_TILING_PRECOMPUTED);
+  op_desc_copy->SetTilingFuncInfo(nullptr);
+  return op_desc_copy;
+}
+
+bool HasUnknownOutput(const ge::OpDescPtr &op_desc) {
+  for (const auto &output_desc : op_desc->GetAllOutputsDescPtr()) {
+    if (output_desc->GetShape().IsUnknownShape()) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+ge::graphStatus OpTilingPrecompute(const ge::NodePtr &node, const OpTilingPrecomputeOptions &options,
+                                   bool &precomputed) {
+  precomputed = false;
+  GE_CHECK_NOTNULL(node);
+  const ge::OpDescPtr op_desc = node->GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  if ((!options.op_types.empty() && (options.op_types.count(op_desc->GetType()) == 0U)) ||
+      (!op_desc->HasAttr(COMPILE_INFO_KEY) && !op_desc->HasAttr(COMPILE_INFO_JSON))) {
+    return ge::GRAPH_SUCCESS;
+  }
+  if (!op_desc->GetOpInferDepends().empty()) {
+    GELOGI("Tiling of op %s depends on const data, skip precomputing it.", op_desc->GetName().c_str());
+    return ge::GRAPH_SUCCESS;
+  }
+  std::vector<RangeDim> range_dims;
+  size_t shape_num = 0U;
+  if (!CollectRangeDims(op_desc, options.max_shape_num, range_dims, shape_num) || range_dims.empty()) {
+    return ge::GRAPH_SUCCESS;
+  }
+  const bool need_infer = HasUnknownOutput(op_desc);
+
+  // the shapes are tiled on nodes of their own, the node itself is written only once the table is built
+  const auto shape_graph = ComGraphMakeShared<ge::ComputeGraph>(op_desc->GetName() + "_precompute");
+  GE_CHECK_NOTNULL(shape_graph);
+  std::vector<std::pair<std::string, utils::OpRunInfo>> entries;
+  std::vector<int64_t> dims;
+  for (const auto &range_dim : range_dims) {
+    dims.push_back(range_dim.min_dim);
+  }
+  for (size_t n = 0U; n < shape_num; ++n) {
+    const ge::OpDescPtr shape_op_desc = CopyOpDesc(op_desc);
+    GE_CHECK_NOTNULL(shape_op_desc);
+    for (size_t i = 0U; i < range_dims.size(); ++i) {
+      const auto input_desc = shape_op_desc->MutableInputDesc(range_dims[i].input_index);
+      (void)input_desc->MutableShape().SetDim(range_dims[i].dim_index, dims[i]);
+      if (range_dims[i].with_origin) {
+        ge::GeShape origin_shape = input_desc->GetOriginShape();
+        (void)origin_shape.SetDim(range_dims[i].dim_index, dims[i]);
+        input_desc->SetOriginShape(origin_shape);
+      }
+    }
+    if (need_infer) {
+      ge::Operator op = ge::OpDescUtils::CreateOperatorFromOpDesc(shape_op_desc);
+      if ((shape_op_desc->CallInferFunc(op) != ge::GRAPH_SUCCESS) || HasUnknownOutput(shape_op_desc)) {
+        GELOGI("Output shapes of op %s are not inferred, skip precomputing its tiling.", op_desc->GetName().c_str());
+        return ge::GRAPH_SUCCESS;
+      }
+    }
+    const ge::NodePtr shape_node = shape_graph->AddNode(shape_op_desc);
+    GE_CHECK_NOTNULL(shape_node);
+    utils::OpRunInfo run_info;
+    if (OpParaCalculateV2(*shape_node, run_info) == ge::GRAPH_SUCCESS) {
+      entries.emplace_back(BuildShapeKey(shape_op_desc), std::move(run_info));
+    } else {
+      GELOGW("Failed to precompute tiling of op %s for shape %zu, it is left to the runtime tiling.",
+             op_desc->GetName().c_str(), n);
+    }
+    // next shape, the last range dim varies fastest
+    for (size_t i = range_dims.size(); i > 0U; --i) {
+      if (dims[i - 1U] < range_dims[i - 1U].max_dim) {
+        ++dims[i - 1U];
+        break;
+      }
+      dims[i - 1U] = range_dims[i - 1U].min_dim;
+    }
+  }
+
+  std::string buffer;
+  SerializeTable(entries, buffer);
+  if (!ge::AttrUtils::SetBytes(op_desc, ATTR_NAME_OP_TILING_PRECOMPUTED,
+                               ge::Buffer::CopyFrom(reinterpret_cast<const uint8_t *>(buffer.data()),
+                                                    buffer.size()))) {
+    REPORT_CALL_ERROR("E19999", "Failed to set precomputed run infos of op %s.", op_desc->GetName().c_str());
+    GELOGE(ge::GRAPH_FAILED, "[Set][Attr] %s of op %s failed.", ATTR_NAME_OP_TILING_PRECOMPUTED,
+           op_desc->GetName().c_str());
+    return ge::GRAPH_FAILED;
+  }
+  // run infos parsed at a former prepare are stale
+  op_desc->SetTilingFuncInfo(nullptr);
+  GELOGI("Precomputed tiling of op %s for %zu of %zu shapes, %zu bytes.", op_desc->GetName().c_str(), entries.size(),
+         shape_num, buffer.size());
+  precomputed = true;
+  return ge::GRAPH_SUCCESS;
+}
+
+ge::graphStatus OpTilingPrecomputeGraph(const ge::ComputeGraphPtr &graph, const OpTilingPrecomputeOptions &options,
+                                        size_t &precomputed_num) {
+  precomputed_num = 0U;
+  GE_CHECK_NOTNULL(graph);
+  for (const auto &node : graph->GetAllNodes()) {
+    bool precomputed = false;
+    const ge::graphStatus ret = OpTilingPrecompute(node, options, precomputed);
+    if (ret != ge::GRAPH_SUCCESS) {
+      GELOGE(ret, "[Precompute][Tiling] of node %s failed.", node->GetName().c_str());
+      return ret;
+    }
+    precomputed_num += precomputed ? 1U : 0U;
+  }
+  GELOGI("Precomputed tiling of %zu nodes in graph %s.", precomputed_num, graph->GetName().c_str());
+  return ge::GRAPH_SUCCESS;
+}
+
+ge::graphStatus LoadOpTilingPrecomputed(const ge::OpDescPtr &op_desc,
+                                        std::shared_ptr<const OpTilingPrecomputedTable> &table) {
+  table = nullptr;
+  GE_CHECK_NOTNULL(op_desc);
+  if (!op_desc->HasAttr(ATTR_NAME_OP_TILING_PRECOMPUTED)) {
+    return ge::GRAPH_SUCCESS;
+  }
+  const auto parsed_table = ComGraphMakeShared<OpTilingPrecomputedTable>();
+  GE_CHECK_NOTNULL(parsed_table);
+  if (!ParseTable(op_desc, *parsed_table)) {
+    GELOGW("Failed to parse precomputed run infos of op %s, it is tiled at runtime.", op_desc->GetName().c_str());
+    return ge::GRAPH_SUCCESS;
+  }
+  if (!parsed_table->empty()) {
+    table = parsed_table;
+  }
+  return ge::GRAPH_SUCCESS;
+}
+
+bool FindOpTilingPrecomputed(const ge::OpDescPtr &op_desc, const OpTilingPrecomputedTable &table,
+                             utils::OpRunInfo &run_info) {
+  const auto iter = table.find(BuildShapeKey(op_desc));
+  if (iter == table.end()) {
+    return false;
+  }
+  run_info = iter->second;
+  return true;
+}
+}  // namespace optiling
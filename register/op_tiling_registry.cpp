@@ -33,6 +33,7 @@ std::map<std::string, OpTilingFunc> &OpTilingRegistryInterf::RegisteredOpInterf(
 OpTilingRegistryInterf::OpTilingRegistryInterf(std::string op_type, OpTilingFunc func) {
   auto &interf = RegisteredOpInterf();
   interf.emplace(op_type, func);
+  utils::OpTilingFuncTable::Instance().Invalidate();
   GELOGI("Register tiling function: op_type:%s, funcPointer:%p, registered count:%zu", op_type.c_str(),
          func.target<OpTilingFuncPtr>(), interf.size());
 }
@@ -70,9 +71,10 @@ OpRunInfo::OpRunInfo(const OpRunInfo &runinfo) {
   impl_->clear_atomic = runinfo.impl_->clear_atomic;
   impl_->tiling_key = runinfo.impl_->tiling_key;
   impl_->workspaces = runinfo.impl_->workspaces;
-  std::string temp_str = (runinfo.impl_->tiling_data).str();
-  impl_->tiling_data.clear();
-  impl_->tiling_data << temp_str;
+  impl_->tiling_data_buffer = runinfo.impl_->tiling_data_buffer;
+  if (runinfo.impl_->tiling_data_in_stream) {
+    impl_->SetAllTilingData(runinfo.impl_->tiling_data);
+  }
 }
 
 OpRunInfo::OpRunInfo(OpRunInfo &&runinfo) {
@@ -86,9 +88,10 @@ OpRunInfo &OpRunInfo::operator=(const OpRunInfo &runinfo) {
     impl_->clear_atomic = runinfo.impl_->clear_atomic;
     impl_->tiling_key = runinfo.impl_->tiling_key;
     impl_->workspaces = runinfo.impl_->workspaces;
-    std::string temp_str = (runinfo.impl_->tiling_data).str();
-    impl_->tiling_data.clear();
-    impl_->tiling_data << temp_str;
+    impl_->tiling_data_buffer = runinfo.impl_->tiling_data_buffer;
+    if (runinfo.impl_->tiling_data_in_stream) {
+      impl_->SetAllTilingData(runinfo.impl_->tiling_data);
+    }
   }
   return *this;
 }
@@ -100,6 +103,10 @@ OpRunInfo &OpRunInfo::operator=(OpRunInfo &&runinfo) {
   return *this;
 }
 
+OpCompileInfo::OpCompileInfo() {
+  impl_ = make_shared<OpCompileInfoImpl>();
+}
+
 OpCompileInfo::OpCompileInfo(const ge::AscendString &key, const ge::AscendString &value) {
   impl_ = make_shared<OpCompileInfoImpl>(key, value);
 }
@@ -137,9 +144,24 @@ std::map<std::string, OpTilingFuncV2> &OpTilingRegistryInterf_V2::RegisteredOpIn
 OpTilingRegistryInterf_V2::OpTilingRegistryInterf_V2(std::string op_type, OpTilingFuncV2 func) {
   auto &interf = RegisteredOpInterf();
   interf.emplace(op_type, std::move(func));
+  OpTilingFuncTable::Instance().Invalidate();
   GELOGI("Register tiling function by new method: op_type:%s, registered count:%zu", op_type.c_str(), interf.size());
 }
 
+OpTilingRegistryInterf_V2::OpTilingRegistryInterf_V2(std::string op_type, OpTilingFuncV2 func,
+                                                     OpTilingParseFuncV2 parse_func)
+    : OpTilingRegistryInterf_V2(op_type, std::move(func)) {
+  auto &parse_funcs = RegisteredParseFunc();
+  parse_funcs.emplace(op_type, std::move(parse_func));
+  GELOGI("Register compile info parse function: op_type:%s, registered count:%zu", op_type.c_str(),
+         parse_funcs.size());
+}
+
+std::map<std::string, OpTilingParseFuncV2> &OpTilingRegistryInterf_V2::RegisteredParseFunc() {
+  static std::map<std::string, OpTilingParseFuncV2> parse_funcs;
+  return parse_funcs;
+}
+
 void OpRunInfo::SetBlockDim(uint32_t input_block_dim) {
   impl_->SetBlockDim(input_block_dim);
 }
@@ -176,6 +198,14 @@ ByteBuffer &OpRunInfo::GetAllTilingData() {
   return impl_->GetAllTilingData();
 }
 
+TilingDataBuffer &OpRunInfo::GetTilingData() {
+  return impl_->GetTilingData();
+}
+
+void OpRunInfo::ReserveTilingData(size_t capacity) {
+  impl_->GetTilingData().Reserve(capacity);
+}
+
 void OpRunInfo::SetClearAtomic(bool clear_atomic_input) {
   impl_->SetClearAtomic(clear_atomic_input);
 }
@@ -207,5 +237,13 @@ const ge::AscendString &OpCompileInfo::GetKey() const {
 const ge::AscendString &OpCompileInfo::GetValue() const {
   return impl_->GetValue();
 }
+
+void OpCompileInfo::SetParsedInfo(const std::shared_ptr<void> &parsed_info) {
+  impl_->parsed_info = parsed_info;
+}
+
+const std::shared_ptr<void> &OpCompileInfo::GetParsedInfo() const {
+  return impl_->parsed_info;
+}
 }  // namespace utils
 }  // namespace optiling
@@ -18,6 +18,7 @@
 
 #include <securec.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -28,6 +29,66 @@
 namespace optiling {
 namespace utils {
 
+TilingDataBuffer::TilingDataBuffer(size_t capacity) {
+  Reserve(capacity);
+}
+
+TilingDataBuffer::TilingDataBuffer(const TilingDataBuffer &other) {
+  *this = other;
+}
+
+TilingDataBuffer &TilingDataBuffer::operator=(const TilingDataBuffer &other) {
+  if (&other != this) {
+    size_ = 0U;
+    Reserve(other.capacity_);
+    (void)Append(other.data_.get(), other.size_);
+  }
+  return *this;
+}
+
+bool TilingDataBuffer::Append(const void *data, size_t size) {
+  if (size > capacity_ - size_) {
+    return false;
+  }
+  if (size > 0U) {
+    (void)memcpy_s(data_.get() + size_, capacity_ - size_, data, size);
+    size_ += size;
+  }
+  return true;
+}
+
+void TilingDataBuffer::Reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  std::unique_ptr<uint8_t[]> data(new (std::nothrow) uint8_t[capacity]);
+  if (data == nullptr) {
+    GELOGE(ge::GRAPH_FAILED, "[Reserve][TilingData] of %zu bytes failed.", capacity);
+    return;
+  }
+  if (size_ > 0U) {
+    (void)memcpy_s(data.get(), capacity, data_.get(), size_);
+  }
+  data_ = std::move(data);
+  capacity_ = capacity;
+}
+
+void TilingDataBuffer::Clear() {
+  size_ = 0U;
+}
+
+const uint8_t *TilingDataBuffer::GetData() const {
+  return data_.get();
+}
+
+size_t TilingDataBuffer::GetSize() const {
+  return size_;
+}
+
+size_t TilingDataBuffer::GetCapacity() const {
+  return capacity_;
+}
+
 OpCompileInfoImpl::OpCompileInfoImpl(const ge::AscendString &key,
                                      const ge::AscendString &value)
     : str(value), key(key) {}
@@ -59,16 +120,48 @@ ge::graphStatus OpRunInfoImpl::GetAllWorkspaces(
 }
 
 void OpRunInfoImpl::AddTilingData(const char *_value, size_t _size) {
-  tiling_data.write(_value, _size);
-  tiling_data.flush();
+  if (tiling_data_in_stream) {
+    tiling_data.write(_value, _size);
+    return;
+  }
+  if (!tiling_data_buffer.Append(_value, _size)) {
+    tiling_data_buffer.Reserve(std::max({tiling_data_buffer.GetCapacity() * 2U, tiling_data_buffer.GetSize() + _size,
+                                         kDefaultTilingDataCapacity}));
+    (void)tiling_data_buffer.Append(_value, _size);
+  }
 }
 
-ByteBuffer &OpRunInfoImpl::GetAllTilingData() { return tiling_data; }
+ByteBuffer &OpRunInfoImpl::GetAllTilingData() {
+  if (!tiling_data_in_stream) {
+    tiling_data.str("");
+    tiling_data.clear();
+    tiling_data.write(reinterpret_cast<const char *>(tiling_data_buffer.GetData()),
+                      static_cast<std::streamsize>(tiling_data_buffer.GetSize()));
+    tiling_data_buffer.Clear();
+    tiling_data_in_stream = true;
+  }
+  return tiling_data;
+}
 
 void OpRunInfoImpl::SetAllTilingData(ByteBuffer &value) {
+  const std::string temp = value.str();
+  tiling_data.str("");
   tiling_data.clear();
-  std::string temp = value.str();
-  tiling_data << temp;
+  tiling_data_in_stream = false;
+  tiling_data_buffer.Clear();
+  AddTilingData(temp.data(), temp.size());
+}
+
+TilingDataBuffer &OpRunInfoImpl::GetTilingData() {
+  if (tiling_data_in_stream) {
+    const std::string temp = tiling_data.str();
+    tiling_data.str("");
+    tiling_data.clear();
+    tiling_data_in_stream = false;
+    tiling_data_buffer.Clear();
+    AddTilingData(temp.data(), temp.size());
+  }
+  return tiling_data_buffer;
 }
 
 void OpRunInfoImpl::SetClearAtomic(bool clear_atomic_input) {
@@ -90,5 +183,173 @@ void OpCompileInfoImpl::SetValue(const ge::AscendString &value) { str = value; }
 const ge::AscendString &OpCompileInfoImpl::GetKey() const { return key; }
 
 const ge::AscendString &OpCompileInfoImpl::GetValue() const { return str; }
+
+OpCompileInfoRegistry &OpCompileInfoRegistry::Instance() {
+  static OpCompileInfoRegistry registry;
+  return registry;
+}
+
+bool OpCompileInfoRegistry::Find(const std::string &tiling_type, const std::string &key,
+                                 OpCompileInfo &compile_info) {
+  if (key.empty()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto iter = compile_infos_.find(tiling_type + '\0' + key);
+  if (iter == compile_infos_.end()) {
+    return false;
+  }
+  compile_info = iter->second;
+  return true;
+}
+
+bool OpCompileInfoRegistry::Add(const std::string &tiling_type, const std::string &key,
+                                const ge::AscendString &json, OpCompileInfo &compile_info) {
+  compile_info.SetKey(ge::AscendString(key.c_str()));
+  compile_info.SetValue(json);
+  const auto &parse_funcs = OpTilingRegistryInterf_V2::RegisteredParseFunc();
+  const auto parse_iter = parse_funcs.find(tiling_type);
+  if (parse_iter != parse_funcs.end()) {
+    // parsed out of the lock, if two threads meet the same new key the first stored one is kept
+    const auto parsed_info = parse_iter->second(json);
+    if (parsed_info == nullptr) {
+      GELOGE(ge::GRAPH_FAILED, "[Parse][CompileInfo] of tiling type %s failed, key:%s.", tiling_type.c_str(),
+             key.c_str());
+      return false;
+    }
+    compile_info.SetParsedInfo(parsed_info);
+  }
+  if (key.empty()) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto ret = compile_infos_.emplace(tiling_type + '\0' + key, compile_info);
+  if (!ret.second) {
+    compile_info = ret.first->second;
+  }
+  GELOGD("Add compile info of tiling type %s, key:%s, registered count:%zu.", tiling_type.c_str(), key.c_str(),
+         compile_infos_.size());
+  return true;
+}
+
+void OpCompileInfoRegistry::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  compile_infos_.clear();
+}
+
+size_t OpCompileInfoRegistry::GetSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return compile_infos_.size();
+}
+
+namespace {
+const char *const kAutoTilingType = "AutoTiling";
+const char *const kAtomicCleanType = "DynamicAtomicAddrClean";
+}  // namespace
+
+OpTilingFuncTable &OpTilingFuncTable::Instance() {
+  static OpTilingFuncTable table;
+  return table;
+}
+
+OpTilingFuncEntry OpTilingFuncTable::Resolve(const std::string &op_type) {
+  auto &interf_2 = OpTilingRegistryInterf_V2::RegisteredOpInterf();
+  auto &interf_1 = OpTilingRegistryInterf::RegisteredOpInterf();
+  OpTilingFuncEntry entry;
+  entry.v2_iter = interf_2.find(op_type);
+  if (entry.v2_iter != interf_2.end()) {
+    entry.found = true;
+    entry.is_v2 = true;
+    return entry;
+  }
+  entry.v1_iter = interf_1.find(op_type);
+  if (entry.v1_iter != interf_1.end()) {
+    entry.found = true;
+    return entry;
+  }
+  entry.v2_iter = interf_2.find(kAutoTilingType);
+  if (entry.v2_iter != interf_2.end()) {
+    entry.found = true;
+    entry.is_v2 = true;
+    return entry;
+  }
+  entry.v1_iter = interf_1.find(kAutoTilingType);
+  entry.found = (entry.v1_iter != interf_1.end());
+  return entry;
+}
+
+OpTilingFuncEntry OpTilingFuncTable::ResolveAtomicClean() {
+  auto &interf_2 = OpTilingRegistryInterf_V2::RegisteredOpInterf();
+  OpTilingFuncEntry entry;
+  entry.v2_iter = interf_2.find(kAtomicCleanType);
+  entry.found = (entry.v2_iter != interf_2.end());
+  entry.is_v2 = entry.found;
+  return entry;
+}
+
+void OpTilingFuncTable::Freeze() {
+  std::unique_ptr<FrozenTable> table(new (std::nothrow) FrozenTable());
+  if (table == nullptr) {
+    GELOGW("Failed to create the frozen table, tiling funcs are looked up by op type.");
+    return;
+  }
+  for (const auto &interf : OpTilingRegistryInterf_V2::RegisteredOpInterf()) {
+    (void)table->entries.emplace(interf.first, Resolve(interf.first));
+  }
+  for (const auto &interf : OpTilingRegistryInterf::RegisteredOpInterf()) {
+    if (table->entries.count(interf.first) == 0U) {
+      (void)table->entries.emplace(interf.first, Resolve(interf.first));
+    }
+  }
+  table->auto_tiling = Resolve(kAutoTilingType);
+  table->atomic_clean = ResolveAtomicClean();
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t generation = generation_.load() + 1U;
+  for (auto &entry : table->entries) {
+    entry.second.generation = generation;
+  }
+  table->auto_tiling.generation = generation;
+  table->atomic_clean.generation = generation;
+  const size_t entry_num = table->entries.size();
+  table_.store(table.get(), std::memory_order_release);
+  tables_.emplace_back(std::move(table));
+  generation_.store(generation);
+  GELOGI("Freeze tiling funcs of %zu op types, generation:%lu.", entry_num, generation);
+}
+
+void OpTilingFuncTable::Invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (table_.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+  table_.store(nullptr, std::memory_order_release);
+  ++generation_;
+  GELOGI("Tiling funcs changed, drop the frozen table.");
+}
+
+bool OpTilingFuncTable::IsFrozen() const {
+  return table_.load(std::memory_order_acquire) != nullptr;
+}
+
+uint64_t OpTilingFuncTable::GetGeneration() const {
+  return generation_.load();
+}
+
+bool OpTilingFuncTable::Find(const std::string &op_type, OpTilingFuncEntry &entry) const {
+  const FrozenTable *const table = table_.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    entry = Resolve(op_type);
+    return entry.found;
+  }
+  const auto iter = table->entries.find(op_type);
+  entry = (iter == table->entries.end()) ? table->auto_tiling : iter->second;
+  return entry.found;
+}
+
+bool OpTilingFuncTable::FindAtomicClean(OpTilingFuncEntry &entry) const {
+  const FrozenTable *const table = table_.load(std::memory_order_acquire);
+  entry = (table == nullptr) ? ResolveAtomicClean() : table->atomic_clean;
+  return entry.found;
+}
 }  // namespace utils
 }  // namespace optiling
@@ -17,9 +17,12 @@
 #ifndef __OP_TILING_REGISTRY_IMPL_H__
 #define __OP_TILING_REGISTRY_IMPL_H__
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "external/graph/tensor.h"
@@ -50,6 +53,7 @@ class OpRunInfoImpl {
   void AddTilingData(const char *value, size_t size);
   ByteBuffer &GetAllTilingData();
   void SetAllTilingData(ByteBuffer &value);
+  TilingDataBuffer &GetTilingData();
 
   void SetClearAtomic(bool clear_atomic);
   bool GetClearAtomic() const;
@@ -60,8 +64,13 @@ class OpRunInfoImpl {
   uint32_t block_dim;
   bool clear_atomic;
   uint32_t tiling_key;
+  // the data lives in tiling_data only after GetAllTilingData has handed the stream out
+  TilingDataBuffer tiling_data_buffer{kDefaultTilingDataCapacity};
   ByteBuffer tiling_data;
+  bool tiling_data_in_stream = false;
   std::vector<int64_t> workspaces;
+
+  static const size_t kDefaultTilingDataCapacity = 256U;
 };
 
 class OpCompileInfoImpl {
@@ -78,6 +87,76 @@ class OpCompileInfoImpl {
 
   ge::AscendString str;
   ge::AscendString key;
+  std::shared_ptr<void> parsed_info;
+};
+
+// Compile infos of the V2 tiling funcs by tiling func type and compile info key. The json of a key is read from the
+// op and parsed only the first time the key is seen, later calls share the stored json and parsed object.
+class OpCompileInfoRegistry {
+ public:
+  static OpCompileInfoRegistry &Instance();
+
+  // false if key of tiling_type has not been added
+  bool Find(const std::string &tiling_type, const std::string &key, OpCompileInfo &compile_info);
+  // Parses json by the parse func of tiling_type if there is one, the result is kept unless key is empty.
+  // false if the parse func fails
+  bool Add(const std::string &tiling_type, const std::string &key, const ge::AscendString &json,
+           OpCompileInfo &compile_info);
+  void Clear();
+  size_t GetSize() const;
+
+ private:
+  OpCompileInfoRegistry() = default;
+
+  std::unordered_map<std::string, OpCompileInfo> compile_infos_;
+  mutable std::mutex mutex_;
+};
+
+// The tiling func of an op type: the V2 func of the type, else the V1 one, else the V2 and then the V1 AutoTiling.
+// The iterators stay valid as funcs are never unregistered.
+struct OpTilingFuncEntry {
+  bool found = false;
+  bool is_v2 = false;
+  std::map<std::string, OpTilingFuncV2>::iterator v2_iter;
+  std::map<std::string, OpTilingFunc>::iterator v1_iter;
+  // generation of the table the entry was resolved by, an entry of an older generation may be stale
+  uint64_t generation = 0U;
+};
+
+// Flat view of the V1 and V2 tiling func registries. Freeze builds a hash table of all the registered types once
+// the tiling plugins are loaded, lookups then take no lock and touch neither registry. A later registration drops
+// the table and lookups resolve from the registries again until the next Freeze.
+class OpTilingFuncTable {
+ public:
+  static OpTilingFuncTable &Instance();
+
+  void Freeze();
+  void Invalidate();
+  bool IsFrozen() const;
+  uint64_t GetGeneration() const;
+
+  // false if neither op_type nor AutoTiling has a tiling func
+  bool Find(const std::string &op_type, OpTilingFuncEntry &entry) const;
+  // V2 func of the atomic clean op, false if it is only registered as V1
+  bool FindAtomicClean(OpTilingFuncEntry &entry) const;
+
+ private:
+  struct FrozenTable {
+    std::unordered_map<std::string, OpTilingFuncEntry> entries;
+    OpTilingFuncEntry auto_tiling;
+    OpTilingFuncEntry atomic_clean;
+  };
+
+  OpTilingFuncTable() = default;
+  static OpTilingFuncEntry Resolve(const std::string &op_type);
+  static OpTilingFuncEntry ResolveAtomicClean();
+
+  // published as a whole at freeze and never changed after, readers load it without a lock.
+  // A dropped table may still be read by a tiling in flight, so every table lives in tables_ till the end
+  std::atomic<const FrozenTable *> table_{nullptr};
+  std::vector<std::unique_ptr<const FrozenTable>> tables_;
+  std::mutex mutex_;
+  std::atomic<uint64_t> generation_{0U};
 };
 }  // namespace utils
 }  // namespace optiling
@@ -0,0 +1,355 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register/op_tiling_replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <nlohmann/json.hpp>
+#include "common/util/error_manager/error_manager.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph/utils/type_utils.h"
+#include "op_tiling_registry_impl.h"
+#include "securec.h"
+
+namespace optiling {
+extern const char *COMPILE_INFO_KEY;
+extern const char *COMPILE_INFO_JSON;
+extern const std::map<ge::DataType, std::string> DATATYPE_STRING_MAP;
+
+// the parsers of TbeOpTilingPyInterfaceEx2, shared so that a corpus reads the same as the py interface
+void ParseShapeDescList(const nlohmann::json &shape_list, std::vector<TeOpTensorArg> &op_args);
+void ParseConstTensorList(const nlohmann::json &shape_list, std::map<std::string, TeConstTensorData> &const_tensors,
+                          std::map<std::string, std::vector<uint8_t>> &const_values);
+void ParseShapeDescListV2(const nlohmann::json &shape_list, ge::OpDescPtr &op_desc, std::string Flag);
+void ParseConstTensorListV2(const nlohmann::json &shape_list, ge::Operator &operator_para,
+                            std::map<std::string, std::vector<uint8_t>> &const_values, ge::OpDescPtr op_desc);
+
+namespace {
+const char *const kEnvRecordPath = "OP_TILING_RECORD_PATH";
+
+// dtype names of the tbe tensors as TbeOpTilingPyInterfaceEx2 gets them, empty for the ones it cannot carry
+std::string ToTbeDataType(ge::DataType data_type) {
+  const auto iter = DATATYPE_STRING_MAP.find(data_type);
+  return (iter == DATATYPE_STRING_MAP.end()) ? "" : iter->second;
+}
+
+template<typename T>
+nlohmann::json ToJsonArray(const uint8_t *data, size_t size) {
+  std::vector<T> values(size / sizeof(T));
+  if (!values.empty()) {
+    (void)memcpy_s(values.data(), values.size() * sizeof(T), data, values.size() * sizeof(T));
+  }
+  return nlohmann::json(values);
+}
+
+// the inverse of CopyConstData, false for the dtypes a corpus cannot carry
+bool ConstDataToJson(const std::string &dtype, const uint8_t *data, size_t size, nlohmann::json &json_array) {
+  if (dtype == "int8") {
+    json_array = ToJsonArray<int8_t>(data, size);
+  } else if (dtype == "uint8") {
+    json_array = ToJsonArray<uint8_t>(data, size);
+  } else if (dtype == "int16") {
+    json_array = ToJsonArray<int16_t>(data, size);
+  } else if (dtype == "uint16") {
+    json_array = ToJsonArray<uint16_t>(data, size);
+  } else if (dtype == "int32") {
+    json_array = ToJsonArray<int32_t>(data, size);
+  } else if (dtype == "uint32") {
+    json_array = ToJsonArray<uint32_t>(data, size);
+  } else if (dtype == "int64") {
+    json_array = ToJsonArray<int64_t>(data, size);
+  } else if (dtype == "uint64") {
+    json_array = ToJsonArray<uint64_t>(data, size);
+  } else if (dtype == "float32") {
+    json_array = ToJsonArray<float>(data, size);
+  } else if (dtype == "double") {
+    json_array = ToJsonArray<double>(data, size);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+nlohmann::json TensorDescToJson(const std::string &name, const ge::GeTensorDesc &tensor_desc) {
+  nlohmann::json tensor_json;
+  tensor_json["name"] = name;
+  tensor_json["shape"] = tensor_desc.GetShape().GetDims();
+  tensor_json["ori_shape"] = tensor_desc.GetOriginShape().GetDims();
+  tensor_json["format"] = ge::TypeUtils::FormatToSerialString(tensor_desc.GetFormat());
+  tensor_json["ori_format"] = ge::TypeUtils::FormatToSerialString(tensor_desc.GetOriginFormat());
+  tensor_json["dtype"] = ToTbeDataType(tensor_desc.GetDataType());
+  return tensor_json;
+}
+
+double Percentile(const std::vector<double> &sorted_values, double ratio) {
+  if (sorted_values.empty()) {
+    return 0.0;
+  }
+  // nearest rank
+  const auto rank = static_cast<size_t>(std::ceil(ratio * static_cast<double>(sorted_values.size())));
+  return sorted_values[std::min(std::max(rank, static_cast<size_t>(1U)), sorted_values.size()) - 1U];
+}
+}  // namespace
+
+OpTilingRecorder &OpTilingRecorder::Instance() {
+  static OpTilingRecorder recorder;
+  return recorder;
+}
+
+OpTilingRecorder::OpTilingRecorder() {
+  const char *const corpus_path = std::getenv(kEnvRecordPath);
+  if ((corpus_path != nullptr) && (corpus_path[0] != '\0')) {
+    (void)Start(corpus_path);
+  }
+}
+
+ge::graphStatus OpTilingRecorder::Start(const std::string &corpus_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (corpus_.is_open()) {
+    corpus_.close();
+  }
+  corpus_.open(corpus_path, std::ios::out | std::ios::app);
+  if (!corpus_.is_open()) {
+    recording_ = false;
+    REPORT_CALL_ERROR("E19999", "Open tiling corpus %s failed.", corpus_path.c_str());
+    GELOGE(ge::GRAPH_FAILED, "[Open][Corpus] Open tiling corpus %s failed.", corpus_path.c_str());
+    return ge::GRAPH_FAILED;
+  }
+  record_num_ = 0U;
+  recording_ = true;
+  GELOGI("Start recording tilings to %s.", corpus_path.c_str());
+  return ge::GRAPH_SUCCESS;
+}
+
+void OpTilingRecorder::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  recording_ = false;
+  if (corpus_.is_open()) {
+    corpus_.close();
+  }
+  GELOGI("Stop recording tilings, %zu recorded.", record_num_);
+}
+
+size_t OpTilingRecorder::GetRecordNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return record_num_;
+}
+
+void OpTilingRecorder::Record(const ge::Node &node) {
+  const ge::OpDescPtr op_desc = node.GetOpDesc();
+  if (op_desc == nullptr) {
+    return;
+  }
+  nlohmann::json record;
+  std::string compile_info_key;
+  std::string compile_info_json;
+  (void)ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_KEY, compile_info_key);
+  (void)ge::AttrUtils::GetStr(op_desc, COMPILE_INFO_JSON, compile_info_json);
+  record["op_type"] = op_desc->GetType();
+  record["compile_info_key"] = compile_info_key;
+  record["compile_info"] = compile_info_json;
+
+  const ge::Operator op = ge::OpDescUtils::CreateOperatorFromNode(node.shared_from_this());
+  nlohmann::json inputs = nlohmann::json::array();
+  for (size_t i = 0U; i < op_desc->GetAllInputsSize(); ++i) {
+    const auto input_desc = op_desc->MutableInputDesc(static_cast<uint32_t>(i));
+    if (input_desc == nullptr) {
+      continue;
+    }
+    const std::string name = op_desc->GetInputNameByIndex(static_cast<uint32_t>(i));
+    nlohmann::json tensor_json = TensorDescToJson(name, *input_desc);
+    ge::Tensor const_data;
+    if (op.GetInputConstData(name.c_str(), const_data) == ge::GRAPH_SUCCESS) {
+      nlohmann::json const_value;
+      if (ConstDataToJson(tensor_json["dtype"].get<std::string>(), const_data.GetData(), const_data.GetSize(),
+                          const_value)) {
+        tensor_json["const_value"] = const_value;
+      } else {
+        GELOGW("Const input %s of op %s is recorded without its value, dtype:%s.", name.c_str(),
+               op_desc->GetName().c_str(), tensor_json["dtype"].get<std::string>().c_str());
+      }
+    }
+    inputs.emplace_back(tensor_json);
+  }
+  nlohmann::json outputs = nlohmann::json::array();
+  for (size_t i = 0U; i < op_desc->GetOutputsSize(); ++i) {
+    const auto output_desc = op_desc->MutableOutputDesc(static_cast<uint32_t>(i));
+    if (output_desc != nullptr) {
+      outputs.emplace_back(TensorDescToJson(op_desc->GetOutputNameByIndex(static_cast<uint32_t>(i)), *output_desc));
+    }
+  }
+  record["inputs"] = inputs;
+  record["outputs"] = outputs;
+
+  const std::string line = record.dump();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!corpus_.is_open()) {
+    return;
+  }
+  corpus_ << line << '\n';
+  (void)corpus_.flush();
+  ++record_num_;
+}
+
+struct OpTilingReplayer::Record {
+  std::string op_type;
+  utils::OpTilingFuncEntry entry;
+  std::map<std::string, std::vector<uint8_t>> const_values;
+  // for a V2 tiling func
+  ge::OpDescPtr op_desc;
+  ge::Operator op;
+  utils::OpCompileInfo compile_info_v2;
+  // for a V1 tiling func
+  TeOpParas op_paras;
+  OpCompileInfo compile_info_v1;
+};
+
+ge::graphStatus OpTilingReplayer::Load(const std::string &corpus_path) {
+  std::ifstream corpus(corpus_path);
+  if (!corpus.is_open()) {
+    REPORT_CALL_ERROR("E19999", "Open tiling corpus %s failed.", corpus_path.c_str());
+    GELOGE(ge::GRAPH_FAILED, "[Open][Corpus] Open tiling corpus %s failed.", corpus_path.c_str());
+    return ge::GRAPH_FAILED;
+  }
+  std::string line;
+  size_t line_no = 0U;
+  while (std::getline(corpus, line)) {
+    ++line_no;
+    if (line.empty()) {
+      continue;
+    }
+    auto record = std::make_shared<Record>();
+    try {
+      const nlohmann::json record_json = nlohmann::json::parse(line);
+      record->op_type = record_json["op_type"].get<std::string>();
+      if (!utils::OpTilingFuncTable::Instance().Find(record->op_type, record->entry)) {
+        GELOGW("Optiling func not found, skip line %zu. op_type:%s", line_no, record->op_type.c_str());
+        continue;
+      }
+      const std::string compile_info_key = record_json["compile_info_key"].get<std::string>();
+      const std::string compile_info_json = record_json["compile_info"].get<std::string>();
+      const nlohmann::json &inputs_json = record_json["inputs"];
+      const nlohmann::json &outputs_json = record_json["outputs"];
+      if (record->entry.is_v2) {
+        record->op_desc = std::make_shared<ge::OpDesc>("", record->op_type);
+        ParseShapeDescListV2(inputs_json, record->op_desc, "inputs");
+        ParseShapeDescListV2(outputs_json, record->op_desc, "outputs");
+        record->op = ge::OpDescUtils::CreateOperatorFromOpDesc(record->op_desc);
+        ParseConstTensorListV2(inputs_json, record->op, record->const_values, record->op_desc);
+        auto &registry = utils::OpCompileInfoRegistry::Instance();
+        const std::string &tiling_type = record->entry.v2_iter->first;
+        if (!registry.Find(tiling_type, compile_info_key, record->compile_info_v2) &&
+            !registry.Add(tiling_type, compile_info_key, ge::AscendString(compile_info_json.c_str()),
+                          record->compile_info_v2)) {
+          GELOGW("Failed to parse compile info, skip line %zu. op_type:%s", line_no, record->op_type.c_str());
+          continue;
+        }
+      } else {
+        record->op_paras.op_type = record->op_type;
+        ParseShapeDescList(inputs_json, record->op_paras.inputs);
+        ParseShapeDescList(outputs_json, record->op_paras.outputs);
+        ParseConstTensorList(inputs_json, record->op_paras.const_inputs, record->const_values);
+        record->compile_info_v1.str = compile_info_json;
+        record->compile_info_v1.key = compile_info_key;
+      }
+    } catch (...) {
+      GELOGW("Malformed record, skip line %zu of corpus %s.", line_no, corpus_path.c_str());
+      continue;
+    }
+    records_.emplace_back(record);
+  }
+  GELOGI("Load %zu tiling records from %s.", records_.size(), corpus_path.c_str());
+  return ge::GRAPH_SUCCESS;
+}
+
+ge::graphStatus OpTilingReplayer::Replay(uint32_t loop_num, const AllocCounter &alloc_counter,
+                                         std::vector<OpTilingReplayStat> &stats) const {
+  struct Samples {
+    OpTilingReplayStat stat;
+    std::vector<double> latencies;
+    uint64_t alloc_num = 0U;
+    size_t tiling_data_size = 0U;
+  };
+  std::map<std::string, Samples> samples;
+  for (const auto &record : records_) {
+    ++samples[record->op_type].stat.record_num;
+  }
+  for (uint32_t loop = 0U; loop < loop_num; ++loop) {
+    for (const auto &record : records_) {
+      auto &op_samples = samples[record->op_type];
+      bool rc = false;
+      size_t tiling_data_size = 0U;
+      uint64_t alloc_begin = 0U;
+      uint64_t alloc_end = 0U;
+      std::chrono::steady_clock::time_point begin;
+      std::chrono::steady_clock::time_point end;
+      // the run infos are made out of the measurement
+      if (record->entry.is_v2) {
+        utils::OpRunInfo run_info(0U, false, 0U);
+        alloc_begin = alloc_counter ? alloc_counter() : 0U;
+        begin = std::chrono::steady_clock::now();
+        rc = (record->entry.v2_iter->second)(record->op, record->compile_info_v2, run_info);
+        end = std::chrono::steady_clock::now();
+        alloc_end = alloc_counter ? alloc_counter() : 0U;
+        tiling_data_size = run_info.GetTilingData().GetSize();
+      } else {
+        OpRunInfo run_info;
+        alloc_begin = alloc_counter ? alloc_counter() : 0U;
+        begin = std::chrono::steady_clock::now();
+        rc = (record->entry.v1_iter->second)(record->op_paras, record->compile_info_v1, run_info);
+        end = std::chrono::steady_clock::now();
+        alloc_end = alloc_counter ? alloc_counter() : 0U;
+        tiling_data_size = run_info.tiling_data.str().size();
+      }
+      ++op_samples.stat.call_num;
+      if (!rc) {
+        ++op_samples.stat.fail_num;
+        continue;
+      }
+      op_samples.latencies.emplace_back(std::chrono::duration<double, std::micro>(end - begin).count());
+      op_samples.alloc_num += alloc_end - alloc_begin;
+      op_samples.tiling_data_size += tiling_data_size;
+      op_samples.stat.max_tiling_data_size = std::max(op_samples.stat.max_tiling_data_size, tiling_data_size);
+    }
+  }
+
+  stats.clear();
+  for (auto &op_samples : samples) {
+    auto &stat = op_samples.second.stat;
+    auto &latencies = op_samples.second.latencies;
+    stat.op_type = op_samples.first;
+    std::sort(latencies.begin(), latencies.end());
+    stat.p50_us = Percentile(latencies, 0.5);
+    stat.p90_us = Percentile(latencies, 0.9);
+    stat.p99_us = Percentile(latencies, 0.99);
+    stat.max_us = latencies.empty() ? 0.0 : latencies.back();
+    if (!latencies.empty()) {
+      const auto success_num = static_cast<double>(latencies.size());
+      stat.alloc_per_call = static_cast<double>(op_samples.second.alloc_num) / success_num;
+      stat.avg_tiling_data_size = static_cast<double>(op_samples.second.tiling_data_size) / success_num;
+    }
+    stats.emplace_back(stat);
+  }
+  return ge::GRAPH_SUCCESS;
+}
+}  // namespace optiling
@@ -49,6 +49,17 @@
   return kLogHeader;
 }
 
+  thread_local error_message::Context ErrorManager::error_context_ = {0, "", "", ""};
+  error_message::Context &ErrorManager::GetErrorManagerContext() {
+    return error_context_;
+  }
+
+  void ErrorManager::SetErrorContext(error_message::Context error_context) {
+    error_context_ = error_context;
+  }
+
+  void ErrorManager::MoveMessagesToCurrentWorkStream(uint64_t work_stream_id) {}
+
   ///
   /// @brief output error message
   /// @param [in] handle: print handle
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro benchmark of the infer shape of a node when a dynamic shape graph is running, kept out of the unit suite:
+//   runtime_infer_plan_benchmark [loop_num]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "graph/compute_graph.h"
+#include "graph/shape_refiner.h"
+#include "graph/utils/op_desc_utils.h"
+#include "toolchain/slog.h"
+
+// The slog stub reports every level as enabled, the shape dumps of the debug logs would be all that is measured.
+// Only errors are enabled here, as in a production run.
+int CheckLogLevel(int moduleId, int logLevel) {
+  return (logLevel >= DLOG_ERROR) ? 1 : 0;
+}
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double NsPer(const Clock::time_point &begin, const Clock::time_point &end, double num) {
+  return std::chrono::duration<double, std::nano>(end - begin).count() / num;
+}
+
+ge::graphStatus InferFirstOutput(ge::Operator &op) {
+  const auto op_desc = ge::OpDescUtils::GetOpDescFromOperator(op);
+  op_desc->MutableOutputDesc(0U)->SetShape(op_desc->GetInputDesc(0U).GetShape());
+  return ge::GRAPH_SUCCESS;
+}
+
+ge::NodePtr CreateNode(const ge::ComputeGraphPtr &graph, uint32_t output_num) {
+  const auto op_desc = std::make_shared<ge::OpDesc>("relu", "Relu");
+  ge::GeTensorDesc tensor_desc(ge::GeShape({8, 16}), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  for (uint32_t i = 0U; i < output_num; ++i) {
+    (void)op_desc->AddOutputDesc("y" + std::to_string(i), tensor_desc);
+  }
+  op_desc->AddInferFunc(InferFirstOutput);
+  return graph->AddNode(op_desc);
+}
+
+// InferShapeAndTypeForRunning against the plan built for the same node, by turns
+void BenchmarkRun(uint32_t loop_num, uint32_t output_num) {
+  const uint32_t call_num = loop_num * 100U;
+  const auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  const auto node = CreateNode(graph, output_num);
+  const auto plan = ge::RuntimeInferPlan::Build(node, true);
+  if (plan == nullptr) {
+    (void)printf("failed to build the runtime infer plan\n");
+    return;
+  }
+  const uint32_t round_num = 3U;
+  size_t fail_num = 0U;
+  double legacy_ns = 0.0;
+  double plan_ns = 0.0;
+  for (uint32_t i = 0U; i < round_num; ++i) {
+    const auto begin_legacy = Clock::now();
+    for (uint32_t j = 0U; j < call_num; ++j) {
+      fail_num += (ge::ShapeRefiner::InferShapeAndTypeForRunning(node, true) == ge::GRAPH_SUCCESS) ? 0U : 1U;
+    }
+    const auto begin_plan = Clock::now();
+    for (uint32_t j = 0U; j < call_num; ++j) {
+      fail_num += (plan->Run() == ge::GRAPH_SUCCESS) ? 0U : 1U;
+    }
+    const auto end = Clock::now();
+    legacy_ns += NsPer(begin_legacy, begin_plan, call_num) / round_num;
+    plan_ns += NsPer(begin_plan, end, call_num) / round_num;
+  }
+  (void)printf("infer when running, %u outputs: InferShapeAndTypeForRunning %.1f ns/call, plan %.1f ns/call "
+               "(%zu failed)\n", output_num, legacy_ns, plan_ns, fail_num);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t loop_num = (argc > 1) ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000U;
+  BenchmarkRun(loop_num, 1U);
+  BenchmarkRun(loop_num, 4U);
+  return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+class UtestFormatRefiner : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+///  data -> conv(NCHW) -> relu1 -> relu2 -> mul -> output
+///                                  scale -+
+TEST_F(UtestFormatRefiner, InferOriginFormat_FromAnchorPoint) {
+  auto builder = ut::GraphBuilder("graph");
+  auto data = builder.AddNode("data", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {8, 3, 16, 16});
+  auto conv = builder.AddNode("conv", "Conv2D", 1, 1, FORMAT_NCHW, DT_FLOAT, {8, 3, 16, 16});
+  auto relu1 = builder.AddNode("relu1", "Relu", 1, 1, FORMAT_ND, DT_FLOAT, {8, 3, 16, 16});
+  auto relu2 = builder.AddNode("relu2", "Relu", 1, 1, FORMAT_ND, DT_FLOAT, {8, 3, 16, 16});
+  auto scale = builder.AddNode("scale", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {});
+  auto mul = builder.AddNode("mul", "Mul", 2, 1, FORMAT_ND, DT_FLOAT, {8, 3, 16, 16});
+  auto output = builder.AddNode("output", "NetOutput", 1, 0, FORMAT_ND, DT_FLOAT, {8, 3, 16, 16});
+  builder.AddDataEdge(data, 0, conv, 0);
+  builder.AddDataEdge(conv, 0, relu1, 0);
+  builder.AddDataEdge(relu1, 0, relu2, 0);
+  builder.AddDataEdge(relu2, 0, mul, 0);
+  builder.AddDataEdge(scale, 0, mul, 1);
+  builder.AddDataEdge(mul, 0, output, 0);
+  auto graph = builder.GetGraph();
+
+  ASSERT_EQ(graph->InferOriginFormat(), GRAPH_SUCCESS);
+  EXPECT_EQ(data->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  EXPECT_EQ(relu1->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  EXPECT_EQ(relu2->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  EXPECT_EQ(mul->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  EXPECT_EQ(output->GetOpDesc()->GetInputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  // back infer stops at the scalar
+  EXPECT_EQ(scale->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_ND);
+
+  // once the graph is inferred, the data nodes no anchor reaches take the data format of the graph
+  auto data2 = builder.AddNode("data2", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {8, 16, 16, 3});
+  auto relu3 = builder.AddNode("relu3", "Relu", 1, 1, FORMAT_ND, DT_FLOAT, {8, 16, 16, 3});
+  builder.AddDataEdge(data2, 0, relu3, 0);
+  graph->SaveDataFormat(FORMAT_NHWC);
+  ASSERT_EQ(graph->InferOriginFormat(), GRAPH_SUCCESS);
+  EXPECT_EQ(data2->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NHWC);
+  EXPECT_EQ(relu3->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NHWC);
+  EXPECT_EQ(relu1->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+}
+}  // namespace ge
@@ -16,6 +16,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
 
 #define protected public
 #define private public
@@ -24,11 +26,69 @@
 #include "graph/op_desc_impl.h"
 #include "graph_builder_utils.h"
 #include "graph/debug/ge_op_types.h"
+#include "graph/detail/model_serialize_imp.h"
+#include "graph/model.h"
+#include "graph/ge_local_context.h"
+#include "external/ge/ge_api_types.h"
+#include "graph/utils/graph_binary_file.h"
+#include "graph/utils/ge_ir_utils.h"
+#include "graph/utils/attr_utils.h"
 
 #undef private
 #undef protected
 
 namespace ge {
+namespace {
+ComputeGraphPtr BuildGraphWithSubgraph() {
+  auto builder = ut::GraphBuilder("root");
+  auto data = builder.AddNode("data", DATA, 0, 1);
+  auto case_node = builder.AddNode("case", "Case", 1, 1);
+  auto netoutput = builder.AddNode("netoutput", NETOUTPUT, 1, 0);
+  builder.AddDataEdge(data, 0, case_node, 0);
+  builder.AddDataEdge(case_node, 0, netoutput, 0);
+  auto root_graph = builder.GetGraph();
+
+  auto sub_builder = ut::GraphBuilder("sub");
+  auto sub_data = sub_builder.AddNode("sub_data", DATA, 0, 1);
+  auto sub_relu = sub_builder.AddNode("sub_relu", "Relu", 1, 1);
+  auto sub_netoutput = sub_builder.AddNode("sub_netoutput", NETOUTPUT, 1, 0);
+  sub_builder.AddDataEdge(sub_data, 0, sub_relu, 0);
+  sub_builder.AddDataEdge(sub_relu, 0, sub_netoutput, 0);
+  auto subgraph = sub_builder.GetGraph();
+
+  case_node->GetOpDesc()->AddSubgraphName("branch");
+  case_node->GetOpDesc()->SetSubgraphInstanceName(0, "sub");
+  subgraph->SetParentNode(case_node);
+  subgraph->SetParentGraph(root_graph);
+  (void)root_graph->AddSubgraph("sub", subgraph);
+  return root_graph;
+}
+
+ComputeGraphPtr BuildLargeGraph(const std::string &name, int node_num) {
+  auto builder = ut::GraphBuilder(name);
+  auto prev = builder.AddNode(name + "_data", DATA, 0, 1);
+  for (int i = 0; i < node_num; ++i) {
+    auto node = builder.AddNode(name + "_relu_" + std::to_string(i), "Relu", 1, 1);
+    (void)AttrUtils::SetInt(node->GetOpDesc(), "index", i);
+    (void)AttrUtils::SetListStr(node->GetOpDesc(), "names", {"a", "b"});
+    builder.AddDataEdge(prev, 0, node, 0);
+    prev = node;
+  }
+  auto netoutput = builder.AddNode(name + "_netoutput", NETOUTPUT, 1, 0);
+  builder.AddDataEdge(prev, 0, netoutput, 0);
+  return builder.GetGraph();
+}
+
+proto::ModelDef ToModelDef(const ComputeGraphPtr &graph) {
+  Model model("", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(graph));
+  proto::ModelDef model_def;
+  ModelSerializeImp imp;
+  EXPECT_TRUE(imp.SerializeModel(model, &model_def, false));
+  return model_def;
+}
+}  // namespace
+
 class UtestGraphUtils : public testing::Test {
  protected:
   void SetUp() {}
@@ -71,4 +131,121 @@ TEST_F(UtestGraphUtils, InsertNodeBefore_DoNotMoveCtrlEdgeFromAtomicClean) {
   // check atomicclean control-in still on allreuce
   ASSERT_EQ(allreduce->GetInControlNodes().at(0)->GetName(), "atomic_clean");
 }
+
+TEST_F(UtestGraphUtils, LoadGEGraph_FromBinaryFile) {
+  auto root_graph = BuildGraphWithSubgraph();
+  auto model_def = ToModelDef(root_graph);
+  const std::string file_path = "./ut_graph_binary_with_index.bin";
+  ASSERT_TRUE(GraphBinaryFile::Write(model_def, file_path.c_str(), true));
+  // graphs are given back to the caller after the write
+  EXPECT_EQ(model_def.graph_size(), 2);
+  EXPECT_TRUE(GraphBinaryFile::IsBinaryFile(file_path.c_str()));
+
+  ComputeGraphPtr loaded_graph;
+  ASSERT_TRUE(GraphUtils::LoadGEGraph(file_path.c_str(), loaded_graph));
+  EXPECT_EQ(loaded_graph->GetDirectNodesSize(), 3U);
+  EXPECT_EQ(loaded_graph->GetAllSubgraphs().size(), 1U);
+
+  ComputeGraphPtr subgraph;
+  ASSERT_TRUE(GraphUtils::LoadGEGraph(file_path.c_str(), "sub", subgraph));
+  EXPECT_EQ(subgraph->GetName(), "sub");
+  EXPECT_EQ(subgraph->GetDirectNodesSize(), 3U);
+  EXPECT_NE(subgraph->FindNode("sub_relu"), nullptr);
+  ComputeGraphPtr missing_graph;
+  EXPECT_FALSE(GraphUtils::LoadGEGraph(file_path.c_str(), "missing", missing_graph));
+  (void)remove(file_path.c_str());
+}
+
+TEST_F(UtestGraphUtils, WriteBinaryFile_ExceedsMaxDumpFileSize) {
+  auto model_def = ToModelDef(BuildGraphWithSubgraph());
+  const std::string file_path = "./ut_graph_binary_oversized.bin";
+  (void)remove(file_path.c_str());
+  std::map<std::string, std::string> options = {{OPTION_GE_MAX_DUMP_FILE_SIZE, "16"}};
+  GetThreadLocalContext().SetGraphOption(options);
+  EXPECT_FALSE(GraphBinaryFile::Write(model_def, file_path.c_str(), true));
+  EXPECT_EQ(model_def.graph_size(), 2);
+  EXPECT_FALSE(GraphBinaryFile::IsBinaryFile(file_path.c_str()));
+  GetThreadLocalContext().SetGraphOption({});
+  EXPECT_TRUE(GraphBinaryFile::Write(model_def, file_path.c_str(), true));
+  (void)remove(file_path.c_str());
+}
+
+TEST_F(UtestGraphUtils, LoadGEGraph_FromBinaryFileWithoutIndex) {
+  auto model_def = ToModelDef(BuildGraphWithSubgraph());
+  const std::string file_path = "./ut_graph_binary_without_index.bin";
+  ASSERT_TRUE(GraphBinaryFile::Write(model_def, file_path.c_str(), false));
+  proto::ModelDef loaded_def;
+  ASSERT_TRUE(GraphBinaryFile::Read(file_path.c_str(), loaded_def));
+  EXPECT_EQ(loaded_def.graph_size(), 2);
+
+  ComputeGraphPtr subgraph;
+  ASSERT_TRUE(GraphUtils::LoadGEGraph(file_path.c_str(), "sub", subgraph));
+  EXPECT_EQ(subgraph->GetDirectNodesSize(), 3U);
+  (void)remove(file_path.c_str());
+}
+
+TEST_F(UtestGraphUtils, LoadGEGraph_TextFileStillSupported) {
+  auto model_def = ToModelDef(BuildGraphWithSubgraph());
+  const std::string file_path = "./ut_graph_text.txt";
+  GraphUtils::WriteProtoToTextFile(model_def, file_path.c_str());
+  EXPECT_FALSE(GraphBinaryFile::IsBinaryFile(file_path.c_str()));
+
+  ComputeGraphPtr subgraph;
+  ASSERT_TRUE(GraphUtils::LoadGEGraph(file_path.c_str(), "sub", subgraph));
+  EXPECT_EQ(subgraph->GetDirectNodesSize(), 3U);
+  ComputeGraph root_graph("root");
+  EXPECT_TRUE(GraphUtils::LoadGEGraph(file_path.c_str(), root_graph));
+  EXPECT_EQ(root_graph.GetDirectNodesSize(), 3U);
+  (void)remove(file_path.c_str());
+}
+
+TEST_F(UtestGraphUtils, LoadGEGraph_TruncatedBinaryFile) {
+  auto model_def = ToModelDef(BuildGraphWithSubgraph());
+  const std::string file_path = "./ut_graph_binary_truncated.bin";
+  ASSERT_TRUE(GraphBinaryFile::Write(model_def, file_path.c_str(), true));
+  std::string content;
+  {
+    std::ifstream fs(file_path, std::ifstream::binary);
+    content.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream fs(file_path, std::ofstream::binary | std::ofstream::trunc);
+    fs.write(content.data(), static_cast<std::streamsize>(content.size() / 2U));
+  }
+  proto::ModelDef loaded_def;
+  EXPECT_FALSE(GraphBinaryFile::Read(file_path.c_str(), loaded_def));
+  ComputeGraphPtr subgraph;
+  EXPECT_FALSE(GraphUtils::LoadGEGraph(file_path.c_str(), "sub", subgraph));
+  (void)remove(file_path.c_str());
+}
+
+TEST_F(UtestGraphUtils, ConvertGeModelToModelProto_ParallelSameAsSerial) {
+  auto root_graph = BuildLargeGraph("root", 600);
+  auto subgraph = BuildLargeGraph("sub", 300);
+  auto parent_node = root_graph->FindNode("root_relu_0");
+  ASSERT_NE(parent_node, nullptr);
+  parent_node->GetOpDesc()->AddSubgraphName("sub");
+  parent_node->GetOpDesc()->SetSubgraphInstanceName(0, "sub");
+  subgraph->SetParentNode(parent_node);
+  subgraph->SetParentGraph(root_graph);
+  ASSERT_EQ(root_graph->AddSubgraph("sub", subgraph), GRAPH_SUCCESS);
+  Model model("GE", "");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(root_graph));
+
+  onnx::ModelProto serial_proto;
+  ASSERT_TRUE(OnnxUtils::ConvertGeModelToModelProto(model, serial_proto));
+  onnx::ModelProto parallel_proto;
+  OnnxUtils::EncodeOptions options;
+  options.parallel_num = 4U;
+  ASSERT_TRUE(OnnxUtils::ConvertGeModelToModelProto(model, parallel_proto, options));
+  ASSERT_EQ(parallel_proto.graph().node_size(), serial_proto.graph().node_size());
+  EXPECT_EQ(parallel_proto.SerializeAsString(), serial_proto.SerializeAsString());
+
+  const auto &node_proto = parallel_proto.graph().node(1);
+  EXPECT_EQ(node_proto.name(), "root_relu_0");
+  EXPECT_TRUE(std::is_sorted(node_proto.attribute().begin(), node_proto.attribute().end(),
+                             [](const onnx::AttributeProto &lhs, const onnx::AttributeProto &rhs) {
+                               return lhs.name() < rhs.name();
+                             }));
+}
 }  // namespace ge
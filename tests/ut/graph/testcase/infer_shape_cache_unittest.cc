@@ -0,0 +1,117 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/infer_shape_cache.h"
+#include "graph/op_desc.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+
+namespace ge {
+namespace {
+int infer_count = 0;
+
+graphStatus InferDoubleDim0(Operator &op) {
+  ++infer_count;
+  auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+  auto shape = op_desc->GetInputDesc(0).GetShape();
+  int64_t factor = 2;
+  (void)AttrUtils::GetInt(op_desc, "factor", factor);
+  shape.SetDim(0U, shape.GetDim(0U) * factor);
+  op_desc->MutableOutputDesc(0)->SetShape(shape);
+  op_desc->MutableOutputDesc(0)->SetDataType(op_desc->GetInputDesc(0).GetDataType());
+  return GRAPH_SUCCESS;
+}
+
+graphStatus InferWithContext(Operator &op) {
+  (void)op.GetInferenceContext();
+  return InferDoubleDim0(op);
+}
+
+graphStatus InferAndSetAttr(Operator &op) {
+  (void)AttrUtils::SetBool(OpDescUtils::GetOpDescFromOperator(op), "inferred", true);
+  return InferDoubleDim0(op);
+}
+
+OpDescPtr CreateOpDesc(const std::string &name, const std::vector<int64_t> &dims, graphStatus (*infer_func)(Operator &)) {
+  auto op_desc = std::make_shared<OpDesc>(name, "CacheTest");
+  (void)op_desc->AddInputDesc("x", GeTensorDesc(GeShape(dims), FORMAT_ND, DT_FLOAT));
+  (void)op_desc->AddOutputDesc("y", GeTensorDesc(GeShape(), FORMAT_ND, DT_FLOAT));
+  (void)AttrUtils::SetListStr(op_desc, "_datadump_original_op_names", {name});
+  op_desc->AddInferFunc(infer_func);
+  return op_desc;
+}
+
+graphStatus CallInferFunc(const OpDescPtr &op_desc) {
+  auto op = OpDescUtils::CreateOperatorFromOpDesc(op_desc);
+  auto ret = op_desc->CallInferFunc(op);
+  op.BreakConnect();
+  return ret;
+}
+}  // namespace
+
+class UtestInferShapeCache : public testing::Test {
+ protected:
+  void SetUp() {
+    infer_count = 0;
+    InferShapeCache::Instance().Enable(InferShapeCacheOptions());
+  }
+
+  void TearDown() {
+    InferShapeCache::Instance().Disable();
+  }
+};
+
+TEST_F(UtestInferShapeCache, HitOnIdenticalOps) {
+  auto op1 = CreateOpDesc("op1", {4, 8}, InferDoubleDim0);
+  auto op2 = CreateOpDesc("op2", {4, 8}, InferDoubleDim0);
+  auto op3 = CreateOpDesc("op3", {5, 8}, InferDoubleDim0);
+  auto op4 = CreateOpDesc("op4", {4, 8}, InferDoubleDim0);
+  (void)AttrUtils::SetInt(op4, "factor", 3);
+  for (const auto &op_desc : {op1, op2, op3, op4}) {
+    EXPECT_EQ(CallInferFunc(op_desc), GRAPH_SUCCESS);
+  }
+  EXPECT_EQ(infer_count, 3);
+  EXPECT_EQ(op2->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({8, 8}));
+  EXPECT_EQ(op3->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({10, 8}));
+  EXPECT_EQ(op4->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({12, 8}));
+
+  auto statistics = InferShapeCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.hit_num, 1U);
+  EXPECT_EQ(statistics.miss_num, 3U);
+  EXPECT_DOUBLE_EQ(InferShapeCache::Instance().GetHitRate(), 0.25);
+
+  InferShapeCache::Instance().Disable();
+  EXPECT_EQ(CallInferFunc(CreateOpDesc("op5", {4, 8}, InferDoubleDim0)), GRAPH_SUCCESS);
+  EXPECT_EQ(infer_count, 4);
+}
+
+TEST_F(UtestInferShapeCache, SkipWhenInferFuncReadsMoreThanOpDesc) {
+  EXPECT_EQ(CallInferFunc(CreateOpDesc("op1", {4, 8}, InferWithContext)), GRAPH_SUCCESS);
+  EXPECT_EQ(CallInferFunc(CreateOpDesc("op2", {4, 8}, InferWithContext)), GRAPH_SUCCESS);
+  EXPECT_EQ(CallInferFunc(CreateOpDesc("op3", {4, 8}, InferAndSetAttr)), GRAPH_SUCCESS);
+  auto op4 = CreateOpDesc("op4", {4, 8}, InferAndSetAttr);
+  EXPECT_EQ(CallInferFunc(op4), GRAPH_SUCCESS);
+  EXPECT_EQ(infer_count, 4);
+  EXPECT_TRUE(op4->HasAttr("inferred"));
+
+  auto statistics = InferShapeCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.hit_num, 0U);
+  EXPECT_EQ(statistics.skip_num, 4U);
+}
+}  // namespace ge
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "graph/model.h"
+#include "graph/model_serialize.h"
+#include "graph/detail/model_serialize_imp.h"
+#include "proto/ge_ir.pb.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+namespace {
+ComputeGraphPtr BuildChainGraph(const std::string &name, int node_num) {
+  auto builder = ut::GraphBuilder(name);
+  auto prev = builder.AddNode(name + "_data", "Data", 0, 1);
+  for (int i = 0; i < node_num; ++i) {
+    auto node = builder.AddNode(name + "_relu_" + std::to_string(i), "Relu", 1, 1);
+    (void)AttrUtils::SetInt(node->GetOpDesc(), "index", i);
+    builder.AddDataEdge(prev, 0, node, 0);
+    if (i % 7 == 0) {
+      builder.AddControlEdge(prev, node);
+    }
+    prev = node;
+  }
+  auto output = builder.AddNode(name + "_netoutput", "NetOutput", 1, 0);
+  builder.AddDataEdge(prev, 0, output, 0);
+  return builder.GetGraph();
+}
+
+// Map fields are written in hash order by default, so compare the deterministic form
+std::string ToDeterministicString(const google::protobuf::Message &msg) {
+  std::string str;
+  {
+    google::protobuf::io::StringOutputStream stream(&str);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.SetSerializationDeterministic(true);
+    (void)msg.SerializeToCodedStream(&coded_stream);
+  }
+  return str;
+}
+
+std::string SerializeGraphDef(const ComputeGraphPtr &graph, uint32_t parallel_num) {
+  proto::GraphDef graph_def;
+  ModelSerializeImp imp;
+  imp.SetParallelNum(parallel_num);
+  EXPECT_TRUE(imp.SerializeGraph(graph, &graph_def));
+  return ToDeterministicString(graph_def);
+}
+}  // namespace
+
+class UtestModelSerialize : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestModelSerialize, SerializeGraphParallel_SameAsSerial) {
+  auto graph = BuildChainGraph("root", 1000);
+  auto serial_str = SerializeGraphDef(graph, 0U);
+  EXPECT_FALSE(serial_str.empty());
+  EXPECT_EQ(serial_str, SerializeGraphDef(graph, 4U));
+
+  ModelSerialize serialize;
+  auto buffer = serialize.SerializeGraph(graph, 4U);
+  auto restored_graph = serialize.UnserializeGraph(buffer.GetData(), buffer.GetSize());
+  ASSERT_NE(restored_graph, nullptr);
+  EXPECT_EQ(restored_graph->GetDirectNodesSize(), graph->GetDirectNodesSize());
+}
+
+TEST_F(UtestModelSerialize, SerializeModelParallel_WithSubgraphSameAsSerial) {
+  auto root_graph = BuildChainGraph("root", 600);
+  auto subgraph = BuildChainGraph("sub", 300);
+  auto parent_node = root_graph->FindNode("root_relu_10");
+  ASSERT_NE(parent_node, nullptr);
+  parent_node->GetOpDesc()->AddSubgraphName("sub");
+  parent_node->GetOpDesc()->SetSubgraphInstanceName(0, "sub");
+  subgraph->SetParentNode(parent_node);
+  subgraph->SetParentGraph(root_graph);
+  ASSERT_EQ(root_graph->AddSubgraph("sub", subgraph), GRAPH_SUCCESS);
+
+  Model model("model", "custom");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(root_graph));
+  proto::ModelDef serial_def;
+  ModelSerializeImp serial_imp;
+  ASSERT_TRUE(serial_imp.SerializeModel(model, &serial_def));
+  proto::ModelDef parallel_def;
+  ModelSerializeImp parallel_imp;
+  parallel_imp.SetParallelNum(3U);
+  ASSERT_TRUE(parallel_imp.SerializeModel(model, &parallel_def));
+  ASSERT_EQ(parallel_def.graph_size(), 2);
+  EXPECT_EQ(ToDeterministicString(serial_def), ToDeterministicString(parallel_def));
+
+  ModelSerialize serialize;
+  auto buffer = serialize.SerializeModel(model, false, 3U);
+  Model restored;
+  ASSERT_TRUE(serialize.UnserializeModel(buffer.GetData(), buffer.GetSize(), restored));
+  auto restored_graph = GraphUtils::GetComputeGraph(restored.GetGraph());
+  ASSERT_NE(restored_graph, nullptr);
+  EXPECT_EQ(restored_graph->GetDirectNodesSize(), root_graph->GetDirectNodesSize());
+  EXPECT_EQ(restored_graph->GetAllSubgraphs().size(), 1U);
+}
+
+TEST_F(UtestModelSerialize, SerializeGraphParallel_SmallGraphOnCallingThread) {
+  auto graph = BuildChainGraph("small", 8);
+  EXPECT_EQ(SerializeGraphDef(graph, 0U), SerializeGraphDef(graph, 8U));
+}
+}  // namespace ge
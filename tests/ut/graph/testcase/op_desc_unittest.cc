@@ -20,7 +20,10 @@
 #define protected public
 #define private public
 #include "graph/op_desc.h"
+#include "graph/op_desc_impl.h"
 #include "graph/ge_tensor.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/utils/op_desc_utils.h"
 #undef private
 #undef protected
 
@@ -43,4 +46,46 @@ TEST_F(UtestOpDesc, TestCommonVerifyOnDummyShape) {
 
   EXPECT_EQ(GRAPH_SUCCESS, op_desc->CommonVerify());
 }
+
+TEST_F(UtestOpDesc, OpFuncTable_SharedByOpType) {
+  const std::string op_type = "UtestFuncTableOp";
+  int infer_num = 0;
+  EXPECT_EQ(OperatorFactoryImpl::RegisterInferShapeFunc(op_type, [&infer_num](Operator &op) {
+    ++infer_num;
+    return GRAPH_SUCCESS;
+  }), GRAPH_SUCCESS);
+  auto op_desc1 = std::make_shared<OpDesc>("op1", op_type);
+  auto op_desc2 = std::make_shared<OpDesc>("op2", op_type);
+  EXPECT_EQ(op_desc1->InferShapeAndType(), GRAPH_SUCCESS);
+  EXPECT_EQ(op_desc2->InferShapeAndType(), GRAPH_SUCCESS);
+  EXPECT_EQ(infer_num, 2);
+  const auto func_table = op_desc1->impl_->GetOpFuncTable();
+  ASSERT_NE(func_table, nullptr);
+  EXPECT_EQ(op_desc2->impl_->GetOpFuncTable(), func_table);
+  // the function stays on the shared table instead of being copied to each op desc
+  EXPECT_EQ(op_desc1->impl_->infer_func_, nullptr);
+  EXPECT_NE(op_desc1->GetInferFunc(), nullptr);
+
+  // a registration after the table is built is still seen
+  EXPECT_EQ(op_desc1->GetVerifyFunc(), nullptr);
+  EXPECT_EQ(OperatorFactoryImpl::RegisterVerifyFunc(op_type, [](Operator &op) { return GRAPH_PARAM_INVALID; }),
+            GRAPH_SUCCESS);
+  EXPECT_EQ(op_desc1->OpVerify(), GRAPH_PARAM_INVALID);
+
+  op_desc2->SetType("UtestFuncTableOtherOp");
+  EXPECT_NE(op_desc2->impl_->GetOpFuncTable(), func_table);
+  EXPECT_EQ(op_desc2->GetInferFunc(), nullptr);
+}
+
+TEST_F(UtestOpDesc, TilingFuncInfo_KeptByCopyDroppedBySetType) {
+  auto op_desc = std::make_shared<OpDesc>("op", "UtestTilingOp");
+  EXPECT_EQ(op_desc->GetTilingFuncInfo(), nullptr);
+  const auto tiling_func_info = std::make_shared<int>(1);
+  op_desc->SetTilingFuncInfo(tiling_func_info);
+  EXPECT_EQ(op_desc->GetTilingFuncInfo(), tiling_func_info);
+  OpDesc op_desc_copy(*op_desc);
+  EXPECT_EQ(op_desc_copy.GetTilingFuncInfo(), tiling_func_info);
+  op_desc->SetType("UtestTilingOtherOp");
+  EXPECT_EQ(op_desc->GetTilingFuncInfo(), nullptr);
+}
 }
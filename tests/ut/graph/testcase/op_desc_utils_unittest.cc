@@ -21,6 +21,7 @@
 #define private public
 
 #include "graph/utils/op_desc_utils.h"
+#include "graph/inference_context.h"
 #include "graph_builder_utils.h"
 
 #undef private
@@ -79,4 +80,32 @@ TEST_F(UtestOpDescUtils, SetWeight) {
   auto in_nodes1 = addn_node->GetInAllNodes();
   EXPECT_EQ(in_nodes1.size(), 3);
 }
+
+TEST_F(UtestOpDescUtils, GetOperatorViewFromNode_ReusedPerNode) {
+  ut::GraphBuilder builder = ut::GraphBuilder("graph");
+  auto data = builder.AddNode("Data", "Data", 1, 1);
+  auto relu = builder.AddNode("relu", "Relu", 1, 1);
+  builder.AddDataEdge(data, 0, relu, 0);
+  auto graph = builder.GetGraph();
+
+  Operator op = OpDescUtils::GetOperatorViewFromNode(relu);
+  EXPECT_EQ(op.GetNode(), relu);
+  EXPECT_EQ(OpDescUtils::GetOpDescFromOperator(op), relu->GetOpDesc());
+  op.SetInferenceContext(std::shared_ptr<InferenceContext>(InferenceContext::Create()));
+  auto impl = op.GetOperatorImplPtr();
+
+  Operator op_again = OpDescUtils::GetOperatorViewFromNode(relu);
+  EXPECT_EQ(op_again.GetOperatorImplPtr(), impl);
+  EXPECT_EQ(op_again.GetInferenceContext(), nullptr);
+  EXPECT_NE(OpDescUtils::GetOperatorViewFromNode(data).GetOperatorImplPtr(), impl);
+
+  // the view does not keep the node alive
+  std::weak_ptr<Node> weak_relu = relu;
+  graph = nullptr;
+  builder = ut::GraphBuilder("other");
+  data = nullptr;
+  relu = nullptr;
+  EXPECT_TRUE(weak_relu.expired());
+  EXPECT_EQ(op.GetNode(), nullptr);
+}
 }
@@ -22,6 +22,9 @@
 #include "graph/compute_graph.h"
 #include "graph/shape_refiner.h"
 #include "graph/operator_factory_impl.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/op_desc_utils.h"
 #include "graph/utils/tensor_utils.h"
 
 namespace ge {
@@ -68,6 +71,49 @@ static NodePtr CreateNode(const ComputeGraphPtr &graph, const string &name, cons
   return graph->AddNode(op_desc);
 }
 
+// Every output is the first input with one more element in dim 0, the marks received are counted in an attr
+static graphStatus InferByFirstInput(Operator &op) {
+  auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+  GeShape shape({8, 16});
+  if (op_desc->GetInputsSize() > 0U) {
+    shape = op_desc->GetInputDesc(0).GetShape();
+    for (size_t i = 1U; i < op_desc->GetInputsSize(); ++i) {
+      shape.SetDim(0U, shape.GetDim(0U) + op_desc->GetInputDesc(i).GetShape().GetDim(0U));
+    }
+    shape.SetDim(0U, shape.GetDim(0U) + 1);
+  } else {
+    op.GetInferenceContext()->SetMarks({op_desc->GetName()});
+  }
+  for (size_t i = 0U; i < op_desc->GetOutputsSize(); ++i) {
+    op_desc->MutableOutputDesc(i)->SetShape(shape);
+  }
+  (void)AttrUtils::SetInt(op_desc, "received_mark_num",
+                          static_cast<int64_t>(op.GetInferenceContext()->GetMarks().size()));
+  return GRAPH_SUCCESS;
+}
+
+///  data -> relu_0_0 -> relu_0_1 ... relu_0_3 -+
+///       -> relu_1_0 -> ...                     +-> concat
+///       ...
+static ComputeGraphPtr BuildWideGraph(const std::string &name, int branch_num, int depth) {
+  const auto graph = std::make_shared<ComputeGraph>(name);
+  auto data = CreateNode(graph, "data", "Data", 0, 1);
+  auto concat = CreateNode(graph, "concat", "ConcatV2", branch_num, 1);
+  for (int i = 0; i < branch_num; ++i) {
+    auto prev = data;
+    for (int j = 0; j < depth; ++j) {
+      auto relu = CreateNode(graph, "relu_" + std::to_string(i) + "_" + std::to_string(j), "Relu", 1, 1);
+      (void)GraphUtils::AddEdge(prev->GetOutDataAnchor(0), relu->GetInDataAnchor(0));
+      prev = relu;
+    }
+    (void)GraphUtils::AddEdge(prev->GetOutDataAnchor(0), concat->GetInDataAnchor(i));
+  }
+  for (const auto &node : graph->GetDirectNode()) {
+    node->GetOpDesc()->AddInferFunc(InferByFirstInput);
+  }
+  return graph;
+}
+
 TEST_F(UtestShapeRefiner, infer_shape_and_type_for_running) {
   const auto graph = std::make_shared<ComputeGraph>("test_infer_shape");
   auto enter1 = CreateNode(graph, "enter", "Enter", 1, 1);
@@ -82,4 +128,123 @@ TEST_F(UtestShapeRefiner, infer_shape_and_type_for_running) {
   EXPECT_EQ(ShapeRefiner::InferShapeAndTypeForRunning(merge1, true), GRAPH_SUCCESS);
   OperatorFactoryImpl::operator_infershape_funcs_ = infershape_funcs_back;
 }
-} // namespace ge
+
+TEST_F(UtestShapeRefiner, infer_shape_and_type_parallel_same_as_serial) {
+  auto serial_graph = BuildWideGraph("serial", 100, 4);
+  auto parallel_graph = BuildWideGraph("parallel", 100, 4);
+  ShapeRefiner::ClearContextMap();
+  EXPECT_EQ(ShapeRefiner::InferShapeAndTypeParallel(serial_graph, 1U), GRAPH_SUCCESS);
+  ShapeRefiner::ClearContextMap();
+  EXPECT_EQ(ShapeRefiner::InferShapeAndTypeParallel(parallel_graph, 4U), GRAPH_SUCCESS);
+  ShapeRefiner::ClearContextMap();
+
+  for (const auto &serial_node : serial_graph->GetDirectNode()) {
+    auto parallel_node = parallel_graph->FindNode(serial_node->GetName());
+    ASSERT_NE(parallel_node, nullptr);
+    EXPECT_EQ(serial_node->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(),
+              parallel_node->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims());
+    int64_t serial_mark_num = -1;
+    int64_t parallel_mark_num = -1;
+    EXPECT_TRUE(AttrUtils::GetInt(serial_node->GetOpDesc(), "received_mark_num", serial_mark_num));
+    EXPECT_TRUE(AttrUtils::GetInt(parallel_node->GetOpDesc(), "received_mark_num", parallel_mark_num));
+    EXPECT_EQ(serial_mark_num, parallel_mark_num);
+  }
+  auto concat = parallel_graph->FindNode("concat");
+  ASSERT_NE(concat, nullptr);
+  EXPECT_EQ(concat->GetOpDesc()->GetOutputDesc(0).GetShape().GetDim(0), 100 * 12 + 1);
+  // the mark of data is passed along the relu chains only as far as the first relu
+  int64_t mark_num = 0;
+  auto relu = parallel_graph->FindNode("relu_0_0");
+  ASSERT_NE(relu, nullptr);
+  EXPECT_TRUE(AttrUtils::GetInt(relu->GetOpDesc(), "received_mark_num", mark_num));
+  EXPECT_EQ(mark_num, 1);
+}
+
+TEST_F(UtestShapeRefiner, infer_shape_and_type_parallel_report_failed_node) {
+  auto graph = BuildWideGraph("failed", 100, 3);
+  auto relu = graph->FindNode("relu_50_1");
+  ASSERT_NE(relu, nullptr);
+  relu->GetOpDesc()->AddInferFunc([](Operator &op) { return GRAPH_FAILED; });
+  EXPECT_EQ(ShapeRefiner::InferShapeAndTypeParallel(graph, 4U), GRAPH_FAILED);
+  ShapeRefiner::ClearContextMap();
+  // nodes after the failed level are not inferred
+  auto concat = graph->FindNode("concat");
+  ASSERT_NE(concat, nullptr);
+  EXPECT_FALSE(concat->GetOpDesc()->HasAttr("received_mark_num"));
+}
+
+TEST_F(UtestShapeRefiner, re_infer_shape_and_type_only_affected_cone) {
+  auto graph = BuildWideGraph("incremental", 10, 3);
+  EXPECT_EQ(ShapeRefiner::InferShapeAndTypeParallel(graph, 1U), GRAPH_SUCCESS);
+  ShapeRefiner::ClearContextMap();
+  auto concat = graph->FindNode("concat");
+  ASSERT_NE(concat, nullptr);
+  EXPECT_EQ(concat->GetOpDesc()->GetOutputDesc(0).GetShape().GetDim(0), 10 * 11 + 1);
+
+  // nothing changed below relu_3_0, only the node itself is inferred again
+  auto relu = graph->FindNode("relu_3_0");
+  ASSERT_NE(relu, nullptr);
+  size_t infer_num = 0U;
+  EXPECT_EQ(ShapeRefiner::ReInferShapeAndType({relu}, infer_num), GRAPH_SUCCESS);
+  EXPECT_EQ(infer_num, 1U);
+
+  // a new input shape of relu_3_0 flows through its chain into concat, other branches are untouched
+  relu->GetOpDesc()->MutableInputDesc(0)->SetShape(GeShape({20, 16}));
+  relu->GetOpDesc()->AddInferFunc([](Operator &op) {
+    auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+    op_desc->MutableOutputDesc(0)->SetShape(GeShape({20, 16}));
+    return GRAPH_SUCCESS;
+  });
+  EXPECT_EQ(ShapeRefiner::ReInferShapeAndType({relu}, infer_num), GRAPH_SUCCESS);
+  ShapeRefiner::ClearContextMap();
+  EXPECT_EQ(infer_num, 4U);
+  EXPECT_EQ(graph->FindNode("relu_3_2")->GetOpDesc()->GetOutputDesc(0).GetShape().GetDim(0), 22);
+  EXPECT_EQ(concat->GetOpDesc()->GetInputDesc(3).GetShape().GetDim(0), 22);
+  EXPECT_EQ(concat->GetOpDesc()->GetOutputDesc(0).GetShape().GetDim(0), 9 * 11 + 22 + 1);
+}
+
+TEST_F(UtestShapeRefiner, runtime_infer_plan_same_as_infer_for_running) {
+  const auto graph = std::make_shared<ComputeGraph>("test_runtime_infer_plan");
+  auto data = CreateNode(graph, "data", "Data", 0, 1);
+  auto shape = CreateNode(graph, "shape", "Const", 0, 1);
+  auto reshape = CreateNode(graph, "reshape", "Reshape", 2, 1);
+  (void)GraphUtils::AddEdge(data->GetOutDataAnchor(0), reshape->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(shape->GetOutDataAnchor(0), reshape->GetInDataAnchor(1));
+  reshape->GetOpDesc()->UpdateInputName({{"x", 0}, {"shape", 1}});
+  reshape->GetOpDesc()->SetOpInferDepends({"shape"});
+  int64_t dim = 2;
+  reshape->GetOpDesc()->AddInferFunc([&dim](Operator &op) {
+    auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+    op_desc->MutableOutputDesc(0)->SetShape(GeShape({dim, 16}));
+    // the dtype must not be changed when running
+    op_desc->MutableOutputDesc(0)->SetDataType(DT_INT8);
+    return GRAPH_SUCCESS;
+  });
+
+  auto plan = RuntimeInferPlan::Build(reshape, true);
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->GetDependInputIndexes(), std::vector<uint32_t>({1U}));
+  for (dim = 2; dim < 5; ++dim) {
+    EXPECT_EQ(plan->Run(), GRAPH_SUCCESS);
+    EXPECT_EQ(reshape->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), std::vector<int64_t>({dim, 16}));
+    EXPECT_EQ(reshape->GetOpDesc()->GetOutputDesc(0).GetDataType(), DT_FLOAT);
+  }
+
+  // infer func of ge local op is resolved from the factory at build time
+  auto infershape_funcs_back = OperatorFactoryImpl::operator_infershape_funcs_;
+  OperatorFactoryImpl::operator_infershape_funcs_.reset(new (std::nothrow) std::map<string, InferShapeFunc>());
+  auto merge = CreateNode(graph, "merge", "StreamMerge", 2, 2);
+  merge->GetOpDesc()->AddInferFunc(nullptr);
+  EXPECT_EQ(RuntimeInferPlan::Build(merge, true), nullptr);
+  OperatorFactoryImpl::operator_infershape_funcs_->emplace("Merge", [](Operator &op) { return GRAPH_SUCCESS; });
+  plan = RuntimeInferPlan::Build(merge, true);
+  OperatorFactoryImpl::operator_infershape_funcs_ = infershape_funcs_back;
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->Run(), GRAPH_SUCCESS);
+
+  reshape->GetOpDesc()->AddInferFunc([](Operator &op) { return GRAPH_FAILED; });
+  plan = RuntimeInferPlan::Build(reshape, true);
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->Run(), GRAPH_FAILED);
+}
+}  // namespace ge
@@ -0,0 +1,202 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/shape_refiner.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/symbolic_shape_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+namespace {
+// stands for the infer func of the op, which only knows the numeric output shape
+void SetNumericInferFunc(const NodePtr &node, const std::vector<int64_t> &dims) {
+  OpDesc *op_desc = node->GetOpDesc().get();
+  op_desc->AddInferFunc([op_desc, dims](Operator &op) {
+    op_desc->MutableOutputDesc(0U)->SetShape(GeShape(dims));
+    return GRAPH_SUCCESS;
+  });
+}
+
+std::string GetSymbolicShapeStr(const NodePtr &node) {
+  SymbolicShape shape;
+  if (!SymbolicShapeUtils::GetSymbolicShape(*node->GetOpDesc()->MutableOutputDesc(0U), shape)) {
+    return "";
+  }
+  std::string str;
+  for (const auto &dim : shape) {
+    str += (str.empty() ? "" : ",") + dim.ToString();
+  }
+  return str;
+}
+}  // namespace
+
+class UtestSymbolicShapeUtils : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestSymbolicShapeUtils, SymbolicDim_ParseAndCompute) {
+  SymbolicDim dim;
+  ASSERT_TRUE(SymbolicDim::Parse("2*s0+s1-3", dim));
+  EXPECT_EQ(dim.ToString(), "2*s0+s1-3");
+  EXPECT_EQ((dim + (SymbolicDim::Symbol("s1") * -1)).ToString(), "2*s0-3");
+  EXPECT_EQ((dim * 2).ToString(), "4*s0+2*s1-6");
+
+  int64_t value = 0;
+  EXPECT_TRUE(dim.Evaluate({{"s0", 4}, {"s1", 1}}, value));
+  EXPECT_EQ(value, 6);
+  EXPECT_FALSE(dim.Evaluate({{"s0", 4}}, value));
+
+  SymbolicDim quotient;
+  ASSERT_TRUE((dim * 2).DivExactly(2, quotient));
+  EXPECT_EQ(quotient, dim);
+  EXPECT_FALSE(dim.DivExactly(2, quotient));
+  EXPECT_FALSE(SymbolicDim::Parse("2*", dim));
+  EXPECT_FALSE(SymbolicDim::Parse("", dim));
+}
+
+TEST_F(UtestSymbolicShapeUtils, InferShapeAndType_PropagateSymbols) {
+  auto builder = ut::GraphBuilder("graph");
+  auto data = builder.AddNode("data", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  auto bias = builder.AddNode("bias", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {1, 16});
+  auto relu = builder.AddNode("relu", "Relu", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  auto add = builder.AddNode("add", "Add", 2, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  auto shape = builder.AddNode("shape", "Const", 0, 1, FORMAT_ND, DT_INT32, {2});
+  auto reshape = builder.AddNode("reshape", "Reshape", 2, 1, FORMAT_ND, DT_FLOAT, {-1, 4});
+  auto concat = builder.AddNode("concat", "ConcatD", 2, 1, FORMAT_ND, DT_FLOAT, {-1, 4});
+  auto unknown = builder.AddNode("unknown", "UnknownOp", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 4});
+  builder.AddDataEdge(data, 0, relu, 0);
+  builder.AddDataEdge(relu, 0, add, 0);
+  builder.AddDataEdge(bias, 0, add, 1);
+  builder.AddDataEdge(add, 0, reshape, 0);
+  builder.AddDataEdge(shape, 0, reshape, 1);
+  builder.AddDataEdge(reshape, 0, concat, 0);
+  builder.AddDataEdge(reshape, 0, concat, 1);
+  builder.AddDataEdge(concat, 0, unknown, 0);
+  auto graph = builder.GetGraph();
+
+  int32_t shape_value[2] = {-1, 4};
+  GeTensorDesc shape_desc(GeShape({2}), FORMAT_ND, DT_INT32);
+  auto shape_tensor = std::make_shared<GeTensor>(shape_desc, reinterpret_cast<uint8_t *>(shape_value),
+                                                 sizeof(shape_value));
+  ASSERT_TRUE(AttrUtils::SetTensor(shape->GetOpDesc(), ATTR_NAME_WEIGHTS, shape_tensor));
+  (void)AttrUtils::SetInt(concat->GetOpDesc(), "concat_dim", 0);
+  for (const auto &node : graph->GetDirectNode()) {
+    SetNumericInferFunc(node, node->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims());
+  }
+
+  SymbolTable table;
+  ASSERT_EQ(SymbolicShapeUtils::AssignInputSymbols(graph, table), GRAPH_SUCCESS);
+  ASSERT_EQ(table.GetSymbols().size(), 1U);
+  EXPECT_EQ(table.GetSymbols()[0].node_name, "data");
+  for (const auto &node : graph->GetDirectNode()) {
+    ASSERT_EQ(ShapeRefiner::InferShapeAndType(node), GRAPH_SUCCESS);
+  }
+  EXPECT_EQ(GetSymbolicShapeStr(data), "s0,16");
+  EXPECT_EQ(GetSymbolicShapeStr(bias), "");
+  EXPECT_EQ(GetSymbolicShapeStr(relu), "s0,16");
+  EXPECT_EQ(GetSymbolicShapeStr(add), "s0,16");
+  EXPECT_EQ(GetSymbolicShapeStr(reshape), "4*s0,4");
+  EXPECT_EQ(GetSymbolicShapeStr(concat), "8*s0,4");
+  // no rule for the op, the numeric shape is all that is left
+  EXPECT_EQ(GetSymbolicShapeStr(unknown), "");
+  EXPECT_EQ(unknown->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({-1, 4}));
+
+  // a dim the infer func knows wins over the derived one
+  SetNumericInferFunc(relu, {8, 16});
+  ASSERT_EQ(ShapeRefiner::InferShapeAndType(relu), GRAPH_SUCCESS);
+  EXPECT_EQ(GetSymbolicShapeStr(relu), "");
+}
+
+TEST_F(UtestSymbolicShapeUtils, InferShapeAndType_SkipGraphWithoutSymbols) {
+  auto builder = ut::GraphBuilder("graph");
+  auto data = builder.AddNode("data", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  auto relu = builder.AddNode("relu", "Relu", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  builder.AddDataEdge(data, 0, relu, 0);
+  auto graph = builder.GetGraph();
+  SetNumericInferFunc(relu, {-1, 16});
+  // a symbolic shape set by hand, the graph was not given symbols
+  ASSERT_TRUE(SymbolicShapeUtils::SetSymbolicShape(*data->GetOpDesc()->MutableOutputDesc(0U),
+                                                   {SymbolicDim::Symbol("s0"), SymbolicDim(16)}));
+  ASSERT_EQ(ShapeRefiner::InferShapeAndType(relu), GRAPH_SUCCESS);
+  EXPECT_EQ(GetSymbolicShapeStr(relu), "");
+}
+
+TEST_F(UtestSymbolicShapeUtils, InstantiateShapes_MultiBatchWithoutInference) {
+  auto builder = ut::GraphBuilder("graph");
+  auto data1 = builder.AddNode("data1", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 16});
+  auto data2 = builder.AddNode("data2", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 8});
+  auto concat = builder.AddNode("concat", "ConcatD", 2, 1, FORMAT_ND, DT_FLOAT, {-1, 24});
+  auto reshape = builder.AddNode("reshape", "Reshape", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 4});
+  auto output = builder.AddNode("output", "NetOutput", 1, 0, FORMAT_ND, DT_FLOAT, {-1, 4});
+  builder.AddDataEdge(data1, 0, concat, 0);
+  builder.AddDataEdge(data2, 0, concat, 1);
+  builder.AddDataEdge(concat, 0, reshape, 0);
+  builder.AddDataEdge(reshape, 0, output, 0);
+  auto graph = builder.GetGraph();
+  (void)AttrUtils::SetInt(concat->GetOpDesc(), "concat_dim", 1);
+  (void)AttrUtils::SetListInt(reshape->GetOpDesc(), "shape", std::vector<int64_t>({-1, 4}));
+  int infer_num = 0;
+  for (const auto &node : graph->GetDirectNode()) {
+    if (node->GetOpDesc()->GetOutputsSize() == 0U) {
+      node->GetOpDesc()->AddInferFunc([&infer_num](Operator &op) { ++infer_num; return GRAPH_SUCCESS; });
+      continue;
+    }
+    SetNumericInferFunc(node, node->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims());
+  }
+
+  SymbolTable table;
+  std::string batch;
+  ASSERT_EQ(SymbolicShapeUtils::AssignBatchSymbol(graph, table, batch), GRAPH_SUCCESS);
+  EXPECT_EQ(table.GetSymbols().size(), 1U);
+  for (const auto &node : graph->GetDirectNode()) {
+    ASSERT_EQ(ShapeRefiner::InferShapeAndType(node), GRAPH_SUCCESS);
+  }
+  EXPECT_EQ(GetSymbolicShapeStr(reshape), "6*" + batch + ",4");
+  infer_num = 0;
+  // an origin shape of another format is left as it is
+  const auto concat_output = concat->GetOpDesc()->MutableOutputDesc(0U);
+  concat_output->SetOriginFormat(FORMAT_NHWC);
+  concat_output->SetOriginShape(GeShape({24, -1}));
+
+  ASSERT_EQ(SymbolicShapeUtils::InstantiateShapes(graph, {{batch, 2}}), GRAPH_SUCCESS);
+  EXPECT_EQ(infer_num, 0);
+  EXPECT_EQ(data2->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({2, 8}));
+  EXPECT_EQ(data2->GetOpDesc()->GetOutputDesc(0U).GetOriginShape().GetDims(), std::vector<int64_t>({2, 8}));
+  EXPECT_EQ(concat_output->GetOriginShape().GetDims(), std::vector<int64_t>({24, -1}));
+  EXPECT_EQ(concat->GetOpDesc()->GetInputDesc(1U).GetShape().GetDims(), std::vector<int64_t>({2, 8}));
+  EXPECT_EQ(concat->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({2, 24}));
+  EXPECT_EQ(output->GetOpDesc()->GetInputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({12, 4}));
+  // a gear can be stamped again from the same symbolic shapes
+  ASSERT_EQ(SymbolicShapeUtils::InstantiateShapes(graph, {{batch, 8}}), GRAPH_SUCCESS);
+  EXPECT_EQ(output->GetOpDesc()->GetInputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({48, 4}));
+  EXPECT_EQ(SymbolicShapeUtils::InstantiateShapes(graph, {}), GRAPH_PARAM_INVALID);
+
+  // an unknown dim without a symbol needs the full inference
+  SymbolicShapeUtils::ClearSymbolicShape(*reshape->GetOpDesc()->MutableOutputDesc(0U));
+  reshape->GetOpDesc()->MutableOutputDesc(0U)->SetShape(GeShape({-1, 4}));
+  EXPECT_EQ(SymbolicShapeUtils::InstantiateShapes(graph, {{batch, 2}}), GRAPH_PARAM_INVALID);
+  // nothing is written by a failed instantiation, the shapes of the former gear are kept
+  EXPECT_EQ(data2->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({8, 8}));
+  EXPECT_EQ(concat->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({8, 24}));
+}
+}  // namespace ge
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph/utils/value_range_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+namespace {
+// value range of the output is the range of every dim of the input shape
+graphStatus InferShapeValueRange(Operator &op) {
+  auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+  std::vector<std::pair<int64_t, int64_t>> shape_range;
+  (void)op_desc->GetInputDesc(0U).GetShapeRange(shape_range);
+  const auto dims = op_desc->GetInputDesc(0U).GetShape().GetDims();
+  ValueRange value_range;
+  for (size_t i = 0U; i < dims.size(); ++i) {
+    value_range.emplace_back((dims[i] >= 0) ? std::make_pair(dims[i], dims[i]) : shape_range.at(i));
+  }
+  return op_desc->MutableOutputDesc(0U)->SetValueRange(value_range);
+}
+
+graphStatus InferAddValueRange(Operator &op) {
+  auto op_desc = OpDescUtils::GetOpDescFromOperator(op);
+  ValueRange x_range;
+  ValueRange y_range;
+  (void)op_desc->GetInputDesc(0U).GetValueRange(x_range);
+  (void)op_desc->GetInputDesc(1U).GetValueRange(y_range);
+  if (x_range.size() != y_range.size()) {
+    return GRAPH_FAILED;
+  }
+  ValueRange value_range;
+  for (size_t i = 0U; i < x_range.size(); ++i) {
+    value_range.emplace_back(x_range[i].first + y_range[i].first, x_range[i].second + y_range[i].second);
+  }
+  return op_desc->MutableOutputDesc(0U)->SetValueRange(value_range);
+}
+
+void SetConstValue(const NodePtr &node, const std::vector<int64_t> &values) {
+  GeTensorDesc desc(GeShape({static_cast<int64_t>(values.size())}), FORMAT_ND, DT_INT64);
+  auto tensor = std::make_shared<GeTensor>(desc, reinterpret_cast<const uint8_t *>(values.data()),
+                                           values.size() * sizeof(int64_t));
+  (void)AttrUtils::SetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, tensor);
+}
+}  // namespace
+
+class UtestValueRangeUtils : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    (void)OperatorFactoryImpl::RegisterInferValueRangeFunc("UtShapeOfValueRange", INPUT_IS_DYNAMIC, false,
+                                                           InferShapeValueRange);
+    (void)OperatorFactoryImpl::RegisterInferValueRangeFunc("UtAddOfValueRange", INPUT_HAS_VALUE_RANGE, false,
+                                                           InferAddValueRange);
+  }
+
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+///  data -> shape -> add1 -> output
+///          const1 -+
+///  const2 -> add2 -> add3 -> output
+///  const3 -+ const3 -+
+TEST_F(UtestValueRangeUtils, InferValueRange_PropagateAndFold) {
+  auto builder = ut::GraphBuilder("graph");
+  auto data = builder.AddNode("data", "Data", 1, 1, FORMAT_ND, DT_FLOAT, {-1, 4});
+  auto shape = builder.AddNode("shape", "UtShapeOfValueRange", 1, 1, FORMAT_ND, DT_INT64, {2});
+  auto const1 = builder.AddNode("const1", "Const", 0, 1, FORMAT_ND, DT_INT64, {2});
+  auto add1 = builder.AddNode("add1", "UtAddOfValueRange", 2, 1, FORMAT_ND, DT_INT64, {2});
+  auto const2 = builder.AddNode("const2", "Const", 0, 1, FORMAT_ND, DT_INT64, {2});
+  auto const3 = builder.AddNode("const3", "Const", 0, 1, FORMAT_ND, DT_INT64, {2});
+  // add3 comes before its producer add2 in the node list, the graph is sorted before the propagation
+  auto add3 = builder.AddNode("add3", "UtAddOfValueRange", 2, 1, FORMAT_ND, DT_INT64, {2});
+  auto add2 = builder.AddNode("add2", "UtAddOfValueRange", 2, 1, FORMAT_ND, DT_INT64, {2});
+  auto output = builder.AddNode("output", "NetOutput", 2, 0, FORMAT_ND, DT_INT64, {2});
+  builder.AddDataEdge(data, 0, shape, 0);
+  builder.AddDataEdge(shape, 0, add1, 0);
+  builder.AddDataEdge(const1, 0, add1, 1);
+  builder.AddDataEdge(add1, 0, output, 0);
+  builder.AddDataEdge(const2, 0, add2, 0);
+  builder.AddDataEdge(const3, 0, add2, 1);
+  builder.AddDataEdge(add2, 0, add3, 0);
+  builder.AddDataEdge(const3, 0, add3, 1);
+  builder.AddDataEdge(add3, 0, output, 1);
+  builder.AddControlEdge(data, add3);
+  auto graph = builder.GetGraph();
+  shape->GetOpDesc()->MutableInputDesc(0U)->SetShape(GeShape({-1, 4}));
+  (void)shape->GetOpDesc()->MutableInputDesc(0U)->SetShapeRange({{1, 16}, {4, 4}});
+  SetConstValue(const1, {1, 2});
+  SetConstValue(const2, {2, 3});
+  SetConstValue(const3, {4, 4});
+
+  size_t folded_num = 0U;
+  ASSERT_EQ(ValueRangeUtils::InferValueRange(graph, true, folded_num), GRAPH_SUCCESS);
+  EXPECT_EQ(folded_num, 2U);
+  ValueRange value_range;
+  ASSERT_TRUE(ValueRangeUtils::GetOutputValueRange(add1, 0U, value_range));
+  EXPECT_EQ(value_range, ValueRange({{2, 17}, {6, 6}}));
+  EXPECT_EQ(graph->FindNode("add2"), nullptr);
+  EXPECT_EQ(graph->FindNode("add3"), nullptr);
+
+  // add3 is replaced by a Const which takes over its consumers and control edges
+  auto folded = output->GetInDataNodes().at(1);
+  EXPECT_EQ(folded->GetType(), "Const");
+  ASSERT_TRUE(ValueRangeUtils::GetOutputValueRange(folded, 0U, value_range));
+  EXPECT_EQ(value_range, ValueRange({{10, 10}, {11, 11}}));
+  EXPECT_EQ(folded->GetInControlNodes().size(), 1U);
+  EXPECT_EQ(folded->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({2}));
+
+  // nothing left to fold, the value ranges are the same
+  ASSERT_EQ(ValueRangeUtils::InferValueRange(graph, true, folded_num), GRAPH_SUCCESS);
+  EXPECT_EQ(folded_num, 0U);
+  ASSERT_TRUE(ValueRangeUtils::GetOutputValueRange(add1, 0U, value_range));
+  EXPECT_EQ(value_range, ValueRange({{2, 17}, {6, 6}}));
+}
+
+TEST_F(UtestValueRangeUtils, InferValueRange_SkipLargeConst) {
+  auto builder = ut::GraphBuilder("graph");
+  auto const1 = builder.AddNode("const1", "Const", 0, 1, FORMAT_ND, DT_INT64, {65});
+  auto const2 = builder.AddNode("const2", "Const", 0, 1, FORMAT_ND, DT_INT64, {64});
+  auto add = builder.AddNode("add", "UtAddOfValueRange", 2, 1, FORMAT_ND, DT_INT64, {65});
+  builder.AddDataEdge(const1, 0, add, 0);
+  builder.AddDataEdge(const2, 0, add, 1);
+  auto graph = builder.GetGraph();
+  SetConstValue(const1, std::vector<int64_t>(65U, 1));
+  SetConstValue(const2, std::vector<int64_t>(64U, 2));
+
+  ValueRange value_range;
+  EXPECT_FALSE(ValueRangeUtils::GetOutputValueRange(const1, 0U, value_range));
+  ASSERT_TRUE(ValueRangeUtils::GetOutputValueRange(const2, 0U, value_range));
+  EXPECT_EQ(value_range.size(), 64U);
+  size_t folded_num = 0U;
+  ASSERT_EQ(ValueRangeUtils::InferValueRange(graph, true, folded_num), GRAPH_SUCCESS);
+  EXPECT_EQ(folded_num, 0U);
+  // no input desc keeps the values of a large weight
+  value_range.clear();
+  (void)add->GetOpDesc()->GetInputDesc(0U).GetValueRange(value_range);
+  EXPECT_TRUE(value_range.empty());
+  EXPECT_FALSE(ValueRangeUtils::GetOutputValueRange(add, 0U, value_range));
+}
+}  // namespace ge
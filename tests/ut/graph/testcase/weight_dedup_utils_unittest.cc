@@ -0,0 +1,112 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/model.h"
+#include "graph/model_serialize.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/weight_dedup_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+namespace {
+GeTensorPtr CreateWeight(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0U; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(seed + i);
+  }
+  GeTensorDesc desc(GeShape({static_cast<int64_t>(size)}), FORMAT_ND, DT_UINT8);
+  return std::make_shared<GeTensor>(desc, data);
+}
+
+///   const1 const2 const3
+///       \    |    /
+///         concat
+ComputeGraphPtr BuildConstGraph() {
+  auto builder = ut::GraphBuilder("g1");
+  auto const1 = builder.AddNode("const1", "Const", 0, 1);
+  auto const2 = builder.AddNode("const2", "Const", 0, 1);
+  auto const3 = builder.AddNode("const3", "Const", 0, 1);
+  auto concat = builder.AddNode("concat", "ConcatV2", 3, 1);
+  builder.AddDataEdge(const1, 0, concat, 0);
+  builder.AddDataEdge(const2, 0, concat, 1);
+  builder.AddDataEdge(const3, 0, concat, 2);
+  (void)AttrUtils::SetTensor(const1->GetOpDesc(), ATTR_NAME_WEIGHTS, CreateWeight(1024U, 1U));
+  (void)AttrUtils::SetTensor(const2->GetOpDesc(), ATTR_NAME_WEIGHTS, CreateWeight(1024U, 1U));
+  (void)AttrUtils::SetTensor(const3->GetOpDesc(), ATTR_NAME_WEIGHTS, CreateWeight(1024U, 2U));
+  return builder.GetGraph();
+}
+}  // namespace
+
+class UtestWeightDedupUtils : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestWeightDedupUtils, HashData_DependsOnContent) {
+  auto weight1 = CreateWeight(1000U, 1U);
+  auto weight2 = CreateWeight(1000U, 1U);
+  auto weight3 = CreateWeight(1000U, 1U);
+  weight3->MutableData().data()[999U] ^= 1U;
+  const auto hash1 = WeightDedupUtils::HashData(weight1->GetData().GetData(), weight1->GetData().GetSize());
+  EXPECT_EQ(hash1, WeightDedupUtils::HashData(weight2->GetData().GetData(), weight2->GetData().GetSize()));
+  EXPECT_NE(hash1, WeightDedupUtils::HashData(weight3->GetData().GetData(), weight3->GetData().GetSize()));
+  EXPECT_NE(hash1, WeightDedupUtils::HashData(weight1->GetData().GetData(), 999U));
+}
+
+TEST_F(UtestWeightDedupUtils, ShareIdenticalTensorData_Success) {
+  std::vector<GeTensorPtr> tensors = {CreateWeight(256U, 1U), CreateWeight(256U, 2U), CreateWeight(256U, 1U),
+                                      nullptr, CreateWeight(256U, 1U)};
+  EXPECT_EQ(WeightDedupUtils::ShareIdenticalTensorData(tensors), 512U);
+  EXPECT_EQ(tensors[0]->GetData().GetData(), tensors[2]->GetData().GetData());
+  EXPECT_EQ(tensors[0]->GetData().GetData(), tensors[4]->GetData().GetData());
+  EXPECT_NE(tensors[0]->GetData().GetData(), tensors[1]->GetData().GetData());
+  // already shared
+  EXPECT_EQ(WeightDedupUtils::ShareIdenticalTensorData(tensors), 0U);
+}
+
+TEST_F(UtestWeightDedupUtils, SerializeModel_DedupWeightsRoundTrip) {
+  Model model("model", "custom");
+  model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(BuildConstGraph()));
+  ModelSerialize serialize;
+  auto plain_buffer = serialize.SerializeModel(model, false, 1U);
+  auto dedup_buffer = serialize.SerializeModel(model, false, 1U, true);
+  ASSERT_NE(dedup_buffer.GetSize(), 0U);
+  // const1 and const2 share one blob, the references cost a few bytes only
+  EXPECT_LT(dedup_buffer.GetSize() + 1024U, plain_buffer.GetSize() + 128U);
+
+  Model restored;
+  ASSERT_TRUE(serialize.UnserializeModel(dedup_buffer.GetData(), dedup_buffer.GetSize(), restored));
+  EXPECT_FALSE(restored.HasAttr("_shared_weight_pool"));
+  auto graph = GraphUtils::GetComputeGraph(restored.GetGraph());
+  ASSERT_NE(graph, nullptr);
+  for (const auto &name : {"const1", "const2", "const3"}) {
+    auto node = graph->FindNode(name);
+    ASSERT_NE(node, nullptr);
+    ConstGeTensorPtr weight;
+    ASSERT_TRUE(AttrUtils::GetTensor(node->GetOpDesc(), ATTR_NAME_WEIGHTS, weight));
+    ASSERT_EQ(weight->GetData().GetSize(), 1024U);
+    EXPECT_EQ(weight->GetData().GetData()[0], (std::string(name) == "const3") ? 2U : 1U);
+    EXPECT_FALSE(AttrUtils::HasAttr(weight->GetTensorDesc(), "_shared_weight_index"));
+  }
+}
+}  // namespace ge
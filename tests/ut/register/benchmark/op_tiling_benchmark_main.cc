@@ -0,0 +1,170 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro benchmarks of the op tiling hot paths, kept out of the unit suite:
+//   op_tiling_benchmark [loop_num]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_registry.h"
+#include "register/op_tiling_registry_impl.h"
+
+namespace optiling {
+namespace {
+bool TrivialTilingV1(const TeOpParas &op_paras, const OpCompileInfo &compile_info, OpRunInfo &run_info) {
+  run_info.block_dim = 1U;
+  return true;
+}
+
+bool TrivialTilingV2(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  run_info.SetBlockDim(1U);
+  return true;
+}
+
+REGISTER_OP_TILING(BenchmarkTilingV1Op, TrivialTilingV1);
+REGISTER_OP_TILING_V2(BenchmarkTilingV2Op, TrivialTilingV2);
+}  // namespace
+}  // namespace optiling
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double NsPer(const Clock::time_point &begin, const Clock::time_point &end, double num) {
+  return std::chrono::duration<double, std::nano>(end - begin).count() / num;
+}
+
+// a put-heavy tiling func writes every value of its tiling data one by one
+void BenchmarkTilingDataPut(uint32_t loop_num) {
+  const size_t put_num = 4096U;
+  size_t check_size = 0U;
+  const auto begin_stream = Clock::now();
+  for (uint32_t i = 0U; i < loop_num; ++i) {
+    optiling::ByteBuffer stream;
+    for (size_t j = 0U; j < put_num; ++j) {
+      optiling::ByteBufferPut(stream, static_cast<int32_t>(j));
+    }
+    check_size += stream.str().size();
+  }
+  const auto begin_buffer = Clock::now();
+  for (uint32_t i = 0U; i < loop_num; ++i) {
+    optiling::utils::OpRunInfo run_info;
+    run_info.ReserveTilingData(put_num * sizeof(int32_t));
+    auto &buffer = run_info.GetTilingData();
+    for (size_t j = 0U; j < put_num; ++j) {
+      (void)buffer.Append(static_cast<int32_t>(j));
+    }
+    check_size += buffer.GetSize();
+  }
+  const auto end = Clock::now();
+  const auto total_puts = static_cast<double>(put_num * loop_num);
+  (void)printf("tiling data put, %zu int32 per tiling: stream put %.2f ns/put, buffer append %.2f ns/put (%zu B)\n",
+               put_num, NsPer(begin_stream, begin_buffer, total_puts), NsPer(begin_buffer, end, total_puts),
+               check_size);
+}
+
+// the lookup of the tiling func of a node: by op type through the registries or the frozen table, by a string
+// keyed ext attr, and by the pointer PrepareOpTilingFunc keeps on the op desc
+void BenchmarkFuncLookup(uint32_t loop_num) {
+  const uint32_t lookup_num = loop_num * 1000U;
+  const std::string op_type = "BenchmarkTilingV1Op";
+  auto &interf_2 = optiling::utils::OpTilingRegistryInterf_V2::RegisteredOpInterf();
+  auto &interf_1 = optiling::OpTilingRegistryInterf::RegisteredOpInterf();
+  size_t found_num = 0U;
+  const auto begin_registry = Clock::now();
+  for (uint32_t i = 0U; i < lookup_num; ++i) {
+    found_num += (interf_2.find(op_type) == interf_2.end()) ? interf_1.count(op_type) : 1U;
+  }
+  optiling::FreezeOpTilingRegistry();
+  auto &table = optiling::utils::OpTilingFuncTable::Instance();
+  const auto begin_table = Clock::now();
+  for (uint32_t i = 0U; i < lookup_num; ++i) {
+    optiling::utils::OpTilingFuncEntry entry;
+    found_num += table.Find(op_type, entry) ? 1U : 0U;
+  }
+  const auto op_desc = std::make_shared<ge::OpDesc>("op", op_type);
+  optiling::utils::OpTilingFuncEntry kept_entry;
+  (void)table.Find(op_type, kept_entry);
+  (void)op_desc->SetExtAttr("_op_tiling_func", kept_entry);
+  const auto begin_ext_attr = Clock::now();
+  for (uint32_t i = 0U; i < lookup_num; ++i) {
+    const auto entry = op_desc->TryGetExtAttr("_op_tiling_func", optiling::utils::OpTilingFuncEntry());
+    found_num += (entry.found && (entry.generation == table.GetGeneration())) ? 1U : 0U;
+  }
+  op_desc->SetTilingFuncInfo(std::make_shared<optiling::utils::OpTilingFuncEntry>(kept_entry));
+  const auto begin_pointer = Clock::now();
+  for (uint32_t i = 0U; i < lookup_num; ++i) {
+    const auto entry = static_cast<const optiling::utils::OpTilingFuncEntry *>(op_desc->GetTilingFuncInfo().get());
+    found_num += (entry->found && (entry->generation == table.GetGeneration())) ? 1U : 0U;
+  }
+  const auto end = Clock::now();
+  optiling::utils::OpTilingFuncTable::Instance().Invalidate();
+  (void)printf("tiling func lookup: registry finds %.2f ns, frozen table %.2f ns, ext attr %.2f ns, "
+               "op desc pointer %.2f ns (%zu found)\n",
+               NsPer(begin_registry, begin_table, lookup_num), NsPer(begin_table, begin_ext_attr, lookup_num),
+               NsPer(begin_ext_attr, begin_pointer, lookup_num), NsPer(begin_pointer, end, lookup_num), found_num);
+}
+
+double TimeOpParaCalculateV2(const ge::Node &node, uint32_t call_num, size_t &fail_num) {
+  const auto begin = Clock::now();
+  for (uint32_t i = 0U; i < call_num; ++i) {
+    optiling::utils::OpRunInfo run_info;
+    fail_num += (optiling::OpParaCalculateV2(node, run_info) == ge::GRAPH_SUCCESS) ? 0U : 1U;
+  }
+  return NsPer(begin, Clock::now(), call_num);
+}
+
+// a whole OpParaCalculateV2 of a V2 op with a trivial tiling func, unfrozen, then frozen without and with the node
+// prepared by turns
+void BenchmarkPreparedTiling(uint32_t loop_num) {
+  const uint32_t call_num = loop_num * 100U;
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto op_desc = std::make_shared<ge::OpDesc>("op", "BenchmarkTilingV2Op");
+  ge::GeTensorDesc tensor_desc(ge::GeShape({8, 16}), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  (void)op_desc->AddOutputDesc("y", tensor_desc);
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", "benchmark_key");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  const auto node = graph->AddNode(op_desc);
+  size_t fail_num = 0U;
+  const double unfrozen_ns = TimeOpParaCalculateV2(*node, call_num, fail_num);
+  optiling::FreezeOpTilingRegistry();
+  const uint32_t round_num = 3U;
+  double frozen_ns = 0.0;
+  double prepared_ns = 0.0;
+  for (uint32_t i = 0U; i < round_num; ++i) {
+    op_desc->SetTilingFuncInfo(nullptr);
+    frozen_ns += TimeOpParaCalculateV2(*node, call_num, fail_num) / round_num;
+    (void)optiling::PrepareOpTilingFunc(*node);
+    prepared_ns += TimeOpParaCalculateV2(*node, call_num, fail_num) / round_num;
+  }
+  optiling::utils::OpTilingFuncTable::Instance().Invalidate();
+  (void)printf("OpParaCalculateV2: registries %.1f ns/call, frozen table %.1f ns/call, prepared %.1f ns/call "
+               "(%zu failed)\n", unfrozen_ns, frozen_ns, prepared_ns, fail_num);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t loop_num = (argc > 1) ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000U;
+  BenchmarkTilingDataPut(loop_num);
+  BenchmarkFuncLookup(loop_num);
+  BenchmarkPreparedTiling(loop_num);
+  return 0;
+}
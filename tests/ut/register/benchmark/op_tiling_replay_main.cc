@@ -0,0 +1,79 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays a tiling corpus recorded with OP_TILING_RECORD_PATH through the tiling funcs of the given plugins:
+//   op_tiling_replay <corpus> [loop_num] [plugin.so ...]
+
+#include <dlfcn.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "register/op_tiling.h"
+#include "register/op_tiling_replay.h"
+
+namespace {
+std::atomic<uint64_t> g_alloc_num{0U};
+}  // namespace
+
+void *operator new(size_t size) {
+  ++g_alloc_num;
+  void *const ptr = std::malloc((size == 0U) ? 1U : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    (void)fprintf(stderr, "usage: %s <corpus> [loop_num] [plugin.so ...]\n", argv[0]);
+    return 1;
+  }
+  const uint32_t loop_num = (argc > 2) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 100U;
+  for (int i = 3; i < argc; ++i) {
+    if (dlopen(argv[i], RTLD_NOW | RTLD_GLOBAL) == nullptr) {
+      (void)fprintf(stderr, "failed to load %s: %s\n", argv[i], dlerror());
+      return 1;
+    }
+  }
+  optiling::FreezeOpTilingRegistry();
+
+  optiling::OpTilingReplayer replayer;
+  if (replayer.Load(argv[1]) != ge::GRAPH_SUCCESS) {
+    (void)fprintf(stderr, "failed to load corpus %s\n", argv[1]);
+    return 1;
+  }
+  std::vector<optiling::OpTilingReplayStat> stats;
+  (void)replayer.Replay(loop_num, []() { return g_alloc_num.load(); }, stats);
+
+  (void)printf("%zu records, %u loops\n", replayer.GetRecordNum(), loop_num);
+  (void)printf("%-32s %8s %8s %6s %10s %10s %10s %10s %10s %12s %10s\n", "op_type", "records", "calls", "fails",
+               "p50(us)", "p90(us)", "p99(us)", "max(us)", "allocs", "avg_data(B)", "max_data(B)");
+  for (const auto &stat : stats) {
+    (void)printf("%-32s %8zu %8zu %6zu %10.2f %10.2f %10.2f %10.2f %10.1f %12.1f %10zu\n", stat.op_type.c_str(),
+                 stat.record_num, stat.call_num, stat.fail_num, stat.p50_us, stat.p90_us, stat.p99_us, stat.max_us,
+                 stat.alloc_per_call, stat.avg_tiling_data_size, stat.max_tiling_data_size);
+  }
+  return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_registry_impl.h"
+
+namespace optiling {
+namespace {
+struct ParsedCompileInfo {
+  int64_t core_num = 0;
+};
+
+int parse_num = 0;
+int64_t tiling_core_num = 0;
+
+std::shared_ptr<void> ParseCoreNum(const ge::AscendString &compile_info_json) {
+  ++parse_num;
+  const std::string json = compile_info_json.GetString();
+  if (json.empty()) {
+    return nullptr;
+  }
+  auto parsed_info = std::make_shared<ParsedCompileInfo>();
+  parsed_info->core_num = std::stoll(json);
+  return parsed_info;
+}
+
+bool ParsedTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  const auto parsed_info = static_cast<const ParsedCompileInfo *>(compile_info.GetParsedInfo().get());
+  if (parsed_info == nullptr) {
+    return false;
+  }
+  tiling_core_num = parsed_info->core_num;
+  run_info.SetBlockDim(static_cast<uint32_t>(parsed_info->core_num));
+  return true;
+}
+
+REGISTER_OP_TILING_WITH_PARSE_V2(CompileInfoRegistryTestOp, ParsedTiling, ParseCoreNum);
+
+ge::NodePtr AddTilingNode(const ge::ComputeGraphPtr &graph, const std::string &name, const std::string &key,
+                          const std::string &json) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, "CompileInfoRegistryTestOp");
+  ge::GeTensorDesc tensor_desc(ge::GeShape({8, 16}), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  (void)op_desc->AddOutputDesc("y", tensor_desc);
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", key);
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", json);
+  return graph->AddNode(op_desc);
+}
+}  // namespace
+
+class UtestOpCompileInfoRegistry : public testing::Test {
+ protected:
+  void SetUp() {
+    parse_num = 0;
+    tiling_core_num = 0;
+    utils::OpCompileInfoRegistry::Instance().Clear();
+  }
+
+  void TearDown() {
+    utils::OpCompileInfoRegistry::Instance().Clear();
+  }
+};
+
+TEST_F(UtestOpCompileInfoRegistry, ParseOncePerKey) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node1 = AddTilingNode(graph, "node1", "key_0", "32");
+  auto node2 = AddTilingNode(graph, "node2", "key_0", "32");
+  auto node3 = AddTilingNode(graph, "node3", "key_1", "8");
+
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node1, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_core_num, 32);
+  ASSERT_EQ(OpParaCalculateV2(*node1, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*node2, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(parse_num, 1);
+  ASSERT_EQ(OpParaCalculateV2(*node3, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_core_num, 8);
+  EXPECT_EQ(parse_num, 2);
+  EXPECT_EQ(utils::OpCompileInfoRegistry::Instance().GetSize(), 2U);
+
+  // the stored json is handed out without reading the op again
+  utils::OpCompileInfo compile_info;
+  ASSERT_TRUE(utils::OpCompileInfoRegistry::Instance().Find("CompileInfoRegistryTestOp", "key_1", compile_info));
+  EXPECT_EQ(std::string(compile_info.GetValue().GetString()), "8");
+  EXPECT_NE(compile_info.GetParsedInfo(), nullptr);
+}
+
+TEST_F(UtestOpCompileInfoRegistry, PreparedNodeKeepsCompileInfo) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", "key_0", "16");
+  FreezeOpTilingRegistry();
+  ASSERT_EQ(PrepareOpTilingFunc(*node), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(parse_num, 1);
+  // unloading a model drops the registered compile infos, the prepared node still has its own
+  ClearOpTilingCompileInfos();
+  EXPECT_EQ(utils::OpCompileInfoRegistry::Instance().GetSize(), 0U);
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_core_num, 16);
+  EXPECT_EQ(parse_num, 1);
+  EXPECT_EQ(utils::OpCompileInfoRegistry::Instance().GetSize(), 0U);
+
+  // a node not prepared reads its compile info again
+  node->GetOpDesc()->SetTilingFuncInfo(nullptr);
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(parse_num, 2);
+  EXPECT_EQ(utils::OpCompileInfoRegistry::Instance().GetSize(), 1U);
+  utils::OpTilingFuncTable::Instance().Invalidate();
+}
+
+TEST_F(UtestOpCompileInfoRegistry, ParseFailedNotStored) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", "key_bad", "");
+  utils::OpRunInfo run_info;
+  EXPECT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_FAILED);
+  EXPECT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_FAILED);
+  EXPECT_EQ(parse_num, 2);
+  EXPECT_EQ(utils::OpCompileInfoRegistry::Instance().GetSize(), 0U);
+}
+}  // namespace optiling
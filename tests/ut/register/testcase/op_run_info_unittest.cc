@@ -0,0 +1,80 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include "register/op_tiling_registry.h"
+
+namespace optiling {
+namespace {
+std::string ToString(const utils::TilingDataBuffer &buffer) {
+  return std::string(reinterpret_cast<const char *>(buffer.GetData()), buffer.GetSize());
+}
+}  // namespace
+
+class UtestOpRunInfo : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestOpRunInfo, TilingDataBuffer_FixedCapacity) {
+  utils::TilingDataBuffer buffer(8U);
+  EXPECT_TRUE(buffer.Append(static_cast<int32_t>(1)));
+  const uint8_t *data = buffer.GetData();
+  EXPECT_TRUE(buffer.Append(static_cast<int32_t>(2)));
+  EXPECT_FALSE(buffer.Append(static_cast<int8_t>(3)));
+  // appending within the capacity never moves the data
+  EXPECT_EQ(buffer.GetData(), data);
+  ASSERT_EQ(buffer.GetSize(), 8U);
+  int32_t values[2] = {0, 0};
+  (void)memcpy(values, buffer.GetData(), sizeof(values));
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[1], 2);
+
+  buffer.Reserve(16U);
+  EXPECT_TRUE(buffer.Append(static_cast<int64_t>(3)));
+  EXPECT_EQ(buffer.GetSize(), 16U);
+  buffer.Clear();
+  EXPECT_EQ(buffer.GetSize(), 0U);
+  EXPECT_GE(buffer.GetCapacity(), 16U);
+}
+
+TEST_F(UtestOpRunInfo, TilingData_StreamCompatible) {
+  utils::OpRunInfo run_info;
+  const std::string large(1024U, 'a');
+  run_info.AddTilingData(large.data(), large.size());
+  run_info.AddTilingData(static_cast<int32_t>(7));
+  EXPECT_EQ(run_info.GetTilingData().GetSize(), large.size() + sizeof(int32_t));
+
+  // the stream sees the data added before and keeps the order of later adds
+  ByteBuffer &stream = run_info.GetAllTilingData();
+  EXPECT_EQ(stream.str().size(), large.size() + sizeof(int32_t));
+  run_info.AddTilingData("bc", 2U);
+  ByteBufferPut(stream, static_cast<int8_t>('d'));
+  utils::OpRunInfo copied = run_info;
+  EXPECT_EQ(ToString(run_info.GetTilingData()).substr(large.size() + sizeof(int32_t)), "bcd");
+  EXPECT_EQ(ToString(copied.GetTilingData()), ToString(run_info.GetTilingData()));
+
+  ByteBuffer other;
+  other << "xyz";
+  run_info.InternelSetTiling(other);
+  EXPECT_EQ(ToString(run_info.GetTilingData()), "xyz");
+}
+}  // namespace optiling
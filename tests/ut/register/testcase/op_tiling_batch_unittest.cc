@@ -0,0 +1,170 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "graph/utils/thread_pool.h"
+#include "register/op_tiling.h"
+
+namespace optiling {
+namespace {
+// block dim is the first dim of x, a first dim of 100 fails the tiling
+bool FirstDimTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  const auto first_dim = op.GetInputDesc(0U).GetShape().GetDim(0U);
+  if (first_dim == 100) {
+    return false;
+  }
+  run_info.SetBlockDim(static_cast<uint32_t>(first_dim));
+  return true;
+}
+
+// tiling data is the clean size
+bool CleanTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  std::vector<int32_t> workspaces;
+  if ((op.GetAttr(ATTR_NAME_ATOMIC_CLEAN_WORKSPACE, workspaces) != ge::GRAPH_SUCCESS) || workspaces.empty()) {
+    return false;
+  }
+  run_info.SetClearAtomic(true);
+  run_info.SetBlockDim(1U);
+  run_info.AddTilingData(workspaces[0U]);
+  return true;
+}
+
+REGISTER_OP_TILING_V2(TilingBatchTestOp, FirstDimTiling);
+REGISTER_OP_TILING_V2(DynamicAtomicAddrClean, CleanTiling);
+
+ge::NodePtr AddNode(const ge::ComputeGraphPtr &graph, const std::string &name, const std::string &type,
+                    int64_t first_dim) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, type);
+  ge::GeTensorDesc tensor_desc(ge::GeShape({first_dim, 16}), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  (void)op_desc->AddOutputDesc("y", tensor_desc);
+  if (type == "TilingBatchTestOp") {
+    (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", "key_0");
+    (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  }
+  return graph->AddNode(op_desc);
+}
+
+void SetAtomicClean(const ge::NodePtr &node, int64_t clean_size) {
+  (void)ge::AttrUtils::SetListInt(node->GetOpDesc(), ge::ATOMIC_ATTR_OUTPUT_INDEX, std::vector<int64_t>({0}));
+  (void)ge::AttrUtils::SetStr(node->GetOpDesc(), "_atomic_compile_info_key", "atomic_key");
+  (void)ge::AttrUtils::SetStr(node->GetOpDesc(), "_atomic_compile_info_json", "{}");
+  ge::TensorUtils::SetSize(*node->GetOpDesc()->MutableOutputDesc(0U), clean_size);
+}
+
+int32_t GetCleanSize(utils::OpRunInfo &run_info) {
+  const auto &tiling_data = run_info.GetTilingData();
+  return (tiling_data.GetSize() == sizeof(int32_t)) ? *reinterpret_cast<const int32_t *>(tiling_data.GetData()) : -1;
+}
+}  // namespace
+
+class UtestOpTilingBatch : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestOpTilingBatch, GraphTilingInParallel) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  (void)AddNode(graph, "data", "Data", 1);
+  // added against the order of the chain, the nodes are tiled in topological order
+  for (int64_t i = 32; i >= 1; --i) {
+    (void)AddNode(graph, "node" + std::to_string(i), "TilingBatchTestOp", i);
+  }
+  for (int64_t i = 1; i < 32; ++i) {
+    ASSERT_EQ(ge::GraphUtils::AddEdge(graph->FindNode("node" + std::to_string(i))->GetOutDataAnchor(0),
+                                      graph->FindNode("node" + std::to_string(i + 1))->GetInDataAnchor(0)),
+              ge::GRAPH_SUCCESS);
+  }
+  auto atomic_node = graph->FindNode("node5");
+  SetAtomicClean(atomic_node, 512);
+
+  ge::GraphThreadPool pool(3U);
+  std::vector<ge::NodePtr> nodes;
+  std::vector<OpTilingResult> results;
+  ASSERT_EQ(OpParaCalculateGraph(graph, &pool, nodes, results), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(nodes.size(), 32U);
+  ASSERT_EQ(results.size(), 32U);
+  for (size_t i = 0U; i < nodes.size(); ++i) {
+    EXPECT_EQ(nodes[i]->GetName(), "node" + std::to_string(i + 1U));
+    EXPECT_EQ(results[i].status, ge::GRAPH_SUCCESS);
+    EXPECT_EQ(results[i].run_info.GetBlockDim(), i + 1U);
+    EXPECT_EQ(results[i].has_atomic_clean, nodes[i] == atomic_node);
+  }
+  EXPECT_EQ(results[4U].atomic_status, ge::GRAPH_SUCCESS);
+  EXPECT_TRUE(results[4U].atomic_run_info.GetClearAtomic());
+  EXPECT_EQ(GetCleanSize(results[4U].atomic_run_info), 512);
+}
+
+TEST_F(UtestOpTilingBatch, TilingWithAtomicClean) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddNode(graph, "node", "TilingBatchTestOp", 6);
+  OpTilingResult result;
+  ASSERT_EQ(OpTilingCalculateV2(*node, result), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(result.run_info.GetBlockDim(), 6U);
+  EXPECT_FALSE(result.has_atomic_clean);
+
+  // the same run infos as the separate entries, the clean size of each call reaches the atomic clean tiling
+  for (const int64_t clean_size : {512, 1024}) {
+    SetAtomicClean(node, clean_size);
+    OpTilingResult fused_result;
+    ASSERT_EQ(OpTilingCalculateV2(*node, fused_result), ge::GRAPH_SUCCESS);
+    utils::OpRunInfo run_info;
+    utils::OpRunInfo atomic_run_info;
+    ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+    ASSERT_EQ(OpAtomicCalculateV2(*node, atomic_run_info), ge::GRAPH_SUCCESS);
+    EXPECT_TRUE(fused_result.has_atomic_clean);
+    EXPECT_EQ(fused_result.atomic_status, ge::GRAPH_SUCCESS);
+    EXPECT_EQ(fused_result.run_info.GetBlockDim(), run_info.GetBlockDim());
+    EXPECT_EQ(GetCleanSize(fused_result.atomic_run_info), clean_size);
+    EXPECT_EQ(GetCleanSize(atomic_run_info), clean_size);
+  }
+
+  // a failed tiling of the node does not hold the atomic clean back
+  auto failed_node = AddNode(graph, "failed_node", "TilingBatchTestOp", 100);
+  SetAtomicClean(failed_node, 256);
+  OpTilingResult failed_result;
+  EXPECT_EQ(OpTilingCalculateV2(*failed_node, failed_result), ge::GRAPH_FAILED);
+  EXPECT_EQ(failed_result.atomic_status, ge::GRAPH_SUCCESS);
+  EXPECT_EQ(GetCleanSize(failed_result.atomic_run_info), 256);
+}
+
+TEST_F(UtestOpTilingBatch, FirstFailureInNodeOrder) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  std::vector<ge::NodePtr> nodes;
+  for (int64_t i = 0; i < 16; ++i) {
+    nodes.emplace_back(AddNode(graph, "node" + std::to_string(i), "TilingBatchTestOp", (i % 5 == 3) ? 100 : 8));
+  }
+  // the same pool serves every batch
+  ge::GraphThreadPool pool(3U);
+  for (ge::GraphThreadPool *const batch_pool : {static_cast<ge::GraphThreadPool *>(nullptr), &pool, &pool}) {
+    std::vector<OpTilingResult> results;
+    EXPECT_EQ(OpParaCalculateBatch(nodes, batch_pool, results), ge::GRAPH_FAILED);
+    ASSERT_EQ(results.size(), nodes.size());
+    for (size_t i = 0U; i < nodes.size(); ++i) {
+      const bool failed = (i % 5U == 3U);
+      EXPECT_EQ(results[i].status, failed ? ge::GRAPH_FAILED : ge::GRAPH_SUCCESS);
+    }
+  }
+}
+}  // namespace optiling
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include "graph/tensor.h"
+#include "register/op_tiling_binary.h"
+#include "register/op_tiling_registry.h"
+
+extern "C" int TbeOpTilingPyInterfaceEx2(const char *optype, const char *compile_info, const char *inputs,
+                                         const char *outputs, char *run_info_json, size_t run_info_len,
+                                         const char *compile_info_hash, uint64_t *elapse);
+
+namespace optiling {
+namespace {
+// tiling data is the first dim of x followed by the const axes
+bool BinaryTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  ge::Tensor axes;
+  if (op.GetInputConstData("axes", axes) != ge::GRAPH_SUCCESS) {
+    return false;
+  }
+  run_info.SetBlockDim(static_cast<uint32_t>(op.GetInputDesc(0U).GetShape().GetDim(0U)));
+  run_info.SetTilingKey(3U);
+  run_info.AddWorkspace(1024);
+  run_info.AddTilingData(op.GetInputDesc(0U).GetShape().GetDim(0U));
+  run_info.AddTilingData(reinterpret_cast<const char *>(axes.GetData()), axes.GetSize());
+  return true;
+}
+
+REGISTER_OP_TILING_V2(BinaryTilingTestOp, BinaryTiling);
+
+const int64_t kXDims[] = {32, 16};
+const int64_t kAxesDims[] = {2};
+const int32_t kAxes[] = {0, 1};
+
+void MakeTensors(TbeOpTilingTensor (&inputs)[2], TbeOpTilingTensor &output) {
+  inputs[0] = {"x", ge::DT_FLOAT, ge::FORMAT_ND, ge::FORMAT_ND, 2U, kXDims, 2U, kXDims, nullptr, 0U};
+  inputs[1] = {"axes", ge::DT_INT32, ge::FORMAT_ND, ge::FORMAT_ND, 1U, kAxesDims, 1U, kAxesDims, kAxes, sizeof(kAxes)};
+  output = {"y", ge::DT_FLOAT, ge::FORMAT_ND, ge::FORMAT_ND, 2U, kXDims, 2U, kXDims, nullptr, 0U};
+}
+
+const char *const kInputsJson = R"([{"name": "x", "shape": [32, 16], "ori_shape": [32, 16], "format": "ND",
+    "ori_format": "ND", "dtype": "float32"}, {"name": "axes", "shape": [2], "ori_shape": [2], "format": "ND",
+    "ori_format": "ND", "dtype": "int32", "const_value": [0, 1]}])";
+const char *const kOutputsJson = R"([{"name": "y", "shape": [32, 16], "ori_shape": [32, 16], "format": "ND",
+    "ori_format": "ND", "dtype": "float32"}])";
+}  // namespace
+
+class UtestOpTilingBinary : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestOpTilingBinary, SameRunInfoAsJson) {
+  TbeOpTilingTensor inputs[2];
+  TbeOpTilingTensor output;
+  MakeTensors(inputs, output);
+  int64_t workspaces[4] = {0};
+  uint8_t tiling_data[64] = {0};
+  TbeOpTilingRunInfo run_info = {0U, 0U, 0, 4U, workspaces, sizeof(tiling_data), tiling_data};
+  ASSERT_EQ(TbeOpTilingBinaryInterface("BinaryTilingTestOp", "{}", "binary_key", inputs, 2U, &output, 1U, &run_info,
+                                       nullptr), 1);
+
+  char run_info_json[1024] = {0};
+  ASSERT_EQ(TbeOpTilingPyInterfaceEx2("BinaryTilingTestOp", "{}", kInputsJson, kOutputsJson, run_info_json,
+                                      sizeof(run_info_json), "binary_key", nullptr), 1);
+  const auto json_obj = nlohmann::json::parse(run_info_json);
+  EXPECT_EQ(run_info.block_dim, json_obj["block_dim"].get<uint32_t>());
+  EXPECT_EQ(run_info.tiling_key, json_obj["tiling_key"].get<uint32_t>());
+  ASSERT_EQ(run_info.workspace_num, 1U);
+  EXPECT_EQ(workspaces[0], json_obj["workspaces"][0].get<int64_t>());
+  ASSERT_EQ(run_info.tiling_data_size, sizeof(int64_t) + sizeof(kAxes));
+  std::string hex_data;
+  for (uint64_t i = 0U; i < run_info.tiling_data_size; ++i) {
+    char hex[3] = {0};
+    (void)snprintf(hex, sizeof(hex), "%02X", tiling_data[i]);
+    hex_data += hex;
+  }
+  EXPECT_EQ(hex_data, json_obj["tiling_data"].get<std::string>());
+}
+
+TEST_F(UtestOpTilingBinary, BufferTooSmall) {
+  TbeOpTilingTensor inputs[2];
+  TbeOpTilingTensor output;
+  MakeTensors(inputs, output);
+  int64_t workspaces[1] = {0};
+  uint8_t tiling_data[4] = {0};
+  TbeOpTilingRunInfo run_info = {0U, 0U, 0, 1U, workspaces, sizeof(tiling_data), tiling_data};
+  EXPECT_EQ(TbeOpTilingBinaryInterface("BinaryTilingTestOp", "{}", "binary_key", inputs, 2U, &output, 1U, &run_info,
+                                       nullptr), 0);
+  // the sizes needed are handed back for a retry
+  EXPECT_EQ(run_info.workspace_num, 1U);
+  EXPECT_EQ(run_info.tiling_data_size, sizeof(int64_t) + sizeof(kAxes));
+
+  // a const input must be named
+  inputs[1].name = nullptr;
+  run_info.tiling_data_size = 0U;
+  EXPECT_EQ(TbeOpTilingBinaryInterface("BinaryTilingTestOp", "{}", "binary_key", inputs, 2U, &output, 1U, &run_info,
+                                       nullptr), 0);
+  EXPECT_EQ(TbeOpTilingBinaryInterface("BinaryTilingTestMissingOp", "{}", "binary_key", inputs, 2U, &output, 1U,
+                                       &run_info, nullptr), 0);
+}
+}  // namespace optiling
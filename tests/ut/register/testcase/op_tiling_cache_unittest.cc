@@ -0,0 +1,149 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_cache.h"
+
+namespace optiling {
+namespace {
+int tiling_num = 0;
+
+bool CountingTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  ++tiling_num;
+  run_info.SetBlockDim(static_cast<uint32_t>(tiling_num));
+  run_info.SetTilingKey(7U);
+  return true;
+}
+
+REGISTER_OP_TILING_V2(TilingCacheTestOp, CountingTiling);
+
+ge::NodePtr AddTilingNode(const ge::ComputeGraphPtr &graph, const std::string &name,
+                          const std::vector<int64_t> &dims) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, "TilingCacheTestOp");
+  ge::GeTensorDesc tensor_desc(ge::GeShape(dims), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  (void)op_desc->AddOutputDesc("y", tensor_desc);
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", "key_0");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  return graph->AddNode(op_desc);
+}
+}  // namespace
+
+class UtestOpTilingCache : public testing::Test {
+ protected:
+  void SetUp() {
+    tiling_num = 0;
+  }
+
+  void TearDown() {
+    OpTilingCache::Instance().Disable();
+  }
+};
+
+TEST_F(UtestOpTilingCache, HitMissAndEvict) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node1 = AddTilingNode(graph, "node1", {8, 16});
+  auto node2 = AddTilingNode(graph, "node2", {8, 16});
+  auto node3 = AddTilingNode(graph, "node3", {4, 16});
+
+  OpTilingCacheOptions options;
+  options.capacity = 1U;
+  OpTilingCache::Instance().Enable(options);
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node1, run_info), ge::GRAPH_SUCCESS);
+  // same shapes and compile info on another node share the run info
+  utils::OpRunInfo hit_run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node2, hit_run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 1);
+  EXPECT_EQ(hit_run_info.GetBlockDim(), 1U);
+  EXPECT_EQ(hit_run_info.GetTilingKey(), 7U);
+
+  // another shape misses and evicts the former entry
+  ASSERT_EQ(OpParaCalculateV2(*node3, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 2);
+  ASSERT_EQ(OpParaCalculateV2(*node1, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 3);
+
+  const auto statistics = OpTilingCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.hit_num, 1U);
+  EXPECT_EQ(statistics.miss_num, 3U);
+  EXPECT_EQ(statistics.evict_num, 2U);
+  EXPECT_DOUBLE_EQ(OpTilingCache::Instance().GetHitRate(), 0.25);
+}
+
+TEST_F(UtestOpTilingCache, SkipUncacheableAndDisabled) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", {8, 16});
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 2);
+
+  OpTilingCacheOptions options;
+  options.uncacheable_op_types.insert("TilingCacheTestOp");
+  OpTilingCache::Instance().Enable(options);
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 4);
+  const auto statistics = OpTilingCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.skip_num, 2U);
+  EXPECT_EQ(statistics.hit_num + statistics.miss_num, 0U);
+}
+
+TEST_F(UtestOpTilingCache, KeyByCompileInfoJsonHash) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node1 = AddTilingNode(graph, "node1", {8, 16});
+  auto node2 = AddTilingNode(graph, "node2", {8, 16});
+  auto node3 = AddTilingNode(graph, "node3", {8, 16});
+  const std::string compile_info_json(4096U, 'a');
+  for (const auto &node : {node1, node2, node3}) {
+    (void)node->GetOpDesc()->DelAttr("compile_info_key");
+    (void)ge::AttrUtils::SetStr(node->GetOpDesc(), "compile_info_json", compile_info_json);
+  }
+  (void)ge::AttrUtils::SetStr(node3->GetOpDesc(), "compile_info_json", compile_info_json + "b");
+  OpTilingCache::Instance().Enable(OpTilingCacheOptions());
+  std::string key1;
+  std::string key2;
+  std::string key3;
+  ASSERT_TRUE(OpTilingCache::Instance().BuildKey(*node1, key1));
+  ASSERT_TRUE(OpTilingCache::Instance().BuildKey(*node2, key2));
+  ASSERT_TRUE(OpTilingCache::Instance().BuildKey(*node3, key3));
+  EXPECT_EQ(key1, key2);
+  EXPECT_NE(key1, key3);
+  // the json is not copied into the key
+  EXPECT_LT(key1.size(), compile_info_json.size());
+}
+
+TEST_F(UtestOpTilingCache, SkipDependOnRuntimeValue) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", {8, 16});
+  // x has no const data, its value is only known at runtime
+  node->GetOpDesc()->SetOpInferDepends({"x"});
+  OpTilingCache::Instance().Enable(OpTilingCacheOptions());
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(tiling_num, 2);
+  const auto statistics = OpTilingCache::Instance().GetStatistics();
+  EXPECT_EQ(statistics.skip_num, 2U);
+  EXPECT_EQ(statistics.hit_num + statistics.miss_num, 0U);
+}
+}  // namespace optiling
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+
+namespace optiling {
+namespace {
+std::atomic<int> bad_view_num{0};
+
+// checks the view presented to the tiling func, the empty shape of x must look like {1}
+bool ViewCheckingTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info,
+                        utils::OpRunInfo &run_info) {
+  const auto x_desc = op.GetInputDesc(0U);
+  const auto shape_desc = op.GetInputDesc(1U);
+  if ((x_desc.GetShape().GetDims() != std::vector<int64_t>({1})) ||
+      (op.GetOutputDesc(0U).GetShape().GetDims() != std::vector<int64_t>({8})) ||
+      (shape_desc.GetName() != "shape")) {
+    ++bad_view_num;
+  }
+  run_info.SetBlockDim(1U);
+  return true;
+}
+
+REGISTER_OP_TILING_V2(TilingContextTestOp, ViewCheckingTiling);
+
+ge::NodePtr AddTilingNode(const ge::ComputeGraphPtr &graph) {
+  auto op_desc = std::make_shared<ge::OpDesc>("node", "TilingContextTestOp");
+  (void)op_desc->AddInputDesc("x", ge::GeTensorDesc(ge::GeShape(), ge::FORMAT_ND, ge::DT_FLOAT));
+  (void)op_desc->AddInputDesc("shape", ge::GeTensorDesc(ge::GeShape({1}), ge::FORMAT_ND, ge::DT_INT32));
+  (void)op_desc->AddOutputDesc("y", ge::GeTensorDesc(ge::GeShape({8}), ge::FORMAT_ND, ge::DT_FLOAT));
+  op_desc->SetOpInferDepends({"shape"});
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", "key_0");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  return graph->AddNode(op_desc);
+}
+}  // namespace
+
+class UtestOpTilingContext : public testing::Test {
+ protected:
+  void SetUp() {
+    bad_view_num = 0;
+  }
+
+  void TearDown() {}
+};
+
+TEST_F(UtestOpTilingContext, PatchedViewWithoutTouchingGraph) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph);
+  const auto x_desc = node->GetOpDesc()->MutableInputDesc(0U);
+
+  std::atomic<int> failed_num{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&node, &failed_num]() {
+      for (int j = 0; j < 100; ++j) {
+        utils::OpRunInfo run_info;
+        if (OpParaCalculateV2(*node, run_info) != ge::GRAPH_SUCCESS) {
+          ++failed_num;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failed_num, 0);
+  EXPECT_EQ(bad_view_num, 0);
+  // the descs of the node are neither replaced nor changed
+  EXPECT_EQ(node->GetOpDesc()->MutableInputDesc(0U), x_desc);
+  EXPECT_EQ(x_desc->GetShape().GetDimNum(), 0U);
+  EXPECT_NE(node->GetOpDesc()->GetInputDesc(1U).GetName(), "shape");
+}
+}  // namespace optiling
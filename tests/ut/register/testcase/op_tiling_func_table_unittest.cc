@@ -0,0 +1,115 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_registry_impl.h"
+
+namespace optiling {
+namespace {
+bool V1Tiling(const TeOpParas &op_paras, const OpCompileInfo &compile_info, OpRunInfo &run_info) {
+  run_info.block_dim = 1U;
+  return true;
+}
+
+bool V2Tiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  run_info.SetBlockDim(2U);
+  return true;
+}
+
+REGISTER_OP_TILING(FuncTableTestV1Op, V1Tiling);
+REGISTER_OP_TILING_V2(FuncTableTestV2Op, V2Tiling);
+REGISTER_OP_TILING(FuncTableTestLateOp, V1Tiling);
+
+ge::NodePtr AddTilingNode(const ge::ComputeGraphPtr &graph, const std::string &name, const std::string &type) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, type);
+  ge::GeTensorDesc tensor_desc(ge::GeShape({8, 16}), ge::FORMAT_ND, ge::DT_FLOAT);
+  (void)op_desc->AddInputDesc("x", tensor_desc);
+  (void)op_desc->AddOutputDesc("y", tensor_desc);
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", "key_0");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  return graph->AddNode(op_desc);
+}
+}  // namespace
+
+class UtestOpTilingFuncTable : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {
+    utils::OpTilingFuncTable::Instance().Invalidate();
+  }
+};
+
+TEST_F(UtestOpTilingFuncTable, FrozenLookup) {
+  auto &table = utils::OpTilingFuncTable::Instance();
+  FreezeOpTilingRegistry();
+  ASSERT_TRUE(table.IsFrozen());
+
+  utils::OpTilingFuncEntry entry;
+  ASSERT_TRUE(table.Find("FuncTableTestV2Op", entry));
+  EXPECT_TRUE(entry.is_v2);
+  EXPECT_EQ(entry.v2_iter->first, "FuncTableTestV2Op");
+  EXPECT_EQ(entry.generation, table.GetGeneration());
+  ASSERT_TRUE(table.Find("FuncTableTestV1Op", entry));
+  EXPECT_FALSE(entry.is_v2);
+  EXPECT_EQ(entry.v1_iter->first, "FuncTableTestV1Op");
+
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto v1_node = AddTilingNode(graph, "v1_node", "FuncTableTestV1Op");
+  auto v2_node = AddTilingNode(graph, "v2_node", "FuncTableTestV2Op");
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*v1_node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(run_info.GetBlockDim(), 1U);
+  ASSERT_EQ(OpParaCalculateV2(*v2_node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(run_info.GetBlockDim(), 2U);
+}
+
+TEST_F(UtestOpTilingFuncTable, PreparedFuncDroppedByLateRegistration) {
+  auto &table = utils::OpTilingFuncTable::Instance();
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", "FuncTableTestLateOp");
+  // nothing is kept on the node before the registries are frozen
+  EXPECT_EQ(PrepareOpTilingFunc(*node), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(node->GetOpDesc()->GetTilingFuncInfo(), nullptr);
+
+  FreezeOpTilingRegistry();
+  ASSERT_EQ(PrepareOpTilingFunc(*node), ge::GRAPH_SUCCESS);
+  EXPECT_NE(node->GetOpDesc()->GetTilingFuncInfo(), nullptr);
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(run_info.GetBlockDim(), 1U);
+
+  // a V2 func registered later takes over the type, the entry kept on the node is stale
+  utils::OpTilingRegistryInterf_V2 late_registry("FuncTableTestLateOp", V2Tiling);
+  EXPECT_FALSE(table.IsFrozen());
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(run_info.GetBlockDim(), 2U);
+}
+
+TEST_F(UtestOpTilingFuncTable, FuncNotFound) {
+  FreezeOpTilingRegistry();
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddTilingNode(graph, "node", "FuncTableTestMissingOp");
+  EXPECT_EQ(PrepareOpTilingFunc(*node), ge::GRAPH_FAILED);
+  utils::OpRunInfo run_info;
+  EXPECT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_FAILED);
+}
+}  // namespace optiling
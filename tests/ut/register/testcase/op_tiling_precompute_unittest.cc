@@ -0,0 +1,160 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include "graph/compute_graph.h"
+#include "graph/utils/attr_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_precompute.h"
+
+namespace optiling {
+namespace {
+std::atomic<uint32_t> g_tiling_num{0U};
+
+// block dim is the first dim of x, tiling data the product of both dims, fails on a first dim of 2
+bool PrecomputeTiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  ++g_tiling_num;
+  const ge::Shape shape = op.GetInputDesc(0U).GetShape();
+  if (shape.GetDim(0U) == 2) {
+    return false;
+  }
+  run_info.SetBlockDim(static_cast<uint32_t>(shape.GetDim(0U)));
+  run_info.SetTilingKey(7U);
+  run_info.AddWorkspace(shape.GetDim(1U));
+  run_info.AddTilingData(shape.GetDim(0U) * shape.GetDim(1U));
+  return true;
+}
+
+REGISTER_OP_TILING_V2(PrecomputeTestOp, PrecomputeTiling);
+
+ge::NodePtr AddPrecomputeNode(const ge::ComputeGraphPtr &graph, const std::string &name,
+                              const std::vector<std::pair<int64_t, int64_t>> &shape_range, bool with_infer_func) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, "PrecomputeTestOp");
+  ge::GeTensorDesc x_desc(ge::GeShape({-1, -1}), ge::FORMAT_ND, ge::DT_FLOAT);
+  x_desc.SetOriginShape(ge::GeShape({-1, -1}));
+  (void)x_desc.SetShapeRange(shape_range);
+  (void)op_desc->AddInputDesc("x", x_desc);
+  (void)op_desc->AddOutputDesc("y", x_desc);
+  if (with_infer_func) {
+    op_desc->AddInferFunc([](ge::Operator &op) {
+      ge::TensorDesc y_desc = op.GetOutputDescByName("y");
+      y_desc.SetShape(op.GetInputDescByName("x").GetShape());
+      return op.UpdateOutputDesc("y", y_desc);
+    });
+  }
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", name + "_key");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{}");
+  return graph->AddNode(op_desc);
+}
+
+void SetInputShape(const ge::NodePtr &node, const std::vector<int64_t> &dims) {
+  ge::GeTensorDesc x_desc = node->GetOpDesc()->GetInputDesc(0U);
+  x_desc.SetShape(ge::GeShape(dims));
+  x_desc.SetOriginShape(ge::GeShape(dims));
+  (void)node->GetOpDesc()->UpdateInputDesc(0U, x_desc);
+}
+}  // namespace
+
+class UtestOpTilingPrecompute : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestOpTilingPrecompute, TilingFromPrecomputedTable) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto node = AddPrecomputeNode(graph, "node", {{1, 4}, {8, 9}}, true);
+  bool precomputed = false;
+  ASSERT_EQ(OpTilingPrecompute(node, OpTilingPrecomputeOptions(), precomputed), ge::GRAPH_SUCCESS);
+  ASSERT_TRUE(precomputed);
+  EXPECT_EQ(g_tiling_num.load(), 8U);
+  EXPECT_TRUE(node->GetOpDesc()->HasAttr(ATTR_NAME_OP_TILING_PRECOMPUTED));
+  // the node itself is left dynamic
+  EXPECT_EQ(node->GetOpDesc()->GetInputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({-1, -1}));
+  EXPECT_EQ(node->GetOpDesc()->GetOutputDesc(0U).GetShape().GetDims(), std::vector<int64_t>({-1, -1}));
+
+  // the table is not read before a prepare
+  g_tiling_num = 0U;
+  SetInputShape(node, {3, 9});
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(g_tiling_num.load(), 1U);
+  EXPECT_EQ(run_info.GetBlockDim(), 3U);
+
+  g_tiling_num = 0U;
+  ASSERT_EQ(PrepareOpTilingFunc(*node), ge::GRAPH_SUCCESS);
+  // the table is kept along with the tiling func even while the funcs are not frozen
+  EXPECT_NE(node->GetOpDesc()->GetTilingFuncInfo(), nullptr);
+  utils::OpRunInfo prepared_run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, prepared_run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(g_tiling_num.load(), 0U);
+  EXPECT_EQ(prepared_run_info.GetBlockDim(), 3U);
+  EXPECT_EQ(prepared_run_info.GetTilingKey(), 7U);
+  int64_t workspace = 0;
+  ASSERT_EQ(prepared_run_info.GetWorkspace(0U, workspace), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(workspace, 9);
+  ASSERT_EQ(prepared_run_info.GetTilingData().GetSize(), sizeof(int64_t));
+  EXPECT_EQ(*reinterpret_cast<const int64_t *>(prepared_run_info.GetTilingData().GetData()), 27);
+
+  // shapes out of the ranges and the ones failed at precompute are tiled by the tiling func
+  SetInputShape(node, {5, 9});
+  utils::OpRunInfo out_of_range_run_info;
+  ASSERT_EQ(OpParaCalculateV2(*node, out_of_range_run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(out_of_range_run_info.GetBlockDim(), 5U);
+  EXPECT_EQ(g_tiling_num.load(), 1U);
+  SetInputShape(node, {2, 8});
+  utils::OpRunInfo failed_run_info;
+  EXPECT_EQ(OpParaCalculateV2(*node, failed_run_info), ge::GRAPH_FAILED);
+  EXPECT_EQ(g_tiling_num.load(), 2U);
+
+  // a new precompute drops the table of the former prepare
+  SetInputShape(node, {-1, -1});
+  ASSERT_EQ(OpTilingPrecompute(node, OpTilingPrecomputeOptions(), precomputed), ge::GRAPH_SUCCESS);
+  ASSERT_TRUE(precomputed);
+  EXPECT_EQ(node->GetOpDesc()->GetTilingFuncInfo(), nullptr);
+}
+
+TEST_F(UtestOpTilingPrecompute, SkipOpsNotPrecomputable) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  (void)AddPrecomputeNode(graph, "unbounded", {{1, -1}, {8, 9}}, true);
+  (void)AddPrecomputeNode(graph, "too_many_shapes", {{1, 64}, {8, 9}}, true);
+  (void)AddPrecomputeNode(graph, "without_infer_func", {{1, 4}, {8, 9}}, false);
+  auto static_node = AddPrecomputeNode(graph, "static", {}, true);
+  SetInputShape(static_node, {4, 8});
+  auto node = AddPrecomputeNode(graph, "node", {{1, 2}, {8, 8}}, true);
+
+  OpTilingPrecomputeOptions options;
+  options.max_shape_num = 16U;
+  size_t precomputed_num = 0U;
+  ASSERT_EQ(OpTilingPrecomputeGraph(graph, options, precomputed_num), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(precomputed_num, 1U);
+  for (const auto &graph_node : graph->GetAllNodes()) {
+    EXPECT_EQ(graph_node->GetOpDesc()->HasAttr(ATTR_NAME_OP_TILING_PRECOMPUTED), graph_node == node);
+  }
+
+  // only the op types asked for are precomputed
+  options.op_types = {"OtherTestOp"};
+  bool precomputed = true;
+  auto other_node = AddPrecomputeNode(graph, "other", {{1, 2}, {8, 8}}, true);
+  ASSERT_EQ(OpTilingPrecompute(other_node, options, precomputed), ge::GRAPH_SUCCESS);
+  EXPECT_FALSE(precomputed);
+  EXPECT_NE(OpTilingPrecompute(nullptr, options, precomputed), ge::GRAPH_SUCCESS);
+}
+}  // namespace optiling
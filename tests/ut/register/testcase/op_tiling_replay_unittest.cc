@@ -0,0 +1,150 @@
+/**
+ * Copyright 2021, 2022 LuoJiaNET Research and Development Group, Wuhan University
+ * Copyright 2021, 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include "graph/compute_graph.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "register/op_tiling.h"
+#include "register/op_tiling_replay.h"
+
+namespace optiling {
+namespace {
+const char *const kCorpusPath = "op_tiling_replay_ut.corpus";
+
+// tiling data is the first dim of x followed by the const axes, fails without the axes
+bool ReplayV2Tiling(const ge::Operator &op, const utils::OpCompileInfo &compile_info, utils::OpRunInfo &run_info) {
+  ge::Tensor axes;
+  if ((op.GetInputConstData("axes", axes) != ge::GRAPH_SUCCESS) || (axes.GetSize() != 2U * sizeof(int32_t))) {
+    return false;
+  }
+  run_info.SetBlockDim(1U);
+  run_info.AddTilingData(op.GetInputDesc(0U).GetShape().GetDim(0U));
+  run_info.AddTilingData(reinterpret_cast<const char *>(axes.GetData()), axes.GetSize());
+  return true;
+}
+
+bool ReplayV1Tiling(const TeOpParas &op_paras, const OpCompileInfo &compile_info, OpRunInfo &run_info) {
+  if ((op_paras.inputs.size() != 1U) || (compile_info.str != "{\"core_num\": 8}")) {
+    return false;
+  }
+  ByteBufferPut(run_info.tiling_data, static_cast<int32_t>(op_paras.inputs[0U].tensor[0U].shape[0U]));
+  return true;
+}
+
+REGISTER_OP_TILING_V2(ReplayTestV2Op, ReplayV2Tiling);
+REGISTER_OP_TILING(ReplayTestV1Op, ReplayV1Tiling);
+
+ge::NodePtr AddTilingNode(const ge::ComputeGraphPtr &graph, const std::string &name, const std::string &type,
+                          const std::vector<std::string> &input_names) {
+  auto op_desc = std::make_shared<ge::OpDesc>(name, type);
+  for (const auto &input_name : input_names) {
+    (void)op_desc->AddInputDesc(input_name, ge::GeTensorDesc(ge::GeShape({16, 8}), ge::FORMAT_ND, ge::DT_FLOAT));
+  }
+  (void)op_desc->AddOutputDesc("y", ge::GeTensorDesc(ge::GeShape({16, 8}), ge::FORMAT_ND, ge::DT_FLOAT));
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_key", name + "_key");
+  (void)ge::AttrUtils::SetStr(op_desc, "compile_info_json", "{\"core_num\": 8}");
+  return graph->AddNode(op_desc);
+}
+
+ge::NodePtr AddV2Node(const ge::ComputeGraphPtr &graph) {
+  auto node = AddTilingNode(graph, "v2_node", "ReplayTestV2Op", {"x", "axes"});
+  auto axes_desc = node->GetOpDesc()->MutableInputDesc(1U);
+  axes_desc->SetShape(ge::GeShape({2}));
+  axes_desc->SetDataType(ge::DT_INT32);
+  const int32_t axes[] = {0, 1};
+  ge::GeTensor axes_tensor(*axes_desc, reinterpret_cast<const uint8_t *>(axes), sizeof(axes));
+  (void)ge::AttrUtils::SetTensor(axes_desc, ge::ATTR_NAME_VALUE, axes_tensor);
+
+  auto data_desc = std::make_shared<ge::OpDesc>("axes_data", "Data");
+  (void)data_desc->AddOutputDesc(*axes_desc);
+  auto data_node = graph->AddNode(data_desc);
+  (void)ge::GraphUtils::AddEdge(data_node->GetOutDataAnchor(0), node->GetInDataAnchor(1));
+  return node;
+}
+}  // namespace
+
+class UtestOpTilingReplay : public testing::Test {
+ protected:
+  void SetUp() {
+    (void)std::remove(kCorpusPath);
+  }
+
+  void TearDown() {
+    OpTilingRecorder::Instance().Stop();
+    (void)std::remove(kCorpusPath);
+  }
+};
+
+TEST_F(UtestOpTilingReplay, RecordAndReplay) {
+  auto graph = std::make_shared<ge::ComputeGraph>("graph");
+  auto v2_node = AddV2Node(graph);
+  auto v1_node = AddTilingNode(graph, "v1_node", "ReplayTestV1Op", {"x"});
+
+  auto &recorder = OpTilingRecorder::Instance();
+  ASSERT_EQ(recorder.Start(kCorpusPath), ge::GRAPH_SUCCESS);
+  utils::OpRunInfo run_info;
+  ASSERT_EQ(OpParaCalculateV2(*v2_node, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*v2_node, run_info), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(OpParaCalculateV2(*v1_node, run_info), ge::GRAPH_SUCCESS);
+  EXPECT_EQ(recorder.GetRecordNum(), 3U);
+  recorder.Stop();
+  ASSERT_EQ(OpParaCalculateV2(*v1_node, run_info), ge::GRAPH_SUCCESS);
+  {
+    // neither a truncated record nor an op without tiling func fails the load
+    std::ofstream corpus(kCorpusPath, std::ios::out | std::ios::app);
+    corpus << "{\"op_type\": \"ReplayTestMissingOp\", \"compile_info_key\": \"\", \"compile_info\": \"\", "
+              "\"inputs\": [], \"outputs\": []}\n";
+    corpus << "{\"op_type\": \"ReplayTestV1Op\", \"inpu\n";
+  }
+
+  OpTilingReplayer replayer;
+  ASSERT_EQ(replayer.Load(kCorpusPath), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(replayer.GetRecordNum(), 3U);
+  uint64_t alloc_num = 0U;
+  std::vector<OpTilingReplayStat> stats;
+  ASSERT_EQ(replayer.Replay(4U, [&alloc_num]() { return alloc_num++; }, stats), ge::GRAPH_SUCCESS);
+  ASSERT_EQ(stats.size(), 2U);
+
+  EXPECT_EQ(stats[0U].op_type, "ReplayTestV1Op");
+  EXPECT_EQ(stats[0U].record_num, 1U);
+  EXPECT_EQ(stats[0U].call_num, 4U);
+  EXPECT_EQ(stats[0U].fail_num, 0U);
+  EXPECT_EQ(stats[0U].max_tiling_data_size, sizeof(int32_t));
+
+  EXPECT_EQ(stats[1U].op_type, "ReplayTestV2Op");
+  EXPECT_EQ(stats[1U].record_num, 2U);
+  EXPECT_EQ(stats[1U].call_num, 8U);
+  EXPECT_EQ(stats[1U].fail_num, 0U);
+  EXPECT_EQ(stats[1U].avg_tiling_data_size, static_cast<double>(sizeof(int64_t) + 2U * sizeof(int32_t)));
+  EXPECT_EQ(stats[1U].alloc_per_call, 1.0);
+  EXPECT_LE(stats[1U].p50_us, stats[1U].p99_us);
+  EXPECT_LE(stats[1U].p99_us, stats[1U].max_us);
+}
+
+TEST_F(UtestOpTilingReplay, LoadMissingCorpus) {
+  OpTilingReplayer replayer;
+  EXPECT_EQ(replayer.Load(kCorpusPath), ge::GRAPH_FAILED);
+  std::vector<OpTilingReplayStat> stats;
+  EXPECT_EQ(replayer.Replay(1U, nullptr, stats), ge::GRAPH_SUCCESS);
+  EXPECT_TRUE(stats.empty());
+}
+}  // namespace optiling